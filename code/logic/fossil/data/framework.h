@@ -32,5 +32,6 @@
 #include "plot.h"
 #include "prob.h"
 #include "ml.h"
+#include "parallel.h"
 
 #endif /* FOSSIL_DATA_FRAMEWORK_H */
@@ -26,6 +26,7 @@
 #define FOSSIL_DATA_ML_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -38,8 +39,10 @@ extern "C" {
  * Implements basic ML tasks (regression, classification, clustering) using internal model logic.
  *
  * Internal model definitions:
- *   - fossil_ml_model_kind_t: MODEL_LINEAR, MODEL_LOGISTIC, MODEL_KMEANS
- *   - fossil_ml_model_t: stores model kind, shape, weights (regression), centers (kmeans), cluster count
+ *   - fossil_ml_model_kind_t: MODEL_LINEAR, MODEL_LOGISTIC, MODEL_KMEANS,
+ *     MODEL_DECISION_TREE, MODEL_GRADIENT_BOOSTING, MODEL_KNN
+ *   - fossil_ml_model_t: stores model kind, shape, weights (regression), centers (kmeans),
+ *     cluster count, tree nodes (trees), inverted lists (knn)
  *
  * Supported type string IDs:
  *   - "i8", "i16", "i32", "i64"
@@ -51,11 +54,100 @@ extern "C" {
  * Supported model string IDs:
  *   - "linear_regression" (MODEL_LINEAR)
  *   - "logistic_regression" (MODEL_LOGISTIC)
+ *   - "ridge", "lasso", "elastic_net" (MODEL_LINEAR, fit by coordinate descent)
+ *   - "decision_tree" (MODEL_DECISION_TREE)
+ *   - "gradient_boosting" (MODEL_GRADIENT_BOOSTING)
+ *   - "knn" (MODEL_KNN)
  *   - "kmeans" (MODEL_KMEANS)
  *
  * Model handles are opaque pointers managed by the library.
  */
 
+/**
+ * @brief Training options for fossil_data_ml_train_ex.
+ *
+ * Initialize with fossil_data_ml_options_init and override the fields you
+ * need. Fields a model does not use are ignored.
+ *
+ * Supported k-means init string IDs:
+ *   - "kmeans++" (default): distance-weighted random seeding
+ *   - "first": the first k rows
+ *
+ * Supported k-means algorithm string IDs:
+ *   - "auto" (default): "elkan" for large k on wide data, "hamerly" otherwise
+ *   - "lloyd": full distance scan every iteration
+ *   - "hamerly": one lower bound per row, low memory
+ *   - "elkan": one lower bound per row and cluster, prunes the most
+ *     distance evaluations for large k
+ *
+ * "ridge", "lasso" and "elastic_net" minimize
+ *   1/(2 rows) |y - Xw|^2 + l1 |w|_1 + l2/2 |w|^2
+ * with l1 = 0 for ridge and l2 = 0 for lasso. They stop once a full pass
+ * changes the fitted values by no more than tol (RMS); max_iter caps the
+ * number of passes.
+ *
+ * "decision_tree" and "gradient_boosting" fit squared-loss regression
+ * trees on features binned into at most max_bins quantile bins. Split
+ * search works on per-node gradient histograms, parallel over features,
+ * and builds only the smaller child's histogram from rows (the larger is
+ * the parent's minus it). Boosting runs max_iter rounds (default 100) of
+ * depth max_depth (default 6) with step learning_rate (default 0.1); a
+ * decision tree is one round with depth 10 by default. l2 regularizes
+ * leaf values. NaN features always take the right branch.
+ *
+ * "knn" builds an inverted-file index: k-means (on a sample of at most
+ * 64 rows per list, max_iter rounds, default 20) splits the rows into
+ * n_lists lists (default sqrt(rows)), and a query scans the n_probe
+ * lists with the nearest centers (default n_lists / 16). n_probe =
+ * n_lists is an exact search. Predict averages the targets of the
+ * n_neighbors nearest rows, or takes their most common target for
+ * integer output types.
+ */
+typedef struct {
+    size_t k;              /**< Cluster count for "kmeans" (default 3). */
+    size_t max_iter;       /**< Iteration cap; 0 selects the model default. */
+    double tol;            /**< k-means stops when no center moves further than this. */
+    double learning_rate;  /**< Gradient step for regression; 0 selects the model default. */
+    uint64_t seed;         /**< Seed for randomized initialization. */
+    const char* init;      /**< k-means init string ID. */
+    const char* algorithm; /**< k-means assignment algorithm string ID. */
+    size_t batch_size;     /**< k-means mini-batch size (capped at rows); 0 runs full-batch Lloyd. */
+    double l2;             /**< L2 penalty for regression weights (default 0). */
+    double l1;             /**< L1 penalty for "lasso" and "elastic_net" (default 0). */
+    double l1_ratio;       /**< L1 share of alpha for elastic-net paths (default 0.5). */
+    size_t max_depth;      /**< Tree depth limit; 0 selects the model default. */
+    size_t min_samples_leaf; /**< Fewest rows in a tree leaf; 0 selects 1. */
+    size_t max_bins;       /**< Feature bins for trees, 2..256; 0 selects 256. */
+    size_t n_lists;        /**< k-NN index lists; 0 selects sqrt(rows). */
+    size_t n_probe;        /**< k-NN lists scanned per query; 0 selects n_lists / 16. */
+    size_t n_neighbors;    /**< Neighbors used by k-NN predict (default 5). */
+} fossil_data_ml_options_t;
+
+/**
+ * @brief Sparse feature matrix in compressed row or column form.
+ *
+ * "csr": indptr has rows + 1 entries, and row i holds the values
+ * values[indptr[i] .. indptr[i+1]) at columns indices[...].
+ * "csc": indptr has cols + 1 entries, and column j holds its values at
+ * row indices[...]. indptr[0] must be 0 and indptr must not decrease.
+ * Values use the type_id passed to the call; absent entries are zero.
+ */
+typedef struct {
+    const char* layout;     /**< "csr" or "csc". */
+    size_t rows;            /**< Number of samples. */
+    size_t cols;            /**< Number of features. */
+    const size_t* indptr;   /**< Offsets into indices/values per row or column. */
+    const size_t* indices;  /**< Column (csr) or row (csc) of each stored value. */
+    const void* values;     /**< Stored values, of type type_id. */
+} fossil_data_ml_sparse_t;
+
+/**
+ * @brief Fill an options struct with the library defaults.
+ *
+ * @param opts Options struct to initialize.
+ */
+void fossil_data_ml_options_init(fossil_data_ml_options_t* opts);
+
 /**
  * @brief Train a machine learning model.
  *
@@ -82,15 +174,252 @@ int fossil_data_ml_train(
     void** model_handle
 );
 
+/**
+ * @brief Train a machine learning model with explicit options.
+ *
+ * Same as fossil_data_ml_train, with training controlled by `options`.
+ * k-means stops early once no row changes cluster between iterations or
+ * no center moves further than options->tol. The bounds-based algorithms
+ * skip distance evaluations the triangle inequality rules out and reach
+ * the same clustering as "lloyd" for the same seed. With options->batch_size
+ * set, k-means runs mini-batch updates on randomly sampled rows instead.
+ *
+ * @param X            Pointer to the input feature matrix (row-major order).
+ * @param y            Pointer to the target labels or values (may be NULL for "kmeans").
+ * @param rows         Number of samples (rows) in the input data.
+ * @param cols         Number of features (columns) in the input data.
+ * @param type_id      String ID specifying the data type.
+ * @param model_id     String ID specifying the model type.
+ * @param options      Training options, or NULL for the defaults.
+ * @param model_handle Output pointer to the trained model handle (opaque pointer).
+ * @return             0 on success, non-zero on failure (e.g., k == 0 or k > rows).
+ */
+int fossil_data_ml_train_ex(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle
+);
+
+/**
+ * @brief Train several regression models that share one feature matrix.
+ *
+ * Fits `n_models` linear or logistic regression models in one pass over X
+ * per iteration instead of one pass per model: model i fits column
+ * y_index[i] of the row-major `rows x y_cols` target matrix Y with L2
+ * penalty l2[i]. Use distinct columns for multi-output regression, or
+ * repeat a column with different penalties to sweep regularization. Each
+ * model gets the same weights it would get from fossil_data_ml_train_ex.
+ *
+ * @param X             Pointer to the input feature matrix (row-major order).
+ * @param Y             Pointer to the target matrix (row-major, rows x y_cols).
+ * @param rows          Number of samples (rows).
+ * @param cols          Number of features (columns).
+ * @param y_cols        Number of target columns in Y.
+ * @param y_index       Target column per model, or NULL for model i -> column i.
+ * @param l2            L2 penalty per model, or NULL to use options->l2 for all.
+ * @param n_models      Number of models to train.
+ * @param type_id       String ID specifying the type of X and Y.
+ * @param model_id      "linear_regression" or "logistic_regression".
+ * @param options       Training options, or NULL for the defaults.
+ * @param model_handles Output array of `n_models` model handles.
+ * @return              0 on success, non-zero on failure (no handles are returned;
+ *                      invalid arguments leave model_handles untouched).
+ */
+int fossil_data_ml_train_multi(
+    const void* X,
+    const void* Y,
+    size_t rows,
+    size_t cols,
+    size_t y_cols,
+    const size_t* y_index,
+    const double* l2,
+    size_t n_models,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handles
+);
+
+/**
+ * @brief Fit a penalized regression model for each strength on a path.
+ *
+ * Model i is fit with penalty strength alphas[i]: "ridge" uses l2 = alpha,
+ * "lasso" uses l1 = alpha, and "elastic_net" uses l1 = alpha * l1_ratio
+ * and l2 = alpha * (1 - l1_ratio). Each fit warm-starts from the previous
+ * solution, so pass alphas in decreasing order: neighbouring solutions are
+ * close and each takes a few passes instead of a fit from scratch.
+ *
+ * @param X             Pointer to the input feature matrix (row-major order).
+ * @param y             Pointer to the target vector.
+ * @param rows          Number of samples (rows).
+ * @param cols          Number of features (columns).
+ * @param alphas        Penalty strengths, each >= 0.
+ * @param n_alphas      Number of strengths and models.
+ * @param type_id       String ID specifying the type of X and y.
+ * @param model_id      "ridge", "lasso" or "elastic_net".
+ * @param options       Training options (tol, max_iter, l1_ratio), or NULL.
+ * @param model_handles Output array of `n_alphas` model handles.
+ * @return              0 on success, non-zero on failure. Invalid arguments
+ *                      (-1, -2, -4) leave model_handles untouched; any later
+ *                      failure sets every handle to NULL.
+ */
+int fossil_data_ml_train_path(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const double* alphas,
+    size_t n_alphas,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handles
+);
+
+/**
+ * @brief Score parameter choices by k-fold cross-validation.
+ *
+ * Rows are shuffled with grid[0].seed into n_folds near-equal folds. For
+ * each grid point g and fold f, a model is trained with options grid[g]
+ * on the other folds and scored on fold f into scores[g * n_folds + f].
+ * Folds and grid points run concurrently on the thread pool. X and y are
+ * converted once and every task trains and scores through row indices
+ * into that copy. Gradient-trained models need no more than that; "ridge",
+ * "lasso", "elastic_net" and "knn" also hold a copy of their training
+ * rows per task in flight, so those run fewer tasks at once when the
+ * copies would exceed a fixed budget (256 MiB). Scores do not depend on
+ * the thread count.
+ *
+ * Metrics: "mse" (default) and "mae" compare raw predictions (logistic
+ * probabilities), lower is better; "accuracy" is the fraction of
+ * predictions equal to the target once thresholded (logistic), voted
+ * (knn) or rounded, higher is better.
+ *
+ * @param X        Pointer to the input feature matrix (row-major order).
+ * @param y        Pointer to the target vector.
+ * @param rows     Number of samples (rows).
+ * @param cols     Number of features (columns).
+ * @param type_id  String ID specifying the type of X and y.
+ * @param model_id Any supervised model ID accepted by fossil_data_ml_train_ex().
+ * @param grid     Training options to compare.
+ * @param n_grid   Number of grid points.
+ * @param n_folds  Number of folds, from 2 to rows.
+ * @param metric   "mse", "mae" or "accuracy", or NULL for "mse".
+ * @param scores   Output n_grid x n_folds scores.
+ * @param best     Output index of the grid point with the best mean score, or NULL.
+ * @return         0 on success, -4 for kmeans, other non-zero values on failure.
+ */
+int fossil_data_ml_cross_validate(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* grid,
+    size_t n_grid,
+    size_t n_folds,
+    const char* metric,
+    double* scores,
+    size_t* best
+);
+
+/**
+ * @brief Train a model on a sparse feature matrix.
+ *
+ * Each regression iteration costs O(stored values + cols), the cols term
+ * being the dense weight update, rather than O(rows x cols), so wide
+ * one-hot or bag-of-words features never need a dense copy. CSC input is
+ * converted to CSR once. Regression follows fossil_data_ml_train_ex;
+ * "kmeans" runs Lloyd iterations with dense centers, so options->algorithm
+ * and options->batch_size are ignored. Models are ordinary model handles.
+ *
+ * @param X            Sparse feature matrix.
+ * @param y            Pointer to the target vector (rows entries, ignored for kmeans).
+ * @param type_id      String ID specifying the type of the values and y.
+ * @param model_id     "linear_regression", "logistic_regression" or "kmeans".
+ * @param options      Training options, or NULL for the defaults.
+ * @param model_handle Output pointer to the trained model handle.
+ * @return             0 on success, non-zero on failure.
+ */
+int fossil_data_ml_train_sparse(
+    const fossil_data_ml_sparse_t* X,
+    const void* y,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle
+);
+
+/**
+ * @brief Predict from a sparse feature matrix.
+ *
+ * Accepts linear, logistic, kmeans, decision_tree and gradient_boosting
+ * models, however they were trained; X->cols must match the model.
+ * Output follows fossil_data_ml_predict.
+ *
+ * @param X            Sparse feature matrix.
+ * @param y_pred       Pointer to the output prediction buffer (X->rows entries).
+ * @param model_handle Trained model handle.
+ * @param type_id      String ID specifying the type of the values and y_pred.
+ * @return             0 on success, -4 if the model kind (e.g. knn) is not
+ *                     supported, other non-zero values on failure.
+ */
+int fossil_data_ml_predict_sparse(
+    const fossil_data_ml_sparse_t* X,
+    void* y_pred,
+    void* model_handle,
+    const char* type_id
+);
+
+/**
+ * @brief Update a model incrementally from one chunk of rows.
+ *
+ * Streams data through a model without holding the full dataset in memory.
+ * When *model_handle is NULL a new model is created and seeded from this
+ * chunk (which must hold at least options->k rows); otherwise the existing
+ * model is updated in place. Each call is a single pass over the chunk:
+ * rows are assigned to the current centers, then every center moves
+ * towards its rows with a learning rate of 1 / rows absorbed so far.
+ * Models from fossil_data_ml_train_ex with model "kmeans" can be updated
+ * the same way.
+ *
+ * Only "kmeans" is supported.
+ *
+ * @param X            Pointer to the chunk (row-major order).
+ * @param rows         Number of rows in the chunk.
+ * @param cols         Number of features; must match an existing model.
+ * @param type_id      String ID specifying the data type.
+ * @param model_id     String ID specifying the model type ("kmeans").
+ * @param options      Options used when creating a model, or NULL for the defaults.
+ * @param model_handle In/out model handle.
+ * @return             0 on success, non-zero on failure.
+ */
+int fossil_data_ml_partial_fit(
+    const void* X,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle
+);
+
 /**
  * @brief Make predictions using a trained machine learning model.
  *
  * This function uses a previously trained model to make predictions on new input data.
- * The predictions are written to the y_pred buffer.
+ * The predictions are written to the y_pred buffer. Rows are processed in tiles that
+ * are converted to f64 once and scored in parallel on the worker pool.
  *
  * @param X            Pointer to the input feature matrix (row-major order).
  * @param rows         Number of samples (rows) in the input data.
- * @param cols         Number of features (columns) in the input data.
+ * @param cols         Number of features (columns); must match the trained model.
  * @param y_pred       Output buffer for predicted values or labels.
  * @param model_handle Opaque pointer to the trained model.
  * @param type_id      String ID specifying the data type ("i32", "i64", "f32", "f64").
@@ -105,6 +434,132 @@ int fossil_data_ml_predict(
     const char* type_id
 );
 
+/**
+ * @brief Convert a regression model's weights to a reduced precision.
+ *
+ * "f32" stores single-precision weights; "i16" and "i8" store integers with
+ * one symmetric scale (the largest |weight| maps to 32767 or 127), cutting
+ * weight memory to 1/2, 1/4 or 1/8 of f64. fossil_data_ml_predict then scores
+ * matching features without converting them to f64: f32 features against f32
+ * weights, and i8/u8/i16 features against integer weights with exact integer
+ * dot products (AVX-VNNI/AVX2/SSE2 where available). Other feature types use
+ * the dequantized weights. "f64" converts back, keeping the rounding.
+ *
+ * @param model_handle Opaque pointer to a linear or logistic regression model.
+ * @param precision    "f64", "f32", "i16" or "i8".
+ * @return             0 on success, non-zero on failure (e.g. kmeans or tree models).
+ */
+int fossil_data_ml_quantize(void* model_handle, const char* precision);
+
+/**
+ * @brief Find the nearest training rows for a batch of queries.
+ *
+ * Queries run in parallel against a "knn" model's index. For each query
+ * the k nearest training rows (by squared Euclidean distance, ascending)
+ * are written as row indices into the training matrix. If the probed
+ * lists hold fewer than k rows the remaining lists are scanned as well.
+ *
+ * @param model_handle Trained "knn" model.
+ * @param Q            Pointer to the query matrix (row-major, n_queries x cols).
+ * @param n_queries    Number of queries.
+ * @param cols         Number of features; must match the model.
+ * @param type_id      String ID specifying the type of Q.
+ * @param k            Neighbors per query (at most the training row count).
+ * @param n_probe      Lists to scan per query, or 0 for the model default.
+ * @param indices      Output row indices (n_queries x k).
+ * @param distances    Output squared distances (n_queries x k), or NULL.
+ * @return             0 on success, non-zero on failure.
+ */
+int fossil_data_ml_knn_query(
+    const void* model_handle,
+    const void* Q,
+    size_t n_queries,
+    size_t cols,
+    const char* type_id,
+    size_t k,
+    size_t n_probe,
+    size_t* indices,
+    double* distances
+);
+
+/**
+ * @brief Compile a low-latency single-row predictor from a trained model.
+ *
+ * The predictor is an immutable snapshot of the model's parameters bound to
+ * one input type and column count, so each fossil_data_ml_predictor_score_one
+ * call skips argument validation, type-string dispatch and allocation. It
+ * stays valid after the model is updated or freed, and may be used from many
+ * threads at once without locking.
+ *
+ * @param model_handle Opaque pointer to a trained regression or kmeans model
+ *                     (tree models are not supported).
+ * @param cols         Number of features per row; must match the model.
+ * @param type_id      String ID of the row element type (also the output type,
+ *                     except "kmeans" which always writes an i32 cluster index).
+ * @param predictor    Output pointer to the predictor handle.
+ * @return             0 on success, non-zero on failure.
+ */
+int fossil_data_ml_predictor_create(
+    void* model_handle,
+    size_t cols,
+    const char* type_id,
+    void** predictor
+);
+
+/**
+ * @brief Score a single row with a compiled predictor.
+ *
+ * Reentrant and allocation-free. Output follows fossil_data_ml_predict: the
+ * regression value (logistic regression writes 0/1 for "i32" and "i64"), or
+ * the i32 cluster index for "kmeans".
+ *
+ * @param predictor Predictor from fossil_data_ml_predictor_create.
+ * @param row       Pointer to `cols` elements of the bound type.
+ * @param y_out     Pointer to one output element.
+ * @return          0 on success, non-zero on NULL arguments.
+ */
+int fossil_data_ml_predictor_score_one(
+    const void* predictor,
+    const void* row,
+    void* y_out
+);
+
+/**
+ * @brief Free a predictor created by fossil_data_ml_predictor_create.
+ *
+ * @param predictor Predictor handle (NULL is ignored).
+ * @return          0 on success.
+ */
+int fossil_data_ml_predictor_free(void* predictor);
+
+/**
+ * @brief Save a trained model to a binary file.
+ *
+ * Writes a versioned, native-endian format whose parameter arrays start on
+ * 64-byte boundaries, so fossil_data_ml_load_model can map it in place.
+ *
+ * @param model_handle Opaque pointer to the trained model.
+ * @param path         Destination file path (overwritten).
+ * @return             0 on success, -5 on I/O failure, other non-zero on failure.
+ */
+int fossil_data_ml_save_model(const void* model_handle, const char* path);
+
+/**
+ * @brief Load a model written by fossil_data_ml_save_model.
+ *
+ * "copy" reads the file into memory. "mmap" maps it copy-on-write and points
+ * the model's arrays into the mapping without copying, so load time does not
+ * grow with model size; the file must stay unchanged while the model lives.
+ * Either way the result behaves like a trained model, including partial_fit.
+ *
+ * @param path         Source file path.
+ * @param mode         "copy" (default when NULL) or "mmap".
+ * @param model_handle Output pointer to the loaded model handle.
+ * @return             0 on success, -5 if the file cannot be read or is not a
+ *                     compatible model file, other non-zero on failure.
+ */
+int fossil_data_ml_load_model(const char* path, const char* mode, void** model_handle);
+
 /**
  * @brief Free the resources associated with a trained machine learning model.
  *
@@ -157,6 +612,250 @@ public:
         return (result == 0) ? model_handle : nullptr;
     }
 
+    /**
+     * @brief Default training options (C++ wrapper).
+     *
+     * @return Options struct filled by fossil_data_ml_options_init.
+     */
+    static fossil_data_ml_options_t default_options() {
+        fossil_data_ml_options_t opts;
+        fossil_data_ml_options_init(&opts);
+        return opts;
+    }
+
+    /**
+     * @brief Train a machine learning model with explicit options (C++ wrapper).
+     *
+     * @param X        Pointer to the input feature matrix (row-major order).
+     * @param y        Pointer to the target labels or values.
+     * @param rows     Number of samples (rows) in the input data.
+     * @param cols     Number of features (columns) in the input data.
+     * @param type_id  String specifying the data type.
+     * @param model_id String specifying the model type.
+     * @param options  Training options.
+     * @return         Opaque pointer to the trained model, or nullptr on failure.
+     */
+    static void* train(
+        const void* X,
+        const void* y,
+        size_t rows,
+        size_t cols,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t& options
+    ) {
+        void* model_handle = nullptr;
+        int result = fossil_data_ml_train_ex(
+            X, y, rows, cols, type_id.c_str(), model_id.c_str(), &options, &model_handle
+        );
+        return (result == 0) ? model_handle : nullptr;
+    }
+
+    /**
+     * @brief Train several regression models sharing one feature matrix (C++ wrapper).
+     *
+     * @param X             Pointer to the input feature matrix (row-major order).
+     * @param Y             Pointer to the target matrix (row-major, rows x y_cols).
+     * @param rows          Number of samples.
+     * @param cols          Number of features.
+     * @param y_cols        Number of target columns in Y.
+     * @param y_index       Target column per model, or nullptr for model i -> column i.
+     * @param l2            L2 penalty per model, or nullptr to use options.l2.
+     * @param n_models      Number of models to train.
+     * @param type_id       String specifying the data type.
+     * @param model_id      "linear_regression" or "logistic_regression".
+     * @param options       Training options.
+     * @param model_handles Output array of `n_models` model handles.
+     * @return              0 on success, non-zero on failure.
+     */
+    static int train_multi(
+        const void* X,
+        const void* Y,
+        size_t rows,
+        size_t cols,
+        size_t y_cols,
+        const size_t* y_index,
+        const double* l2,
+        size_t n_models,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t& options,
+        void** model_handles
+    ) {
+        return fossil_data_ml_train_multi(
+            X, Y, rows, cols, y_cols, y_index, l2, n_models,
+            type_id.c_str(), model_id.c_str(), &options, model_handles
+        );
+    }
+
+    /**
+     * @brief Fit a penalized regression model per strength on a path (C++ wrapper).
+     *
+     * @param X             Pointer to the input feature matrix (row-major order).
+     * @param y             Pointer to the target vector.
+     * @param rows          Number of samples.
+     * @param cols          Number of features.
+     * @param alphas        Penalty strengths, best in decreasing order.
+     * @param n_alphas      Number of strengths and models.
+     * @param type_id       String specifying the data type.
+     * @param model_id      "ridge", "lasso" or "elastic_net".
+     * @param options       Training options.
+     * @param model_handles Output array of `n_alphas` model handles.
+     * @return              0 on success, non-zero on failure.
+     */
+    static int train_path(
+        const void* X,
+        const void* y,
+        size_t rows,
+        size_t cols,
+        const double* alphas,
+        size_t n_alphas,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t& options,
+        void** model_handles
+    ) {
+        return fossil_data_ml_train_path(
+            X, y, rows, cols, alphas, n_alphas,
+            type_id.c_str(), model_id.c_str(), &options, model_handles
+        );
+    }
+
+    /**
+     * @brief Score parameter choices by k-fold cross-validation (C++ wrapper).
+     *
+     * @param X        Pointer to the input feature matrix (row-major order).
+     * @param y        Pointer to the target vector.
+     * @param rows     Number of samples.
+     * @param cols     Number of features.
+     * @param type_id  String specifying the data type.
+     * @param model_id Supervised model ID.
+     * @param grid     Training options to compare.
+     * @param n_grid   Number of grid points.
+     * @param n_folds  Number of folds.
+     * @param metric   "mse", "mae" or "accuracy".
+     * @param scores   Output n_grid x n_folds scores.
+     * @param best     Output index of the best grid point, or nullptr.
+     * @return         0 on success, non-zero on failure.
+     */
+    static int cross_validate(
+        const void* X,
+        const void* y,
+        size_t rows,
+        size_t cols,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t* grid,
+        size_t n_grid,
+        size_t n_folds,
+        const std::string& metric,
+        double* scores,
+        size_t* best = nullptr
+    ) {
+        return fossil_data_ml_cross_validate(
+            X, y, rows, cols, type_id.c_str(), model_id.c_str(),
+            grid, n_grid, n_folds, metric.c_str(), scores, best
+        );
+    }
+
+    /**
+     * @brief Find the nearest training rows for a batch of queries (C++ wrapper).
+     *
+     * @param model_handle Trained "knn" model.
+     * @param Q            Pointer to the query matrix (row-major order).
+     * @param n_queries    Number of queries.
+     * @param cols         Number of features.
+     * @param type_id      String specifying the data type.
+     * @param k            Neighbors per query.
+     * @param n_probe      Lists to scan per query, or 0 for the model default.
+     * @param indices      Output row indices (n_queries x k).
+     * @param distances    Output squared distances, or nullptr.
+     * @return             0 on success, non-zero on failure.
+     */
+    static int knn_query(
+        const void* model_handle,
+        const void* Q,
+        size_t n_queries,
+        size_t cols,
+        const std::string& type_id,
+        size_t k,
+        size_t n_probe,
+        size_t* indices,
+        double* distances = nullptr
+    ) {
+        return fossil_data_ml_knn_query(
+            model_handle, Q, n_queries, cols, type_id.c_str(), k, n_probe, indices, distances
+        );
+    }
+
+    /**
+     * @brief Train a model on a sparse feature matrix (C++ wrapper).
+     *
+     * @param X            Sparse feature matrix.
+     * @param y            Pointer to the target vector (ignored for kmeans).
+     * @param type_id      String specifying the data type.
+     * @param model_id     String specifying the model type.
+     * @param options      Training options.
+     * @param model_handle Output pointer to the trained model handle.
+     * @return             0 on success, non-zero on failure.
+     */
+    static int train_sparse(
+        const fossil_data_ml_sparse_t& X,
+        const void* y,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t& options,
+        void** model_handle
+    ) {
+        return fossil_data_ml_train_sparse(
+            &X, y, type_id.c_str(), model_id.c_str(), &options, model_handle
+        );
+    }
+
+    /**
+     * @brief Predict from a sparse feature matrix (C++ wrapper).
+     *
+     * @param X            Sparse feature matrix.
+     * @param y_pred       Pointer to the output prediction buffer.
+     * @param model_handle Trained model handle.
+     * @param type_id      String specifying the data type.
+     * @return             0 on success, non-zero on failure.
+     */
+    static int predict_sparse(
+        const fossil_data_ml_sparse_t& X,
+        void* y_pred,
+        void* model_handle,
+        const std::string& type_id
+    ) {
+        return fossil_data_ml_predict_sparse(&X, y_pred, model_handle, type_id.c_str());
+    }
+
+    /**
+     * @brief Update a model incrementally from one chunk of rows (C++ wrapper).
+     *
+     * @param X            Pointer to the chunk (row-major order).
+     * @param rows         Number of rows in the chunk.
+     * @param cols         Number of features.
+     * @param type_id      String specifying the data type.
+     * @param model_id     String specifying the model type ("kmeans").
+     * @param options      Options used when creating a model.
+     * @param model_handle In/out model handle; nullptr creates a new model.
+     * @return             0 on success, non-zero on failure.
+     */
+    static int partial_fit(
+        const void* X,
+        size_t rows,
+        size_t cols,
+        const std::string& type_id,
+        const std::string& model_id,
+        const fossil_data_ml_options_t& options,
+        void*& model_handle
+    ) {
+        return fossil_data_ml_partial_fit(
+            X, rows, cols, type_id.c_str(), model_id.c_str(), &options, &model_handle
+        );
+    }
+
     /**
      * @brief Make predictions using a trained machine learning model (C++ wrapper).
      *
@@ -185,6 +884,76 @@ public:
         );
     }
 
+    /**
+     * @brief Convert a regression model's weights to a reduced precision (C++ wrapper).
+     *
+     * @param model_handle Opaque pointer to the trained model.
+     * @param precision    "f64", "f32", "i16" or "i8".
+     * @return             0 on success, non-zero on failure.
+     */
+    static int quantize(void* model_handle, const std::string& precision) {
+        return fossil_data_ml_quantize(model_handle, precision.c_str());
+    }
+
+    /**
+     * @brief Compile a low-latency single-row predictor (C++ wrapper).
+     *
+     * @param model_handle Opaque pointer to the trained model.
+     * @param cols         Number of features per row.
+     * @param type_id      String specifying the row element type.
+     * @return             Predictor handle, or nullptr on failure.
+     */
+    static void* predictor_create(void* model_handle, size_t cols, const std::string& type_id) {
+        void* predictor = nullptr;
+        int result = fossil_data_ml_predictor_create(model_handle, cols, type_id.c_str(), &predictor);
+        return (result == 0) ? predictor : nullptr;
+    }
+
+    /**
+     * @brief Score a single row with a compiled predictor (C++ wrapper).
+     *
+     * @param predictor Predictor handle.
+     * @param row       Pointer to one row of the bound type.
+     * @param y_out     Pointer to one output element.
+     * @return          0 on success, non-zero on failure.
+     */
+    static int score_one(const void* predictor, const void* row, void* y_out) {
+        return fossil_data_ml_predictor_score_one(predictor, row, y_out);
+    }
+
+    /**
+     * @brief Free a predictor (C++ wrapper).
+     *
+     * @param predictor Predictor handle.
+     */
+    static void predictor_free(void* predictor) {
+        fossil_data_ml_predictor_free(predictor);
+    }
+
+    /**
+     * @brief Save a trained model to a binary file (C++ wrapper).
+     *
+     * @param model_handle Opaque pointer to the trained model.
+     * @param path         Destination file path.
+     * @return             0 on success, non-zero on failure.
+     */
+    static int save_model(const void* model_handle, const std::string& path) {
+        return fossil_data_ml_save_model(model_handle, path.c_str());
+    }
+
+    /**
+     * @brief Load a model written by save_model (C++ wrapper).
+     *
+     * @param path Source file path.
+     * @param mode "copy" or "mmap".
+     * @return     Opaque pointer to the loaded model, or nullptr on failure.
+     */
+    static void* load_model(const std::string& path, const std::string& mode = "copy") {
+        void* model_handle = nullptr;
+        int result = fossil_data_ml_load_model(path.c_str(), mode.c_str(), &model_handle);
+        return (result == 0) ? model_handle : nullptr;
+    }
+
     /**
      * @brief Free the resources associated with a trained machine learning model (C++ wrapper).
      *
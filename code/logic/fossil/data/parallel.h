@@ -0,0 +1,150 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_DATA_PARALLEL_H
+#define FOSSIL_DATA_PARALLEL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file fossil_data_parallel.h
+ * @brief Shared worker pool used by the data-parallel kernels.
+ *
+ * Work is expressed as a range [0, count) split into fixed-size chunks of
+ * `grain` elements. Chunk boundaries depend only on count and grain, never on
+ * the number of threads, so callers that reduce per-chunk partial results in
+ * chunk order get bit-identical output for any thread count.
+ *
+ * The pool is created lazily on first use. A parallel region started while
+ * another one is running (nested calls, or concurrent calls from several user
+ * threads) runs its chunks inline on the calling thread.
+ *
+ * Building with FOSSIL_DATA_NO_THREADS defined turns every region into a
+ * serial loop on the calling thread.
+ */
+
+/**
+ * @brief Chunk callback.
+ *
+ * @param ctx    User context passed to fossil_data_parallel_for.
+ * @param chunk  Index of this chunk, in [0, fossil_data_parallel_chunks(count, grain)).
+ * @param begin  First element of the chunk.
+ * @param end    One past the last element of the chunk.
+ */
+typedef void (*fossil_data_parallel_fn)(void* ctx, size_t chunk, size_t begin, size_t end);
+
+/**
+ * @brief Set the number of threads used by parallel regions.
+ *
+ * @param threads Thread count including the calling thread; 0 restores the
+ *                hardware default.
+ * @return        0 on success.
+ */
+int fossil_data_parallel_set_threads(size_t threads);
+
+/**
+ * @brief Get the number of threads used by parallel regions.
+ *
+ * @return Thread count including the calling thread (always >= 1).
+ */
+size_t fossil_data_parallel_get_threads(void);
+
+/**
+ * @brief Number of chunks a range is split into.
+ *
+ * @param count Number of elements.
+ * @param grain Elements per chunk (0 is treated as 1).
+ * @return      ceil(count / grain).
+ */
+size_t fossil_data_parallel_chunks(size_t count, size_t grain);
+
+/**
+ * @brief Run fn over [0, count) in chunks of grain elements.
+ *
+ * Returns after every chunk has completed.
+ *
+ * @param count Number of elements.
+ * @param grain Elements per chunk (0 is treated as 1).
+ * @param fn    Chunk callback.
+ * @param ctx   User context forwarded to fn.
+ * @return      0 on success, non-zero on invalid arguments.
+ */
+int fossil_data_parallel_for(
+    size_t count,
+    size_t grain,
+    fossil_data_parallel_fn fn,
+    void* ctx
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+namespace fossil::data {
+
+class Parallel {
+public:
+    /**
+     * @brief Set the number of threads used by parallel regions (C++ wrapper).
+     *
+     * @param threads Thread count including the calling thread; 0 restores the default.
+     * @return        0 on success.
+     */
+    static int set_threads(size_t threads) {
+        return fossil_data_parallel_set_threads(threads);
+    }
+
+    /**
+     * @brief Get the number of threads used by parallel regions (C++ wrapper).
+     *
+     * @return Thread count including the calling thread.
+     */
+    static size_t get_threads() {
+        return fossil_data_parallel_get_threads();
+    }
+
+    /**
+     * @brief Run a chunk callback over [0, count) (C++ wrapper).
+     *
+     * @param count Number of elements.
+     * @param grain Elements per chunk.
+     * @param fn    Chunk callback.
+     * @param ctx   User context forwarded to fn.
+     * @return      0 on success, non-zero on invalid arguments.
+     */
+    static int for_each(size_t count, size_t grain, fossil_data_parallel_fn fn, void* ctx) {
+        return fossil_data_parallel_for(count, grain, fn, ctx);
+    }
+};
+
+} // namespace fossil::data
+#endif
+
+#endif /* FOSSIL_DATA_PARALLEL_H */
@@ -26,6 +26,7 @@
 #define FOSSIL_DATA_SERIES_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,7 +39,8 @@ extern "C" {
  * Provides cumulative sum, rolling mean, and other sequence-level transformations.
  *
  * Supported type string IDs:
- *   - "i32", "i64", "f32", "f64"
+ *   - "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "size",
+ *     "f32", "f64", "bool", and "hex", "oct", "bin" (stored as u64)
  */
 
 /**
@@ -48,39 +50,834 @@ extern "C" {
  * and stores the result in the output buffer. The operation is performed according
  * to the type specified by the type_id string ("i32", "i64", "f32", "f64").
  *
+ * Integer sums are exact and wrap like the type's own arithmetic; floating
+ * sums are accumulated in double. Long sequences are scanned in fixed blocks
+ * across the thread pool, and the result does not depend on the thread
+ * count. output may equal input.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error (e.g., unsupported type).
+ */
+int fossil_data_series_cumsum(
+    const void* input,
+    void* output,
+    size_t count,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling mean (moving average) of a sequence.
+ *
+ * This function calculates the rolling mean over a fixed window size for the input
+ * sequence and stores the result in the output buffer. The operation is performed
+ * according to the type specified by the type_id string ("i32", "i64", "f32", "f64").
+ * The window parameter specifies the number of elements to include in each mean.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error (e.g., unsupported type or invalid window).
+ */
+int fossil_data_series_rolling_mean(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+);
+
+/*
+ * Rolling statistics below follow rolling_mean: output[i] covers the last
+ * min(i + 1, window) inputs, results are stored in the input type (integer
+ * outputs truncate and saturate), output may equal input, and each call
+ * costs O(1) per element for sum/var/std/min/max and O(log window) for
+ * median/quantile, allocating O(window) state once. They return 0 on
+ * success, -1 on invalid arguments and -3 if the state cannot be allocated.
+ *
+ * Non-finite inputs affect only the windows that hold them. A NaN makes
+ * every statistic NaN for as long as it is in the window. Infinities make
+ * sum and mean +inf or -inf (NaN if both signs are present) and var and
+ * std NaN; min, max and quantiles order them like any other value.
+ */
+
+/**
+ * @brief Computes the rolling sum of a sequence.
+ *
+ * Sums are kept in double with compensated updates.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_sum(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling variance of a sequence.
+ *
+ * Updated in O(1) as values enter and leave the window, from compensated
+ * sums of deviations taken about a value inside the window, so constant
+ * windows give exactly 0. The sum of squared deviations is divided by
+ * n - ddof (ddof = 1 for the sample variance, 0 for the population
+ * variance); windows holding no more than ddof values give 0.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param ddof     Delta degrees of freedom.
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_var(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling standard deviation of a sequence.
+ *
+ * The square root of fossil_data_series_rolling_var().
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param ddof     Delta degrees of freedom.
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_std(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling minimum of a sequence (monotonic deque).
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_min(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling maximum of a sequence (monotonic deque).
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_max(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+);
+
+/**
+ * @brief Computes the rolling median of a sequence.
+ *
+ * Equivalent to fossil_data_series_rolling_quantile() with q = 0.5: even
+ * windows give the mean of the two middle values.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_median(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+);
+
+/**
+ * @brief Computes a rolling quantile of a sequence.
+ *
+ * The window is split between a max-heap of its smallest values and a
+ * min-heap of the rest, so the order statistics around position
+ * q * (n - 1) are the two heap tops; the result interpolates linearly
+ * between them.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param window   Size of the rolling window (must be > 0).
+ * @param q        Quantile in [0, 1].
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, non-zero on error.
+ */
+int fossil_data_series_rolling_quantile(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    double q,
+    const char* type_id
+);
+
+/**
+ * @brief Computes several rolling statistics in one pass over a sequence.
+ *
+ * Feature k is the statistic stats[k] ("sum", "mean", "var", "std", "min",
+ * "max" or "median") over a window of windows[k], written to outputs[k] in
+ * the input type, exactly as the matching single-statistic call would
+ * write it. The input is read and converted once per tile and shared by
+ * every feature, so adding a feature costs its update, not another sweep
+ * over memory. An output may equal the input.
+ *
+ * @param input    Pointer to the input data array.
+ * @param outputs  n_stats output arrays of count elements (pre-allocated).
+ * @param count    Number of elements in the input and in each output.
+ * @param stats    n_stats statistic names.
+ * @param windows  n_stats window sizes (each > 0).
+ * @param n_stats  Number of features.
+ * @param ddof     Delta degrees of freedom for "var" and "std" features.
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments or an unknown
+ *                 statistic, -3 on allocation failure.
+ */
+int fossil_data_series_rolling_multi(
+    const void* input,
+    void* const* outputs,
+    size_t count,
+    const char* const* stats,
+    const size_t* windows,
+    size_t n_stats,
+    size_t ddof,
+    const char* type_id
+);
+
+/**
+ * @brief Create a stream that updates cumsum or a rolling statistic online.
+ *
+ * A stream keeps its state between fossil_data_series_stream_push calls, so
+ * each batch costs O(batch) instead of recomputing the history. kind is
+ * "cumsum" or one of the rolling statistics of
+ * fossil_data_series_rolling_multi(). Pushing a series in any split of
+ * batches writes what the matching batch function writes for the whole
+ * series: exactly for rolling streams and integer cumsums, and up to
+ * rounding for floating cumsums.
+ *
+ * @param kind     "cumsum", "sum", "mean", "var", "std", "min", "max" or "median".
+ * @param window   Rolling window size (> 0; ignored for "cumsum").
+ * @param ddof     Delta degrees of freedom for "var" and "std".
+ * @param type_id  String identifier for the element type of every push.
+ * @param stream   Output pointer to the stream handle.
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_stream_create(
+    const char* kind,
+    size_t window,
+    size_t ddof,
+    const char* type_id,
+    void** stream
+);
+
+/**
+ * @brief Push a batch of values through a stream.
+ *
+ * @param stream  Stream handle.
+ * @param input   count values of the stream's type.
+ * @param output  count values of the stream's type receiving the statistic
+ *                after each value (may equal input), or NULL.
+ * @param count   Number of values (0 is a no-op).
+ * @return        0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_stream_push(
+    void* stream,
+    const void* input,
+    void* output,
+    size_t count
+);
+
+/**
+ * @brief Read the statistic after the newest pushed value.
+ *
+ * @param stream  Stream handle.
+ * @param value   One element of the stream's type (a cumsum of nothing is 0).
+ * @return        0 on success, -1 on invalid arguments or a rolling stream
+ *                that has no values yet.
+ */
+int fossil_data_series_stream_value(const void* stream, void* value);
+
+/**
+ * @brief Serialize a stream's state into a caller buffer.
+ *
+ * The state is a versioned, native-endian image of window * 8 to 33 bytes
+ * plus a fixed header; call with buffer NULL to query its size.
+ *
+ * @param stream    Stream handle.
+ * @param buffer    Destination buffer, or NULL to query the size.
+ * @param capacity  Size of buffer in bytes.
+ * @param size      Receives the number of bytes the state takes.
+ * @return          0 on success, -1 on invalid arguments or a short buffer.
+ */
+int fossil_data_series_stream_save(
+    const void* stream,
+    void* buffer,
+    size_t capacity,
+    size_t* size
+);
+
+/**
+ * @brief Recreate a stream from a state written by fossil_data_series_stream_save.
+ *
+ * The loaded stream continues exactly where the saved one stopped.
+ *
+ * @param buffer  Saved state.
+ * @param size    Size of the saved state in bytes.
+ * @param stream  Output pointer to the new stream handle.
+ * @return        0 on success, -1 on invalid arguments or a state that is
+ *                internally inconsistent (e.g. corrupted median heaps), -3
+ *                on allocation failure, -5 if the buffer is not a
+ *                compatible stream state.
+ */
+int fossil_data_series_stream_load(const void* buffer, size_t size, void** stream);
+
+/**
+ * @brief Free a stream.
+ *
+ * @param stream  Stream handle (NULL is ignored).
+ * @return        0 on success.
+ */
+int fossil_data_series_stream_free(void* stream);
+
+/**
+ * @brief Exponentially weighted moving average.
+ *
+ * m[0] = x[0], m[t] = m[t-1] + alpha * (x[t] - m[t-1]); output is m in the
+ * input type. output may equal input.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param alpha    Smoothing factor in (0, 1].
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_ewma(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    const char* type_id
+);
+
+/**
+ * @brief Exponentially weighted moving variance.
+ *
+ * Updated alongside the EWMA: with d = x[t] - m[t-1],
+ * v[t] = (1 - alpha) * (v[t-1] + alpha * d * d), starting from v[0] = 0.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param alpha    Smoothing factor in (0, 1].
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_ewvar(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    const char* type_id
+);
+
+/**
+ * @brief Holt (double exponential) smoothing.
+ *
+ * Level l[t] = alpha * x[t] + (1 - alpha) * (l[t-1] + b[t-1]) and trend
+ * b[t] = beta * (l[t] - l[t-1]) + (1 - beta) * b[t-1], from l[0] = x[0]
+ * and b[0] = 0. output[t] = l[t] + b[t], the forecast for step t + 1.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Pointer to the output data array (must be pre-allocated).
+ * @param count    Number of elements in the input/output arrays.
+ * @param alpha    Level smoothing factor in (0, 1].
+ * @param beta     Trend smoothing factor in [0, 1].
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_holt(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    double beta,
+    const char* type_id
+);
+
+/**
+ * @brief Exponential smoothing of many independent series at once.
+ *
+ * Smooths n_series series of count steps each, one series per SIMD lane,
+ * blocks of series across the thread pool. With layout "time" (structure
+ * of arrays) the value of series s at step t is at t * n_series + s, which
+ * the lanes read directly; with "series" it is at s * count + t and tiles
+ * are transposed on the way through. Each series gets exactly what the
+ * single-series function returns for it, in either layout.
+ *
+ * @param input     n_series * count values.
+ * @param output    n_series * count values in the same layout (may equal input).
+ * @param n_series  Number of series.
+ * @param count     Steps per series.
+ * @param method    "ewma", "ewvar" or "holt".
+ * @param alpha     Smoothing factor in (0, 1].
+ * @param beta      Trend smoothing factor in [0, 1] ("holt" only).
+ * @param layout    "time" (default when NULL) or "series".
+ * @param type_id   String identifier for the data type.
+ * @return          0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_ew_many(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    const char* method,
+    double alpha,
+    double beta,
+    const char* layout,
+    const char* type_id
+);
+
+/**
+ * @brief Cumulative sum of every row of a block of series.
+ *
+ * Row s holds count values starting at element s * stride, in input and
+ * output alike. The type is parsed once and rows are spread across the
+ * thread pool; each row gets exactly what fossil_data_series_cumsum()
+ * writes for it. output may equal input.
+ *
+ * @param input     Pointer to the input block.
+ * @param output    Pointer to the output block (must be pre-allocated).
+ * @param n_series  Number of rows.
+ * @param count     Values per row.
+ * @param stride    Elements from one row start to the next (>= count).
+ * @param type_id   String identifier for the data type.
+ * @return          0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_cumsum_batch(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    size_t stride,
+    const char* type_id
+);
+
+/**
+ * @brief Rolling statistic of every row of a block of series.
+ *
+ * Rows are laid out as in fossil_data_series_cumsum_batch(), and each
+ * gets exactly what the matching single-series rolling call writes for
+ * it. Every pool worker reuses one window state across its rows.
+ *
+ * @param input     Pointer to the input block.
+ * @param output    Pointer to the output block (must be pre-allocated).
+ * @param n_series  Number of rows.
+ * @param count     Values per row.
+ * @param stride    Elements from one row start to the next (>= count).
+ * @param stat      "sum", "mean", "var", "std", "min", "max" or "median".
+ * @param window    Size of the rolling window (must be > 0).
+ * @param ddof      Delta degrees of freedom for "var" and "std".
+ * @param type_id   String identifier for the data type.
+ * @return          0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_rolling_batch(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    size_t stride,
+    const char* stat,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+);
+
+/**
+ * @brief Irregularly sampled series: values with nanosecond timestamps.
+ *
+ * time must not decrease; equal timestamps are allowed and keep their
+ * order. values holds count elements of type type_id.
+ */
+typedef struct {
+    const int64_t* time;   /**< Sample timestamps in nanoseconds. */
+    const void* values;    /**< Sample values, of type type_id. */
+    size_t count;          /**< Number of samples. */
+    const char* type_id;   /**< Type string ID of values. */
+} fossil_data_series_timed_t;
+
+/**
+ * @brief Bucket range covering every sample of a timed series.
+ *
+ * origin is the first sample time rounded down to a multiple of period,
+ * and n_buckets reaches the bucket holding the last sample.
+ *
+ * @param series     Timed series with at least one sample.
+ * @param period     Bucket width in nanoseconds (must be > 0).
+ * @param origin     Receives the start of the first bucket.
+ * @param n_buckets  Receives the number of buckets.
+ * @return           0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_resample_span(
+    const fossil_data_series_timed_t* series,
+    int64_t period,
+    int64_t* origin,
+    size_t* n_buckets
+);
+
+/**
+ * @brief Resamples a timed series to fixed-width buckets.
+ *
+ * Bucket k covers [origin + k * period, origin + (k + 1) * period), and
+ * its value aggregates the samples in it: "sum", "mean", "min", "max"
+ * or "last". Samples outside the range are ignored. Empty buckets are NaN
+ * (0 for integer types) with fill "none", and repeat the previous bucket
+ * with "ffill", the first ones taking the last sample before origin.
+ * Downsampling and forward-filled upsampling are the same single merge
+ * pass over samples and buckets. Values are aggregated in double and
+ * written in the series' type.
+ *
+ * @param series       Timed series; time must not decrease.
+ * @param origin       Start of the first bucket, in nanoseconds.
+ * @param period       Bucket width in nanoseconds (must be > 0).
+ * @param n_buckets    Number of buckets (must be > 0).
+ * @param agg          Aggregation string ID.
+ * @param fill         "none" (or NULL) or "ffill".
+ * @param bucket_time  Receives each bucket's start time; may be NULL.
+ * @param output       Receives n_buckets values of the series' type.
+ * @return             0 on success, -1 on invalid arguments or decreasing
+ *                     timestamps (output may then be partly written).
+ */
+int fossil_data_series_resample(
+    const fossil_data_series_timed_t* series,
+    int64_t origin,
+    int64_t period,
+    size_t n_buckets,
+    const char* agg,
+    const char* fill,
+    int64_t* bucket_time,
+    void* output
+);
+
+/**
+ * @brief As-of join: the last value of right at or before each timestamp.
+ *
+ * For every time[i], takes the last sample of right whose timestamp is
+ * at or before it, the latest one among equal timestamps, and no further
+ * back than tolerance nanoseconds. A timestamp with no such sample gets
+ * NaN (0 for integer types) and index SIZE_MAX. Both sides are walked
+ * together with a galloping search, in parallel over ranges of time.
+ *
+ * @param time       Left timestamps in nanoseconds; must not decrease.
+ * @param count      Number of left timestamps.
+ * @param right      Series to take values from; time must not decrease.
+ * @param tolerance  Largest distance back in nanoseconds; negative for no limit.
+ * @param output     Receives count values of right's type; may be NULL.
+ * @param index      Receives the matched right index per timestamp; may be NULL.
+ * @return           0 on success, -1 on invalid arguments or decreasing
+ *                   timestamps, -3 on allocation failure.
+ */
+int fossil_data_series_asof(
+    const int64_t* time,
+    size_t count,
+    const fossil_data_series_timed_t* right,
+    int64_t tolerance,
+    void* output,
+    size_t* index
+);
+
+/**
+ * @brief Time-aligned merge of several timed series.
+ *
+ * The rows are the distinct timestamps of all series in ascending order,
+ * and column s holds series s as-of joined onto them with tolerance: 0
+ * keeps only exact matches, a negative tolerance forward-fills without
+ * limit. Time ranges are merged in parallel and do not depend on the
+ * thread count. Call with time NULL to query the row count.
+ *
+ * @param series     Array of n_series timed series.
+ * @param n_series   Number of series (must be > 0).
+ * @param tolerance  As in fossil_data_series_asof().
+ * @param time       Receives the merged timestamps, or NULL to query.
+ * @param outputs    n_series columns of capacity values in each series'
+ *                   type; outputs or any column may be NULL to skip it.
+ * @param capacity   Rows that time and each column can hold.
+ * @param count      Receives the number of merged rows.
+ * @return           0 on success, -1 on invalid arguments, decreasing
+ *                   timestamps or a short buffer, -3 on allocation failure.
+ */
+int fossil_data_series_merge(
+    const fossil_data_series_timed_t* series,
+    size_t n_series,
+    int64_t tolerance,
+    int64_t* time,
+    void* const* outputs,
+    size_t capacity,
+    size_t* count
+);
+
+/**
+ * @brief Discrete Fourier transform of a real series.
+ *
+ * spectrum receives the count / 2 + 1 non-negative frequency bins as
+ * interleaved (re, im) doubles, unscaled. Any count works: lengths whose
+ * prime factors are at most 13 run mixed-radix passes, others a chirp
+ * transform on a power-of-two length. Plans for the 8 most recently used
+ * lengths stay cached for the life of the process, shared by every
+ * transform in this module; fossil_data_series_fft_cache_clear() frees
+ * them.
+ *
+ * @param input     Pointer to the input series.
+ * @param count     Number of values.
+ * @param spectrum  Receives 2 * (count / 2 + 1) doubles.
+ * @param type_id   String identifier for the input type.
+ * @return          0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_rfft(
+    const void* input,
+    size_t count,
+    double* spectrum,
+    const char* type_id
+);
+
+/**
+ * @brief Inverse of fossil_data_series_rfft(), scaled by 1 / count.
+ *
+ * The imaginary parts of bin 0 (and bin count / 2 for even count) are
+ * ignored. Integer output types round to nearest, so the spectrum of an
+ * integer series gives it back exactly while its values stay below about
+ * 2^47 in magnitude; past that, rounding error in double can exceed 0.5.
+ *
+ * @param spectrum  count / 2 + 1 interleaved (re, im) bins.
+ * @param count     Number of values to reconstruct.
+ * @param output    Receives count values (must be pre-allocated).
+ * @param type_id   String identifier for the output type.
+ * @return          0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_irfft(
+    const double* spectrum,
+    size_t count,
+    void* output,
+    const char* type_id
+);
+
+/**
+ * @brief Full linear convolution of two series.
+ *
+ * output[k] is the sum of a[i] * b[k - i]. Short kernels run directly;
+ * longer ones multiply real spectra padded to a 2^i 3^j length. Integer
+ * types round the result to nearest. That is exact while the product of
+ * the two series' Euclidean norms, which also bounds every output, stays
+ * below about 2^47; larger integer results can be off by rounding error.
+ *
+ * @param a        Pointer to the first series.
+ * @param count_a  Values in a.
+ * @param b        Pointer to the second series.
+ * @param count_b  Values in b.
+ * @param output   Receives count_a + count_b - 1 values (must be pre-allocated).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_convolve(
+    const void* a,
+    size_t count_a,
+    const void* b,
+    size_t count_b,
+    void* output,
+    const char* type_id
+);
+
+/**
+ * @brief Full cross-correlation of two series.
+ *
+ * output[k] is the sum of a[i + k - (count_b - 1)] * b[i], i.e. the
+ * correlation at lag k - (count_b - 1); computed as a convolution with
+ * b reversed, so integer results are exact under the same 2^47 bound as
+ * fossil_data_series_convolve().
+ *
+ * @param a        Pointer to the first series.
+ * @param count_a  Values in a.
+ * @param b        Pointer to the second series.
+ * @param count_b  Values in b.
+ * @param output   Receives count_a + count_b - 1 values (must be pre-allocated).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_correlate(
+    const void* a,
+    size_t count_a,
+    const void* b,
+    size_t count_b,
+    void* output,
+    const char* type_id
+);
+
+/**
+ * @brief Sample autocorrelation for lags 0 .. max_lag.
+ *
+ * output[k] is the sum over t of (x[t] - m)(x[t + k] - m), divided by
+ * the same sum at lag 0, with m the series mean; a constant series gives
+ * NaN. Large lag ranges use one transform of length >= count + max_lag.
+ *
+ * @param input    Pointer to the input series.
+ * @param count    Number of values.
+ * @param max_lag  Largest lag (must be < count).
+ * @param output   Receives max_lag + 1 coefficients.
+ * @param type_id  String identifier for the input type.
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_autocorr(
+    const void* input,
+    size_t count,
+    size_t max_lag,
+    double* output,
+    const char* type_id
+);
+
+/**
+ * @brief Free the cached transform plans that no call is using.
+ *
+ * Plans in use by a running transform are left cached. Later transforms
+ * rebuild the plans they need.
+ *
+ * @return 0 on success.
+ */
+int fossil_data_series_fft_cache_clear(void);
+
+/**
+ * @brief Differences of order n: output[i] is the n-th difference at i.
+ *
+ * Order 1 is x[i] - x[i - 1], order 2 the difference of that, and so on;
+ * order 0 copies. The first order values have no difference and get NaN
+ * (0 for integer types). Integer differences are exact and wrap like the
+ * type's own arithmetic. output may equal input.
+ *
  * @param input    Pointer to the input data array.
  * @param output   Pointer to the output data array (must be pre-allocated).
  * @param count    Number of elements in the input/output arrays.
+ * @param order    Number of times to difference.
  * @param type_id  String identifier for the data type.
- * @return         0 on success, non-zero on error (e.g., unsupported type).
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
  */
-int fossil_data_series_cumsum(
+int fossil_data_series_diff(
     const void* input,
     void* output,
     size_t count,
+    size_t order,
     const char* type_id
 );
 
 /**
- * @brief Computes the rolling mean (moving average) of a sequence.
+ * @brief Relative change: output[i] = x[i] / x[i - periods] - 1.
  *
- * This function calculates the rolling mean over a fixed window size for the input
- * sequence and stores the result in the output buffer. The operation is performed
- * according to the type specified by the type_id string ("i32", "i64", "f32", "f64").
- * The window parameter specifies the number of elements to include in each mean.
+ * The first periods values are NaN; a zero base gives an infinity or NaN
+ * as in IEEE division. output may equal input for "f64" series.
+ *
+ * @param input    Pointer to the input data array.
+ * @param output   Receives count doubles.
+ * @param count    Number of elements.
+ * @param periods  Distance to the base value (must be > 0).
+ * @param type_id  String identifier for the input type.
+ * @return         0 on success, -1 on invalid arguments.
+ */
+int fossil_data_series_pct_change(
+    const void* input,
+    double* output,
+    size_t count,
+    size_t periods,
+    const char* type_id
+);
+
+/**
+ * @brief Shift values by periods positions.
+ *
+ * A positive shift lags, output[i] = x[i - periods]; a negative one
+ * leads, output[i] = x[i - periods] from later positions. Vacated
+ * positions get NaN (0 for integer types). Values are copied exactly.
+ * output may equal input.
  *
  * @param input    Pointer to the input data array.
  * @param output   Pointer to the output data array (must be pre-allocated).
  * @param count    Number of elements in the input/output arrays.
- * @param window   Size of the rolling window (must be > 0).
+ * @param periods  Positions to shift; negative shifts toward the start.
  * @param type_id  String identifier for the data type.
- * @return         0 on success, non-zero on error (e.g., unsupported type or invalid window).
+ * @return         0 on success, -1 on invalid arguments.
  */
-int fossil_data_series_rolling_mean(
+int fossil_data_series_shift(
     const void* input,
     void* output,
     size_t count,
-    size_t window,
+    ptrdiff_t periods,
+    const char* type_id
+);
+
+/**
+ * @brief Lagged feature block in one pass.
+ *
+ * Writes the row-major count x n_lags matrix whose row i holds
+ * x[i - lags[0]], ..., x[i - lags[n_lags - 1]], with NaN (0 for integer
+ * types) where a lag reaches before the start. With lags NULL the
+ * columns are lags 1 .. n_lags. Rows are written in order with their
+ * sources still in cache and spread across the thread pool; values are
+ * copied exactly. output must not overlap input.
+ *
+ * @param input    Pointer to the input data array.
+ * @param count    Number of elements, and rows of the output.
+ * @param lags     n_lags lags, or NULL for 1 .. n_lags.
+ * @param n_lags   Number of columns (must be > 0).
+ * @param output   Receives count * n_lags values (must be pre-allocated).
+ * @param type_id  String identifier for the data type.
+ * @return         0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_data_series_lag_matrix(
+    const void* input,
+    size_t count,
+    const size_t* lags,
+    size_t n_lags,
+    void* output,
     const char* type_id
 );
 
@@ -133,6 +930,386 @@ public:
                             size_t window, const std::string& type_id) {
         return fossil_data_series_rolling_mean(input, output, count, window, type_id.c_str());
     }
+
+    /**
+     * @brief Computes the rolling sum of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_sum(const void* input, void* output, size_t count,
+                           size_t window, const std::string& type_id) {
+        return fossil_data_series_rolling_sum(input, output, count, window, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes the rolling variance of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param ddof     Delta degrees of freedom (1 for the sample variance).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_var(const void* input, void* output, size_t count,
+                           size_t window, size_t ddof, const std::string& type_id) {
+        return fossil_data_series_rolling_var(input, output, count, window, ddof, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes the rolling standard deviation of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param ddof     Delta degrees of freedom (1 for the sample deviation).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_std(const void* input, void* output, size_t count,
+                           size_t window, size_t ddof, const std::string& type_id) {
+        return fossil_data_series_rolling_std(input, output, count, window, ddof, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes the rolling minimum of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_min(const void* input, void* output, size_t count,
+                           size_t window, const std::string& type_id) {
+        return fossil_data_series_rolling_min(input, output, count, window, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes the rolling maximum of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_max(const void* input, void* output, size_t count,
+                           size_t window, const std::string& type_id) {
+        return fossil_data_series_rolling_max(input, output, count, window, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes the rolling median of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_median(const void* input, void* output, size_t count,
+                              size_t window, const std::string& type_id) {
+        return fossil_data_series_rolling_median(input, output, count, window, type_id.c_str());
+    }
+
+    /**
+     * @brief Computes a rolling quantile of a sequence (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param window   Size of the rolling window (must be > 0).
+     * @param q        Quantile in [0, 1].
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_quantile(const void* input, void* output, size_t count,
+                                size_t window, double q, const std::string& type_id) {
+        return fossil_data_series_rolling_quantile(input, output, count, window, q,
+                                                   type_id.c_str());
+    }
+
+    /**
+     * @brief Computes several rolling statistics in one pass (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param outputs  n_stats output arrays of count elements (pre-allocated).
+     * @param count    Number of elements in the input and in each output.
+     * @param stats    n_stats statistic names ("sum", "mean", "var", "std",
+     *                 "min", "max", "median").
+     * @param windows  n_stats window sizes (each > 0).
+     * @param n_stats  Number of features.
+     * @param ddof     Delta degrees of freedom for "var" and "std" features.
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int rolling_multi(const void* input, void* const* outputs, size_t count,
+                             const char* const* stats, const size_t* windows,
+                             size_t n_stats, size_t ddof, const std::string& type_id) {
+        return fossil_data_series_rolling_multi(input, outputs, count, stats, windows,
+                                                n_stats, ddof, type_id.c_str());
+    }
+
+    /**
+     * @brief Create an online cumsum or rolling-statistic stream (C++ wrapper).
+     *
+     * @param kind     "cumsum" or a rolling statistic name.
+     * @param window   Rolling window size (ignored for "cumsum").
+     * @param ddof     Delta degrees of freedom for "var" and "std".
+     * @param type_id  String identifier for the element type.
+     * @return         Stream handle, or nullptr on failure.
+     */
+    static void* stream_create(const std::string& kind, size_t window, size_t ddof,
+                               const std::string& type_id) {
+        void* stream = nullptr;
+        int result = fossil_data_series_stream_create(kind.c_str(), window, ddof,
+                                                      type_id.c_str(), &stream);
+        return (result == 0) ? stream : nullptr;
+    }
+
+    /**
+     * @brief Push a batch of values through a stream (C++ wrapper).
+     *
+     * @param stream  Stream handle.
+     * @param input   count values of the stream's type.
+     * @param output  Per-value results, or nullptr.
+     * @param count   Number of values.
+     * @return        0 on success, non-zero on failure.
+     */
+    static int stream_push(void* stream, const void* input, void* output, size_t count) {
+        return fossil_data_series_stream_push(stream, input, output, count);
+    }
+
+    /**
+     * @brief Read a stream's current value (C++ wrapper).
+     *
+     * @param stream  Stream handle.
+     * @param value   One element of the stream's type.
+     * @return        0 on success, non-zero on failure.
+     */
+    static int stream_value(const void* stream, void* value) {
+        return fossil_data_series_stream_value(stream, value);
+    }
+
+    /**
+     * @brief Serialize a stream's state (C++ wrapper).
+     *
+     * @param stream    Stream handle.
+     * @param buffer    Destination buffer, or nullptr to query the size.
+     * @param capacity  Size of buffer in bytes.
+     * @param size      Receives the state size in bytes.
+     * @return          0 on success, non-zero on failure.
+     */
+    static int stream_save(const void* stream, void* buffer, size_t capacity, size_t* size) {
+        return fossil_data_series_stream_save(stream, buffer, capacity, size);
+    }
+
+    /**
+     * @brief Recreate a stream from a saved state (C++ wrapper).
+     *
+     * @param buffer  Saved state.
+     * @param size    Size of the saved state in bytes.
+     * @return        Stream handle, or nullptr on failure.
+     */
+    static void* stream_load(const void* buffer, size_t size) {
+        void* stream = nullptr;
+        int result = fossil_data_series_stream_load(buffer, size, &stream);
+        return (result == 0) ? stream : nullptr;
+    }
+
+    /**
+     * @brief Free a stream (C++ wrapper).
+     *
+     * @param stream  Stream handle.
+     */
+    static void stream_free(void* stream) {
+        fossil_data_series_stream_free(stream);
+    }
+
+    /**
+     * @brief Exponentially weighted moving average (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param alpha    Smoothing factor in (0, 1].
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int ewma(const void* input, void* output, size_t count, double alpha,
+                    const std::string& type_id) {
+        return fossil_data_series_ewma(input, output, count, alpha, type_id.c_str());
+    }
+
+    /**
+     * @brief Exponentially weighted moving variance (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param alpha    Smoothing factor in (0, 1].
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int ewvar(const void* input, void* output, size_t count, double alpha,
+                     const std::string& type_id) {
+        return fossil_data_series_ewvar(input, output, count, alpha, type_id.c_str());
+    }
+
+    /**
+     * @brief Holt (double exponential) smoothing (C++ wrapper).
+     *
+     * @param input    Pointer to the input data array.
+     * @param output   Pointer to the output data array (must be pre-allocated).
+     * @param count    Number of elements in the input/output arrays.
+     * @param alpha    Level smoothing factor in (0, 1].
+     * @param beta     Trend smoothing factor in [0, 1].
+     * @param type_id  String identifier for the data type.
+     * @return         0 on success, non-zero on error.
+     */
+    static int holt(const void* input, void* output, size_t count, double alpha, double beta,
+                    const std::string& type_id) {
+        return fossil_data_series_holt(input, output, count, alpha, beta, type_id.c_str());
+    }
+
+    /**
+     * @brief Exponential smoothing of many series at once (C++ wrapper).
+     *
+     * @param input     n_series * count values.
+     * @param output    n_series * count values in the same layout.
+     * @param n_series  Number of series.
+     * @param count     Steps per series.
+     * @param method    "ewma", "ewvar" or "holt".
+     * @param alpha     Smoothing factor in (0, 1].
+     * @param beta      Trend smoothing factor ("holt" only).
+     * @param layout    "time" or "series".
+     * @param type_id   String identifier for the data type.
+     * @return          0 on success, non-zero on error.
+     */
+    static int ew_many(const void* input, void* output, size_t n_series, size_t count,
+                       const std::string& method, double alpha, double beta,
+                       const std::string& layout, const std::string& type_id) {
+        return fossil_data_series_ew_many(input, output, n_series, count, method.c_str(),
+                                          alpha, beta, layout.c_str(), type_id.c_str());
+    }
+
+    /**
+     * @brief Cumulative sum of every row of a block of series (C++ wrapper).
+     *
+     * @param input     Pointer to the input block.
+     * @param output    Pointer to the output block (must be pre-allocated).
+     * @param n_series  Number of rows.
+     * @param count     Values per row.
+     * @param stride    Elements from one row start to the next (>= count).
+     * @param type_id   String identifier for the data type.
+     * @return          0 on success, non-zero on error.
+     */
+    static int cumsum_batch(const void* input, void* output, size_t n_series, size_t count,
+                            size_t stride, const std::string& type_id) {
+        return fossil_data_series_cumsum_batch(input, output, n_series, count, stride,
+                                               type_id.c_str());
+    }
+
+    /**
+     * @brief Rolling statistic of every row of a block of series (C++ wrapper).
+     *
+     * @param input     Pointer to the input block.
+     * @param output    Pointer to the output block (must be pre-allocated).
+     * @param n_series  Number of rows.
+     * @param count     Values per row.
+     * @param stride    Elements from one row start to the next (>= count).
+     * @param stat      Rolling statistic name.
+     * @param window    Size of the rolling window (must be > 0).
+     * @param ddof      Delta degrees of freedom for "var" and "std".
+     * @param type_id   String identifier for the data type.
+     * @return          0 on success, non-zero on error.
+     */
+    static int rolling_batch(const void* input, void* output, size_t n_series, size_t count,
+                             size_t stride, const std::string& stat, size_t window, size_t ddof,
+                             const std::string& type_id) {
+        return fossil_data_series_rolling_batch(input, output, n_series, count, stride,
+                                                stat.c_str(), window, ddof, type_id.c_str());
+    }
+
+    static int resample_span(const fossil_data_series_timed_t* series, int64_t period,
+                             int64_t* origin, size_t* n_buckets) {
+        return fossil_data_series_resample_span(series, period, origin, n_buckets);
+    }
+
+    static int resample(const fossil_data_series_timed_t* series, int64_t origin, int64_t period,
+                        size_t n_buckets, const std::string& agg, const std::string& fill,
+                        int64_t* bucket_time, void* output) {
+        return fossil_data_series_resample(series, origin, period, n_buckets, agg.c_str(),
+                                           fill.c_str(), bucket_time, output);
+    }
+
+    static int asof(const int64_t* time, size_t count, const fossil_data_series_timed_t* right,
+                    int64_t tolerance, void* output, size_t* index) {
+        return fossil_data_series_asof(time, count, right, tolerance, output, index);
+    }
+
+    static int merge(const fossil_data_series_timed_t* series, size_t n_series, int64_t tolerance,
+                     int64_t* time, void* const* outputs, size_t capacity, size_t* count) {
+        return fossil_data_series_merge(series, n_series, tolerance, time, outputs, capacity, count);
+    }
+
+    static int rfft(const void* input, size_t count, double* spectrum, const std::string& type_id) {
+        return fossil_data_series_rfft(input, count, spectrum, type_id.c_str());
+    }
+
+    static int irfft(const double* spectrum, size_t count, void* output, const std::string& type_id) {
+        return fossil_data_series_irfft(spectrum, count, output, type_id.c_str());
+    }
+
+    static int convolve(const void* a, size_t count_a, const void* b, size_t count_b, void* output,
+                        const std::string& type_id) {
+        return fossil_data_series_convolve(a, count_a, b, count_b, output, type_id.c_str());
+    }
+
+    static int correlate(const void* a, size_t count_a, const void* b, size_t count_b, void* output,
+                         const std::string& type_id) {
+        return fossil_data_series_correlate(a, count_a, b, count_b, output, type_id.c_str());
+    }
+
+    static int autocorr(const void* input, size_t count, size_t max_lag, double* output,
+                        const std::string& type_id) {
+        return fossil_data_series_autocorr(input, count, max_lag, output, type_id.c_str());
+    }
+
+    static int fft_cache_clear() {
+        return fossil_data_series_fft_cache_clear();
+    }
+
+    static int diff(const void* input, void* output, size_t count, size_t order,
+                    const std::string& type_id) {
+        return fossil_data_series_diff(input, output, count, order, type_id.c_str());
+    }
+
+    static int pct_change(const void* input, double* output, size_t count, size_t periods,
+                          const std::string& type_id) {
+        return fossil_data_series_pct_change(input, output, count, periods, type_id.c_str());
+    }
+
+    static int shift(const void* input, void* output, size_t count, ptrdiff_t periods,
+                     const std::string& type_id) {
+        return fossil_data_series_shift(input, output, count, periods, type_id.c_str());
+    }
+
+    static int lag_matrix(const void* input, size_t count, const size_t* lags, size_t n_lags,
+                          void* output, const std::string& type_id) {
+        return fossil_data_series_lag_matrix(input, count, lags, n_lags, output, type_id.c_str());
+    }
 };
 
 } // namespace fossil::data
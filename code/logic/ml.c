@@ -23,11 +23,37 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/data/ml.h"
+#include "fossil/data/parallel.h"
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ML_HAVE_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__AVXVNNI__)
+#define ML_DPBUSD(acc, u8, s8) _mm256_dpbusd_avx_epi32(acc, u8, s8)
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#define ML_DPBUSD(acc, u8, s8) _mm256_dpbusd_epi32(acc, u8, s8)
+#endif
+
 /* ============================================================
    Internal model definitions
    ============================================================ */
@@ -35,70 +61,159 @@
 typedef enum {
     MODEL_LINEAR,
     MODEL_LOGISTIC,
-    MODEL_KMEANS
+    MODEL_KMEANS,
+    MODEL_DECISION_TREE,
+    MODEL_GRADIENT_BOOSTING,
+    MODEL_KNN
 } fossil_ml_model_kind_t;
 
+/*
+ * Tree node, also the on-disk layout. Trees are stored in preorder, so
+ * a split's left child is the next node and only the right one needs an
+ * index. `value` is the split threshold (x <= value goes left) or, for
+ * leaves (feature < 0), the leaf output.
+ */
+typedef struct {
+    int32_t feature;
+    uint32_t right;
+    double value;
+} ml_tree_node_t;
+
+/* Storage precision of regression weights (see fossil_data_ml_quantize). */
+typedef enum {
+    ML_PREC_F64,
+    ML_PREC_F32,
+    ML_PREC_I16,
+    ML_PREC_I8
+} ml_precision_t;
+
 typedef struct {
     fossil_ml_model_kind_t kind;
     size_t rows;
     size_t cols;
     double* weights;   /* used by regression */
+    ml_precision_t precision;
+    void* qweights;    /* regression weights when precision != F64 */
+    double qscale;     /* integer precisions: weight = qscale * q */
     double* centers;   /* used by kmeans */
+    double* center_bounds; /* kmeans: k*k, quarter squared distance between centers */
+    size_t* center_counts; /* kmeans: rows absorbed by each center */
     size_t k;          /* clusters for kmeans */
+    ml_tree_node_t* nodes; /* trees: every tree's nodes, back to back */
+    size_t n_nodes;
+    size_t* roots;     /* trees: first node of each tree */
+    size_t n_trees;
+    double* list_vectors;  /* knn: training rows grouped by list (centers are the lists) */
+    size_t* list_ids;      /* knn: original row of each stored vector */
+    size_t* list_offsets;  /* knn: k + 1 offsets into list_vectors rows */
+    double* targets;       /* knn: y in list order, NULL when trained without y */
+    size_t n_neighbors;    /* knn: neighbors averaged by predict */
+    size_t n_probe;        /* knn: lists scanned per query by default */
+    void* backing;     /* loaded file the arrays above point into, if any */
+    size_t backing_size;
+    int backing_mapped; /* backing is a private file mapping, not heap */
 } fossil_ml_model_t;
 
+static int ml_is_tree(const fossil_ml_model_t* m)
+{
+    return m->kind == MODEL_DECISION_TREE || m->kind == MODEL_GRADIENT_BOOSTING;
+}
+
 /* ============================================================
    Helpers
    ============================================================ */
 
+/*
+ * Type strings are resolved once per call; the per-element loops below
+ * switch on this tag instead of comparing strings.
+ */
+typedef enum {
+    ML_DTYPE_INVALID,
+    ML_DTYPE_I8, ML_DTYPE_I16, ML_DTYPE_I32, ML_DTYPE_I64,
+    ML_DTYPE_U8, ML_DTYPE_U16, ML_DTYPE_U32, ML_DTYPE_U64,
+    ML_DTYPE_SIZE, ML_DTYPE_F32, ML_DTYPE_F64, ML_DTYPE_BOOL
+} ml_dtype_t;
+
+static ml_dtype_t ml_dtype(const char* t)
+{
+    if (!t) return ML_DTYPE_INVALID;
+    if (!strcmp(t,"f32"))  return ML_DTYPE_F32;
+    if (!strcmp(t,"f64"))  return ML_DTYPE_F64;
+    if (!strcmp(t,"i8"))   return ML_DTYPE_I8;
+    if (!strcmp(t,"i16"))  return ML_DTYPE_I16;
+    if (!strcmp(t,"i32"))  return ML_DTYPE_I32;
+    if (!strcmp(t,"i64"))  return ML_DTYPE_I64;
+    if (!strcmp(t,"u8"))   return ML_DTYPE_U8;
+    if (!strcmp(t,"u16"))  return ML_DTYPE_U16;
+    if (!strcmp(t,"u32"))  return ML_DTYPE_U32;
+    if (!strcmp(t,"u64"))  return ML_DTYPE_U64;
+    if (!strcmp(t,"size")) return ML_DTYPE_SIZE;
+    if (!strcmp(t,"bool")) return ML_DTYPE_BOOL;
+    if (!strcmp(t,"hex") || !strcmp(t,"oct") || !strcmp(t,"bin"))
+        return ML_DTYPE_U32; // treat as uint32_t
+    return ML_DTYPE_INVALID;
+}
+
 static int is_numeric_type(const char* t)
 {
-    return t &&
-        (!strcmp(t,"i8")   || !strcmp(t,"i16")  || !strcmp(t,"i32")  || !strcmp(t,"i64") ||
-         !strcmp(t,"u8")   || !strcmp(t,"u16")  || !strcmp(t,"u32")  || !strcmp(t,"u64") ||
-         !strcmp(t,"size") ||
-         !strcmp(t,"f32")  || !strcmp(t,"f64")  ||
-         !strcmp(t,"bool") ||
-         !strcmp(t,"hex")  || !strcmp(t,"oct")  || !strcmp(t,"bin"));
-}
-
-static double read_value(const void* data, size_t i, const char* t)
-{
-    if(!strcmp(t,"f32"))   return ((const float*)data)[i];
-    if(!strcmp(t,"f64"))   return ((const double*)data)[i];
-    if(!strcmp(t,"i8"))    return ((const int8_t*)data)[i];
-    if(!strcmp(t,"i16"))   return ((const int16_t*)data)[i];
-    if(!strcmp(t,"i32"))   return ((const int32_t*)data)[i];
-    if(!strcmp(t,"i64"))   return ((const int64_t*)data)[i];
-    if(!strcmp(t,"u8"))    return ((const uint8_t*)data)[i];
-    if(!strcmp(t,"u16"))   return ((const uint16_t*)data)[i];
-    if(!strcmp(t,"u32"))   return ((const uint32_t*)data)[i];
-    if(!strcmp(t,"u64"))   return ((const uint64_t*)data)[i];
-    if(!strcmp(t,"size"))  return ((const size_t*)data)[i];
-    if(!strcmp(t,"bool"))  return ((const bool*)data)[i] ? 1.0 : 0.0;
-    if(!strcmp(t,"hex"))   return ((const uint32_t*)data)[i]; // treat as uint32_t
-    if(!strcmp(t,"oct"))   return ((const uint32_t*)data)[i]; // treat as uint32_t
-    if(!strcmp(t,"bin"))   return ((const uint32_t*)data)[i]; // treat as uint32_t
-    return 0.0;
-}
-
-static void write_value(void* data, size_t i, const char* t, double v)
-{
-    if(!strcmp(t,"f32"))   ((float*)data)[i]      = (float)v;
-    else if(!strcmp(t,"f64"))   ((double*)data)[i]     = v;
-    else if(!strcmp(t,"i8"))    ((int8_t*)data)[i]     = (int8_t)v;
-    else if(!strcmp(t,"i16"))   ((int16_t*)data)[i]    = (int16_t)v;
-    else if(!strcmp(t,"i32"))   ((int32_t*)data)[i]    = (int32_t)v;
-    else if(!strcmp(t,"i64"))   ((int64_t*)data)[i]    = (int64_t)v;
-    else if(!strcmp(t,"u8"))    ((uint8_t*)data)[i]    = (uint8_t)v;
-    else if(!strcmp(t,"u16"))   ((uint16_t*)data)[i]   = (uint16_t)v;
-    else if(!strcmp(t,"u32"))   ((uint32_t*)data)[i]   = (uint32_t)v;
-    else if(!strcmp(t,"u64"))   ((uint64_t*)data)[i]   = (uint64_t)v;
-    else if(!strcmp(t,"size"))  ((size_t*)data)[i]     = (size_t)v;
-    else if(!strcmp(t,"bool"))  ((bool*)data)[i]       = (v != 0.0);
-    else if(!strcmp(t,"hex"))   ((uint32_t*)data)[i]   = (uint32_t)v;
-    else if(!strcmp(t,"oct"))   ((uint32_t*)data)[i]   = (uint32_t)v;
-    else if(!strcmp(t,"bin"))   ((uint32_t*)data)[i]   = (uint32_t)v;
+    return ml_dtype(t) != ML_DTYPE_INVALID;
+}
+
+#define ML_LOAD_LOOP(ctype) \
+    { const ctype* p = (const ctype*)src + offset; \
+      for (size_t i = 0; i < n; i++) dst[i] = (double)p[i]; } break
+
+/* Convert n elements starting at src[offset] to f64. */
+static void ml_load(const void* src, size_t offset, size_t n, ml_dtype_t t, double* dst)
+{
+    switch (t) {
+    case ML_DTYPE_I8:   ML_LOAD_LOOP(int8_t);
+    case ML_DTYPE_I16:  ML_LOAD_LOOP(int16_t);
+    case ML_DTYPE_I32:  ML_LOAD_LOOP(int32_t);
+    case ML_DTYPE_I64:  ML_LOAD_LOOP(int64_t);
+    case ML_DTYPE_U8:   ML_LOAD_LOOP(uint8_t);
+    case ML_DTYPE_U16:  ML_LOAD_LOOP(uint16_t);
+    case ML_DTYPE_U32:  ML_LOAD_LOOP(uint32_t);
+    case ML_DTYPE_U64:  ML_LOAD_LOOP(uint64_t);
+    case ML_DTYPE_SIZE: ML_LOAD_LOOP(size_t);
+    case ML_DTYPE_F32:  ML_LOAD_LOOP(float);
+    case ML_DTYPE_F64:  memcpy(dst, (const double*)src + offset, n * sizeof(double)); break;
+    case ML_DTYPE_BOOL: {
+        const bool* p = (const bool*)src + offset;
+        for (size_t i = 0; i < n; i++) dst[i] = p[i] ? 1.0 : 0.0;
+    } break;
+    default:
+        memset(dst, 0, n * sizeof(double));
+        break;
+    }
+}
+
+#define ML_STORE_LOOP(ctype) \
+    { ctype* p = (ctype*)dst + offset; \
+      for (size_t i = 0; i < n; i++) p[i] = (ctype)src[i]; } break
+
+/* Store n f64 values into dst[offset..] as type t. */
+static void ml_store(void* dst, size_t offset, size_t n, ml_dtype_t t, const double* src)
+{
+    switch (t) {
+    case ML_DTYPE_I8:   ML_STORE_LOOP(int8_t);
+    case ML_DTYPE_I16:  ML_STORE_LOOP(int16_t);
+    case ML_DTYPE_I32:  ML_STORE_LOOP(int32_t);
+    case ML_DTYPE_I64:  ML_STORE_LOOP(int64_t);
+    case ML_DTYPE_U8:   ML_STORE_LOOP(uint8_t);
+    case ML_DTYPE_U16:  ML_STORE_LOOP(uint16_t);
+    case ML_DTYPE_U32:  ML_STORE_LOOP(uint32_t);
+    case ML_DTYPE_U64:  ML_STORE_LOOP(uint64_t);
+    case ML_DTYPE_SIZE: ML_STORE_LOOP(size_t);
+    case ML_DTYPE_F32:  ML_STORE_LOOP(float);
+    case ML_DTYPE_F64:  memcpy((double*)dst + offset, src, n * sizeof(double)); break;
+    case ML_DTYPE_BOOL: {
+        bool* p = (bool*)dst + offset;
+        for (size_t i = 0; i < n; i++) p[i] = (src[i] != 0.0);
+    } break;
+    default:
+        break;
+    }
 }
 
 /* sigmoid for logistic regression */
@@ -106,228 +221,3949 @@ static double sigmoid(double x){
     return 1.0/(1.0+exp(-x));
 }
 
-/* ============================================================
-   TRAIN
-   ============================================================ */
+/*
+ * Return `data` as a contiguous f64 array. f64 input is borrowed as-is;
+ * anything else is converted into a buffer returned through *owned,
+ * which the caller must free.
+ */
+static const double* load_f64(const void* data, size_t n, const char* t, double** owned)
+{
+    ml_dtype_t dt = ml_dtype(t);
+    *owned = NULL;
+    if (dt == ML_DTYPE_F64)
+        return (const double*)data;
 
-int fossil_data_ml_train(
-    const void* X,
-    const void* y,
-    size_t rows,
-    size_t cols,
-    const char* type_id,
-    const char* model_id,
-    void** model_handle)
+    double* buf = malloc(n * sizeof(double));
+    if (!buf) return NULL;
+    ml_load(data, 0, n, dt, buf);
+    *owned = buf;
+    return buf;
+}
+
+/*
+ * Fitters can train on a view of their rows: row i of the view is row
+ * view[i] of X and y, so cross-validation folds share one copy of the
+ * data. A NULL view is every row in order.
+ */
+static size_t ml_view_row(const size_t* view, size_t i)
 {
-    // Validate arguments
-    if (!model_handle) return -1;
-    *model_handle = NULL;
-    if (!X || !type_id || !model_id || rows == 0 || cols == 0) return -1;
-    if (!strcmp(model_id, "kmeans")) {
-        // For kmeans, y can be NULL
-    } else {
-        if (!y) return -1;
-    }
-    if (!is_numeric_type(type_id)) return -2;
+    return view ? view[i] : i;
+}
 
-    fossil_ml_model_t* m = calloc(1, sizeof(*m));
-    if (!m) return -3;
+/*
+ * Sparse rows are held as CSR with f64 values. Arrays borrow the
+ * caller's when no conversion is needed; the owned_* pointers hold
+ * whatever had to be built.
+ */
+typedef struct {
+    size_t rows, cols;
+    const size_t* indptr;    /* rows + 1 */
+    const size_t* indices;   /* column of each value */
+    const double* values;
+    size_t* owned_indptr;
+    size_t* owned_indices;
+    double* owned_values;
+} ml_csr_t;
 
-    m->rows = rows;
-    m->cols = cols;
+static double ml_sparse_dot(const double* w, const size_t* idx, const double* val, size_t nnz)
+{
+    double z = 0;
+    for (size_t p = 0; p < nnz; p++)
+        z += w[idx[p]] * val[p];
+    return z;
+}
 
-    /* ---------- LINEAR REGRESSION ---------- */
-    if (!strcmp(model_id, "linear_regression")) {
-        m->kind = MODEL_LINEAR;
-        m->weights = calloc(cols, sizeof(double));
-        if (!m->weights) { free(m); return -3; }
+/* ============================================================
+   Parallel gradient for linear / logistic regression
+   ============================================================ */
 
-        double lr = 0.001;
-        for (int iter = 0; iter < 500; iter++) {
-            for (size_t j = 0; j < cols; j++) {
-                double grad = 0;
-                for (size_t i = 0; i < rows; i++) {
-                    double pred = 0;
-                    for (size_t k = 0; k < cols; k++)
-                        pred += m->weights[k] * read_value(X, i * cols + k, type_id);
-                    double err = pred - read_value(y, i, type_id);
-                    grad += err * read_value(X, i * cols + j, type_id);
-                }
-                m->weights[j] -= lr * grad / rows;
-            }
+/*
+ * Rows are split into a fixed number of chunks that depends only on the
+ * shape of the data (see ml_grad_grain), so the chunk-ordered reduction
+ * below produces the same weights regardless of how many threads run the
+ * chunks.
+ *
+ * Several models sharing X train together: each chunk walks its rows in
+ * tiles and runs every block of models over the tile while it is still
+ * in cache, so X is streamed from memory once per iteration for as many
+ * models as the chunk gradients have room for. A model block's weights
+ * and gradients are sized to stay in L2. Each model still sees its rows
+ * in order, so a model gets the same weights whether it is trained alone
+ * or with others.
+ */
+#define ML_GRAD_MAX_CHUNKS  64
+#define ML_GRAD_MIN_GRAIN   256
+#define ML_GRAD_TILE_ROWS   64
+#define ML_GRAD_BLOCK_BYTES (128 * 1024)
+#define ML_GRAD_ACC_BUDGET  ((size_t)64 << 20)   /* per-chunk gradients */
+
+typedef struct {
+    const double* X;
+    const ml_csr_t* S;       /* sparse rows instead of X */
+    const size_t* view;      /* rows of X or S to train on; NULL = all */
+    const double* Y;         /* rows x y_cols targets */
+    size_t y_cols;
+    const size_t* y_index;   /* per model: target column; NULL = model index */
+    const double* W;         /* n_models x cols weights */
+    size_t cols;
+    size_t n_models;
+    size_t block;            /* models per cache block */
+    int logistic;
+    double* partial;         /* per chunk: n_models x cols gradients */
+} ml_grad_job_t;
+
+/* Sparse rows touch only their nonzero weights and gradient entries. */
+static void ml_grad_chunk_sparse(ml_grad_job_t* job, double* g, size_t begin, size_t end)
+{
+    const ml_csr_t* S = job->S;
+    size_t cols = job->cols;
+    for (size_t i = begin; i < end; i++) {
+        size_t r = ml_view_row(job->view, i);
+        const size_t* idx = S->indices + S->indptr[r];
+        const double* val = S->values + S->indptr[r];
+        size_t nnz = S->indptr[r + 1] - S->indptr[r];
+        const double* y = job->Y + r * job->y_cols;
+        for (size_t m = 0; m < job->n_models; m++) {
+            double z = ml_sparse_dot(job->W + m * cols, idx, val, nnz);
+            double err = (job->logistic ? sigmoid(z) : z)
+                       - y[job->y_index ? job->y_index[m] : m];
+            double* gm = g + m * cols;
+            for (size_t p = 0; p < nnz; p++)
+                gm[idx[p]] += err * val[p];
         }
     }
+}
 
-    /* ---------- LOGISTIC REGRESSION ---------- */
-    else if (!strcmp(model_id, "logistic_regression")) {
-        m->kind = MODEL_LOGISTIC;
-        m->weights = calloc(cols, sizeof(double));
-        if (!m->weights) { free(m); return -3; }
+static void ml_grad_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_grad_job_t* job = ctx;
+    size_t cols = job->cols, n_models = job->n_models;
+    double* g = job->partial + chunk * n_models * cols;
 
-        double lr = 0.01;
-        for (int iter = 0; iter < 400; iter++) {
-            for (size_t j = 0; j < cols; j++) {
-                double grad = 0;
-                for (size_t i = 0; i < rows; i++) {
+    memset(g, 0, n_models * cols * sizeof(double));
+    if (job->S) {
+        ml_grad_chunk_sparse(job, g, begin, end);
+        return;
+    }
+    for (size_t t = begin; t < end; t += ML_GRAD_TILE_ROWS) {
+        size_t t_end = t + ML_GRAD_TILE_ROWS < end ? t + ML_GRAD_TILE_ROWS : end;
+        for (size_t m0 = 0; m0 < n_models; m0 += job->block) {
+            size_t m1 = m0 + job->block < n_models ? m0 + job->block : n_models;
+            for (size_t i = t; i < t_end; i++) {
+                size_t r = ml_view_row(job->view, i);
+                const double* x = job->X + r * cols;
+                const double* y = job->Y + r * job->y_cols;
+                size_t m = m0;
+                /* four models per step: independent sums sharing each x[j] load */
+                for (; m + 4 <= m1; m += 4) {
+                    const double* w0 = job->W + m * cols;
+                    const double* w1 = w0 + cols;
+                    const double* w2 = w1 + cols;
+                    const double* w3 = w2 + cols;
+                    double z0 = 0, z1 = 0, z2 = 0, z3 = 0;
+                    for (size_t j = 0; j < cols; j++) {
+                        double xj = x[j];
+                        z0 += w0[j] * xj; z1 += w1[j] * xj;
+                        z2 += w2[j] * xj; z3 += w3[j] * xj;
+                    }
+                    double e[4] = { z0, z1, z2, z3 };
+                    for (size_t q = 0; q < 4; q++)
+                        e[q] = (job->logistic ? sigmoid(e[q]) : e[q])
+                             - y[job->y_index ? job->y_index[m + q] : m + q];
+                    double* g0 = g + m * cols;
+                    double* g1 = g0 + cols;
+                    double* g2 = g1 + cols;
+                    double* g3 = g2 + cols;
+                    for (size_t j = 0; j < cols; j++) {
+                        double xj = x[j];
+                        g0[j] += e[0] * xj; g1[j] += e[1] * xj;
+                        g2[j] += e[2] * xj; g3[j] += e[3] * xj;
+                    }
+                }
+                for (; m < m1; m++) {
+                    const double* w = job->W + m * cols;
+                    double* gm = g + m * cols;
                     double z = 0;
-                    for (size_t k = 0; k < cols; k++)
-                        z += m->weights[k] * read_value(X, i * cols + k, type_id);
-                    double p = sigmoid(z);
-                    grad += (p - read_value(y, i, type_id))
-                        * read_value(X, i * cols + j, type_id);
+                    for (size_t j = 0; j < cols; j++)
+                        z += w[j] * x[j];
+                    double err = (job->logistic ? sigmoid(z) : z)
+                               - y[job->y_index ? job->y_index[m] : m];
+                    for (size_t j = 0; j < cols; j++)
+                        gm[j] += err * x[j];
                 }
-                m->weights[j] -= lr * grad / rows;
             }
         }
     }
+}
 
-    /* ---------- KMEANS ---------- */
-    else if (!strcmp(model_id, "kmeans")) {
-        m->kind = MODEL_KMEANS;
-        m->k = 3; // default cluster count
-        m->centers = calloc(m->k * cols, sizeof(double));
-        if (!m->centers) { free(m); return -3; }
-
-        // initialize centers using first k rows
-        for (size_t c = 0; c < m->k; c++)
-            for (size_t j = 0; j < cols; j++)
-                m->centers[c * cols + j] = read_value(X, c * cols + j, type_id);
-
-        int iters = 20;
-        int* labels = malloc(rows * sizeof(int));
-        if (!labels) { free(m->centers); free(m); return -3; }
-
-        for (int it = 0; it < iters; it++) {
-            // assign
-            for (size_t i = 0; i < rows; i++) {
-                double best = 1e300;
-                int best_id = 0;
-                for (size_t c = 0; c < m->k; c++) {
-                    double d = 0;
-                    for (size_t j = 0; j < cols; j++) {
-                        double diff =
-                            read_value(X, i * cols + j, type_id) -
-                            m->centers[c * cols + j];
-                        d += diff * diff;
-                    }
-                    if (d < best) { best = d; best_id = c; }
-                }
-                labels[i] = best_id;
-            }
+/*
+ * The grain depends on the per-model gradient size only, so a model is
+ * split into the same chunks, and summed in the same order, whether it
+ * is trained alone or with others. Every chunk clears and reduces a
+ * dense gradient, so sparse rows get at most one chunk per `cols` stored
+ * values and that overhead stays within the nnz work.
+ */
+static size_t ml_grad_grain(size_t rows, size_t cols, const ml_csr_t* S)
+{
+    size_t grain = (rows + ML_GRAD_MAX_CHUNKS - 1) / ML_GRAD_MAX_CHUNKS;
+    if (grain < ML_GRAD_MIN_GRAIN) grain = ML_GRAD_MIN_GRAIN;
+    size_t max_chunks = ML_GRAD_ACC_BUDGET / (cols * sizeof(double));
+    if (S && S->indptr[S->rows] / cols < max_chunks) max_chunks = S->indptr[S->rows] / cols;
+    if (max_chunks == 0) max_chunks = 1;
+    size_t budget_grain = (rows + max_chunks - 1) / max_chunks;
+    return grain > budget_grain ? grain : budget_grain;
+}
+
+/*
+ * Full-batch gradient descent for `n_models` models at once, over dense
+ * rows X or sparse rows S, optionally through a row view. Each
+ * iteration evaluates per-chunk partial gradients in parallel and sums
+ * them in chunk order; model m minimizes its loss plus l2[m]/2 * |w|^2.
+ * When the partials of all models would exceed ML_GRAD_ACC_BUDGET, the
+ * models train in groups that fit, one full run per group.
+ */
+static int ml_fit_gradient(
+    const double* X, const ml_csr_t* S, const size_t* view,
+    const double* Y, size_t y_cols, const size_t* y_index,
+    size_t rows, size_t cols, size_t n_models,
+    int logistic, double lr, size_t iters, const double* l2, double* W)
+{
+    size_t grain = ml_grad_grain(rows, cols, S);
+    size_t chunks = fossil_data_parallel_chunks(rows, grain);
+    size_t group = ML_GRAD_ACC_BUDGET / (chunks * cols * sizeof(double));
+    if (group == 0) group = 1;
+    if (group > n_models) group = n_models;
+    double* partial = malloc(chunks * group * cols * sizeof(double));
+    double* grad = malloc(group * cols * sizeof(double));
+    if (!partial || !grad) { free(partial); free(grad); return -3; }
 
-            // recompute centers
-            memset(m->centers, 0, sizeof(double) * m->k * cols);
-            int* counts = calloc(m->k, sizeof(int));
-            if (!counts) { free(labels); free(m->centers); free(m); return -3; }
+    size_t block = ML_GRAD_BLOCK_BYTES / (2 * cols * sizeof(double));
+    for (size_t m0 = 0; m0 < n_models; m0 += group) {
+        size_t n = n_models - m0 < group ? n_models - m0 : group;
+        size_t width = n * cols;
+        // Without y_index model m reads column m, so offset Y instead
+        ml_grad_job_t job = { X, S, view, y_index ? Y : Y + m0, y_cols,
+                              y_index ? y_index + m0 : NULL, W + m0 * cols, cols, n,
+                              block ? block : 1, logistic, partial };
 
-            for (size_t i = 0; i < rows; i++) {
-                int c = labels[i];
-                counts[c]++;
-                for (size_t j = 0; j < cols; j++)
-                    m->centers[c * cols + j] +=
-                        read_value(X, i * cols + j, type_id);
-            }
+        for (size_t iter = 0; iter < iters; iter++) {
+            fossil_data_parallel_for(rows, grain, ml_grad_chunk, &job);
+
+            memcpy(grad, partial, width * sizeof(double));
+            for (size_t c = 1; c < chunks; c++)
+                for (size_t j = 0; j < width; j++)
+                    grad[j] += partial[c * width + j];
 
-            for (size_t c = 0; c < m->k; c++) {
-                if (counts[c] == 0) continue;
+            for (size_t m = 0; m < n; m++) {
+                double* w = W + (m0 + m) * cols;
+                const double* gm = grad + m * cols;
                 for (size_t j = 0; j < cols; j++)
-                    m->centers[c * cols + j] /= counts[c];
+                    w[j] -= lr * gm[j] / rows + lr * l2[m0 + m] * w[j];
             }
-            free(counts);
         }
-        free(labels);
-    }
-    else {
-        free(m);
-        return -4;
     }
 
-    *model_handle = m;
+    free(grad);
+    free(partial);
     return 0;
 }
 
 /* ============================================================
-   PREDICT
+   K-means engine
    ============================================================ */
 
-int fossil_data_ml_predict(
-    const void* X,
-    size_t rows,
-    size_t cols,
-    void* y_pred,
-    void* model_handle,
-    const char* type_id)
+#define ML_KMEANS_DEFAULT_ITERS 300
+
+/* splitmix64: small, seedable and identical on every platform */
+static uint64_t ml_rand_next(uint64_t* state)
 {
-    // Validate arguments
-    if (!model_handle || !type_id || !X || !y_pred || rows == 0 || cols == 0)
-        return -1;
-    if (!is_numeric_type(type_id))
-        return -2;
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-    fossil_ml_model_t* m = (fossil_ml_model_t*)model_handle;
+/* uniform double in [0, 1) */
+static double ml_rand_unit(uint64_t* state)
+{
+    return (double)(ml_rand_next(state) >> 11) * (1.0 / 9007199254740992.0);
+}
 
-    if (!m)
-        return -3;
+/*
+ * Squared Euclidean distance. Four independent accumulators keep the
+ * adds pipelined; the SIMD variants map them onto vector lanes.
+ */
+static double ml_sqdist(const double* a, const double* b, size_t n)
+{
+    size_t j = 0;
+    double d;
+#if defined(__AVX__)
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= n; j += 4) {
+        __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(diff, diff));
+    }
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    d = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#elif defined(ML_HAVE_SSE2)
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    for (; j + 4 <= n; j += 4) {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j));
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(a + j + 2), _mm_loadu_pd(b + j + 2));
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+    acc0 = _mm_add_pd(acc0, acc1);
+    d = _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    for (; j + 4 <= n; j += 4) {
+        float64x2_t d0 = vsubq_f64(vld1q_f64(a + j), vld1q_f64(b + j));
+        float64x2_t d1 = vsubq_f64(vld1q_f64(a + j + 2), vld1q_f64(b + j + 2));
+        acc0 = vfmaq_f64(acc0, d0, d0);
+        acc1 = vfmaq_f64(acc1, d1, d1);
+    }
+    d = vaddvq_f64(vaddq_f64(acc0, acc1));
+#else
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; j + 4 <= n; j += 4) {
+        double d0 = a[j] - b[j], d1 = a[j + 1] - b[j + 1];
+        double d2 = a[j + 2] - b[j + 2], d3 = a[j + 3] - b[j + 3];
+        s0 += d0 * d0; s1 += d1 * d1; s2 += d2 * d2; s3 += d3 * d3;
+    }
+    d = (s0 + s1) + (s2 + s3);
+#endif
+    for (; j < n; j++) {
+        double diff = a[j] - b[j];
+        d += diff * diff;
+    }
+    return d;
+}
 
-    /* linear or logistic */
-    if (m->kind == MODEL_LINEAR || m->kind == MODEL_LOGISTIC) {
-        for (size_t i = 0; i < rows; i++) {
-            double z = 0;
-            for (size_t j = 0; j < cols; j++)
-                z += m->weights[j] * read_value(X, i * cols + j, type_id);
-
-            if (m->kind == MODEL_LOGISTIC) {
-                z = sigmoid(z);
-                // For classification, output 0 or 1 (threshold 0.5)
-                if (!strcmp(type_id, "i32") || !strcmp(type_id, "i64"))
-                    write_value(y_pred, i, type_id, z >= 0.5 ? 1 : 0);
-                else
-                    write_value(y_pred, i, type_id, z);
-            } else {
-                write_value(y_pred, i, type_id, z);
-            }
+/* Dot product, same accumulator layout as ml_sqdist. */
+static double ml_dot(const double* a, const double* b, size_t n)
+{
+    size_t j = 0;
+    double d;
+#if defined(__AVX__)
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= n; j += 4)
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+    __m128d half = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    d = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#elif defined(ML_HAVE_SSE2)
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    for (; j + 4 <= n; j += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + j), _mm_loadu_pd(b + j)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + j + 2), _mm_loadu_pd(b + j + 2)));
+    }
+    acc0 = _mm_add_pd(acc0, acc1);
+    d = _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    float64x2_t acc0 = vdupq_n_f64(0.0), acc1 = vdupq_n_f64(0.0);
+    for (; j + 4 <= n; j += 4) {
+        acc0 = vfmaq_f64(acc0, vld1q_f64(a + j), vld1q_f64(b + j));
+        acc1 = vfmaq_f64(acc1, vld1q_f64(a + j + 2), vld1q_f64(b + j + 2));
+    }
+    d = vaddvq_f64(vaddq_f64(acc0, acc1));
+#else
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; j + 4 <= n; j += 4) {
+        s0 += a[j] * b[j];         s1 += a[j + 1] * b[j + 1];
+        s2 += a[j + 2] * b[j + 2]; s3 += a[j + 3] * b[j + 3];
+    }
+    d = (s0 + s1) + (s2 + s3);
+#endif
+    for (; j < n; j++)
+        d += a[j] * b[j];
+    return d;
+}
+
+/* ------------------------------------------------------------
+   Reduced-precision dot products
+   ------------------------------------------------------------ */
+
+/*
+ * Integer kernels are exact. Features and weights are widened to 16-bit
+ * lanes in registers (no conversion buffer), multiplied pairwise with
+ * madd into 32-bit sums and accumulated in 64-bit lanes. With VNNI the
+ * i8-weight kernels use dpbusd on raw bytes instead: its 32-bit lanes
+ * are folded into the int64 total every ML_QDOT_BLOCK steps, well below
+ * the int32 bound for u8 x i8 products.
+ */
+typedef int64_t (*ml_qdot_fn)(const void* w, const void* x, size_t n);
+
+#define ML_QDOT_BLOCK 4096
+
+#if defined(__AVX2__)
+#define ML_LD_S8(p)  _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(p)))
+#define ML_LD_U8(p)  _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(p)))
+#define ML_LD_S16(p) _mm256_loadu_si256((const __m256i*)(p))
+#define ML_QDOT_SIMD(WL, XL)                                                  \
+    {                                                                         \
+        __m256i acc = _mm256_setzero_si256();                                 \
+        for (; j + 16 <= n; j += 16) {                                        \
+            __m256i p = _mm256_madd_epi16(XL(x + j), WL(w + j));              \
+            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p))); \
+            acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1))); \
+        }                                                                     \
+        int64_t lane[4];                                                      \
+        _mm256_storeu_si256((__m256i*)lane, acc);                             \
+        total = lane[0] + lane[1] + lane[2] + lane[3];                        \
+    }
+#elif defined(__AVX__) || defined(ML_HAVE_SSE2)
+#define ML_LD_S8(p)  _mm_srai_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(p)), \
+                                                      _mm_loadl_epi64((const __m128i*)(p))), 8)
+#define ML_LD_U8(p)  _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(p)), _mm_setzero_si128())
+#define ML_LD_S16(p) _mm_loadu_si128((const __m128i*)(p))
+#define ML_QDOT_SIMD(WL, XL)                                                  \
+    {                                                                         \
+        __m128i acc = _mm_setzero_si128();                                    \
+        for (; j + 8 <= n; j += 8) {                                          \
+            __m128i p = _mm_madd_epi16(XL(x + j), WL(w + j));                 \
+            __m128i sign = _mm_srai_epi32(p, 31);                             \
+            acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(p, sign));            \
+            acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(p, sign));            \
+        }                                                                     \
+        int64_t lane[2];                                                      \
+        _mm_storeu_si128((__m128i*)lane, acc);                                \
+        total = lane[0] + lane[1];                                            \
+    }
+#else
+#define ML_QDOT_SIMD(WL, XL)
+#endif
+
+#define ML_QDOT_KERNEL(name, wtype, xtype, WL, XL)                            \
+    static int64_t name(const void* wp, const void* xp, size_t n)             \
+    {                                                                         \
+        const wtype* w = (const wtype*)wp;                                    \
+        const xtype* x = (const xtype*)xp;                                    \
+        int64_t total = 0;                                                    \
+        size_t j = 0;                                                         \
+        ML_QDOT_SIMD(WL, XL)                                                  \
+        for (; j < n; j++)                                                    \
+            total += (int64_t)w[j] * x[j];                                    \
+        return total;                                                         \
+    }
+
+#if defined(ML_DPBUSD)
+static int64_t ml_hsum_epi32(__m256i v)
+{
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    int32_t lane[4];
+    _mm_storeu_si128((__m128i*)lane, s);
+    return (int64_t)lane[0] + lane[1] + lane[2] + lane[3];
+}
+
+/* i8 weights against u8 features. */
+static int64_t ml_qdot_i8_u8(const void* wp, const void* xp, size_t n)
+{
+    const int8_t* w = wp;
+    const uint8_t* x = xp;
+    int64_t total = 0;
+    size_t j = 0;
+    while (j + 32 <= n) {
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t step = 0; step < ML_QDOT_BLOCK && j + 32 <= n; step++, j += 32)
+            acc = ML_DPBUSD(acc, _mm256_loadu_si256((const __m256i*)(x + j)),
+                            _mm256_loadu_si256((const __m256i*)(w + j)));
+        total += ml_hsum_epi32(acc);
+    }
+    for (; j < n; j++)
+        total += (int64_t)w[j] * x[j];
+    return total;
+}
+
+/*
+ * i8 weights against i8 features: dpbusd needs unsigned features, so
+ * flip the sign bit (x + 128) and subtract 128 * sum(w), which a second
+ * dpbusd against a vector of ones accumulates alongside.
+ */
+static int64_t ml_qdot_i8_s8(const void* wp, const void* xp, size_t n)
+{
+    const int8_t* w = wp;
+    const int8_t* x = xp;
+    const __m256i bias = _mm256_set1_epi8((char)0x80);
+    const __m256i ones = _mm256_set1_epi8(1);
+    int64_t total = 0;
+    size_t j = 0;
+    while (j + 32 <= n) {
+        __m256i acc = _mm256_setzero_si256(), wsum = _mm256_setzero_si256();
+        for (size_t step = 0; step < ML_QDOT_BLOCK && j + 32 <= n; step++, j += 32) {
+            __m256i wv = _mm256_loadu_si256((const __m256i*)(w + j));
+            __m256i xv = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(x + j)), bias);
+            acc = ML_DPBUSD(acc, xv, wv);
+            wsum = ML_DPBUSD(wsum, ones, wv);
         }
+        total += ml_hsum_epi32(acc) - 128 * ml_hsum_epi32(wsum);
     }
-    /* kmeans: output cluster index as int */
-    else if (m->kind == MODEL_KMEANS) {
-        for (size_t i = 0; i < rows; i++) {
-            double best = 1e300;
-            int best_id = 0;
-            for (size_t c = 0; c < m->k; c++) {
-                double d = 0;
-                for (size_t j = 0; j < cols; j++) {
-                    double diff =
-                        read_value(X, i * cols + j, type_id) -
-                        m->centers[c * cols + j];
-                    d += diff * diff;
-                }
-                if (d < best) { best = d; best_id = c; }
+    for (; j < n; j++)
+        total += (int64_t)w[j] * x[j];
+    return total;
+}
+#else
+ML_QDOT_KERNEL(ml_qdot_i8_u8, int8_t, uint8_t, ML_LD_S8, ML_LD_U8)
+ML_QDOT_KERNEL(ml_qdot_i8_s8, int8_t, int8_t, ML_LD_S8, ML_LD_S8)
+#endif
+ML_QDOT_KERNEL(ml_qdot_i8_s16, int8_t, int16_t, ML_LD_S8, ML_LD_S16)
+ML_QDOT_KERNEL(ml_qdot_i16_u8, int16_t, uint8_t, ML_LD_S16, ML_LD_U8)
+ML_QDOT_KERNEL(ml_qdot_i16_s8, int16_t, int8_t, ML_LD_S16, ML_LD_S8)
+ML_QDOT_KERNEL(ml_qdot_i16_s16, int16_t, int16_t, ML_LD_S16, ML_LD_S16)
+
+/* f32 weights against f32 features, lanes reduced in f64. */
+static double ml_dot_f32(const float* w, const float* x, size_t n)
+{
+    size_t j = 0;
+    double d = 0;
+#if defined(__AVX__)
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    for (; j + 16 <= n; j += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(w + j), _mm256_loadu_ps(x + j)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(w + j + 8), _mm256_loadu_ps(x + j + 8)));
+    }
+    float lane[8];
+    _mm256_storeu_ps(lane, _mm256_add_ps(acc0, acc1));
+    for (int l = 0; l < 8; l++) d += lane[l];
+#elif defined(ML_HAVE_SSE2)
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    for (; j + 8 <= n; j += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(w + j), _mm_loadu_ps(x + j)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(w + j + 4), _mm_loadu_ps(x + j + 4)));
+    }
+    float lane[4];
+    _mm_storeu_ps(lane, _mm_add_ps(acc0, acc1));
+    for (int l = 0; l < 4; l++) d += lane[l];
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    for (; j + 8 <= n; j += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(w + j), vld1q_f32(x + j));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(w + j + 4), vld1q_f32(x + j + 4));
+    }
+    d = vaddvq_f32(vaddq_f32(acc0, acc1));
+#endif
+    for (; j < n; j++)
+        d += (double)w[j] * x[j];
+    return d;
+}
+
+static size_t ml_nearest_center(const double* x, const double* centers, size_t k, size_t cols)
+{
+    double best = ml_sqdist(x, centers, cols);
+    size_t best_id = 0;
+    for (size_t c = 1; c < k; c++) {
+        double d = ml_sqdist(x, centers + c * cols, cols);
+        if (d < best) { best = d; best_id = c; }
+    }
+    return best_id;
+}
+
+/*
+ * Nearest center using the model's center_bounds table: by the triangle
+ * inequality a center c cannot beat the current best b when
+ * |x - b| <= |b - c| / 2, so its distance is never evaluated.
+ */
+static size_t ml_nearest_center_pruned(const double* x, const fossil_ml_model_t* m)
+{
+    size_t k = m->k, cols = m->cols;
+    size_t best_id = 0;
+    double best = ml_sqdist(x, m->centers, cols);
+    for (size_t c = 1; c < k; c++) {
+        if (best <= m->center_bounds[best_id * k + c]) continue;
+        double d = ml_sqdist(x, m->centers + c * cols, cols);
+        if (d < best) { best = d; best_id = c; }
+    }
+    return best_id;
+}
+
+/* Fill center_bounds after the centers of a kmeans model change. */
+static int ml_kmeans_finalize(fossil_ml_model_t* m)
+{
+    size_t k = m->k, cols = m->cols;
+    if (!m->center_bounds) {
+        m->center_bounds = malloc(k * k * sizeof(double));
+        if (!m->center_bounds) return -3;
+    }
+    for (size_t a = 0; a < k; a++) {
+        m->center_bounds[a * k + a] = 0;
+        for (size_t b = a + 1; b < k; b++) {
+            double q = 0.25 * ml_sqdist(m->centers + a * cols, m->centers + b * cols, cols);
+            m->center_bounds[a * k + b] = q;
+            m->center_bounds[b * k + a] = q;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   Parallel layout
+
+   Rows are split into a fixed number of chunks that depends only on the
+   problem shape. Every chunk owns its own accumulator block, padded to a
+   cache line so neighbouring chunks never share one, and blocks are
+   merged in chunk order so results do not depend on the thread count.
+   ------------------------------------------------------------ */
+
+#define ML_KMEANS_MAX_CHUNKS   64
+#define ML_KMEANS_MIN_GRAIN    1024
+#define ML_KMEANS_ACC_BUDGET   ((size_t)64 << 20)   /* bytes for all chunk accumulators */
+#define ML_CACHE_LINE          64
+
+static size_t ml_kmeans_grain(size_t rows, size_t acc_bytes)
+{
+    size_t max_chunks = ML_KMEANS_MAX_CHUNKS;
+    if (acc_bytes > 0 && ML_KMEANS_ACC_BUDGET / acc_bytes < max_chunks)
+        max_chunks = ML_KMEANS_ACC_BUDGET / acc_bytes;
+    if (max_chunks == 0) max_chunks = 1;
+    size_t grain = (rows + max_chunks - 1) / max_chunks;
+    return grain < ML_KMEANS_MIN_GRAIN ? ML_KMEANS_MIN_GRAIN : grain;
+}
+
+static size_t ml_align_up(size_t n, size_t a)
+{
+    return (n + a - 1) / a * a;
+}
+
+/* Round p up to a cache line; the block needs ML_CACHE_LINE bytes of slack. */
+static void* ml_align_ptr(void* p)
+{
+    return (void*)(((uintptr_t)p + ML_CACHE_LINE - 1) & ~(uintptr_t)(ML_CACHE_LINE - 1));
+}
+
+/* ------------------------------------------------------------
+   k-means++ seeding
+   ------------------------------------------------------------ */
+
+typedef struct {
+    const double* X;
+    size_t cols;
+    const double* center;  /* newest center */
+    double* mind;          /* squared distance to the nearest center so far */
+    double* totals;        /* per-chunk sum of mind */
+    int first;
+} ml_seed_job_t;
+
+static void ml_seed_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_seed_job_t* job = ctx;
+    double total = 0;
+    for (size_t i = begin; i < end; i++) {
+        double d = ml_sqdist(job->X + i * job->cols, job->center, job->cols);
+        if (job->first || d < job->mind[i]) job->mind[i] = d;
+        total += job->mind[i];
+    }
+    job->totals[chunk] = total;
+}
+
+/*
+ * k-means++ seeding: the first center is a uniformly chosen row, every
+ * further center is drawn with probability proportional to its squared
+ * distance from the nearest center chosen so far. Distance updates run
+ * in parallel; the draw walks the per-chunk totals, then one chunk.
+ */
+static int ml_kmeans_seed_pp(
+    const double* X, size_t rows, size_t cols, size_t k,
+    uint64_t seed, double* centers)
+{
+    size_t grain = ml_kmeans_grain(rows, 0);
+    size_t chunks = fossil_data_parallel_chunks(rows, grain);
+    double* mind = malloc(rows * sizeof(double));
+    double* totals = malloc(chunks * sizeof(double));
+    if (!mind || !totals) { free(mind); free(totals); return -3; }
+
+    uint64_t state = seed;
+    size_t first = (size_t)(ml_rand_unit(&state) * rows);
+    memcpy(centers, X + first * cols, cols * sizeof(double));
+
+    ml_seed_job_t job = { X, cols, centers, mind, totals, 1 };
+    fossil_data_parallel_for(rows, grain, ml_seed_chunk, &job);
+    job.first = 0;
+
+    for (size_t c = 1; c < k; c++) {
+        double total = 0;
+        for (size_t ch = 0; ch < chunks; ch++)
+            total += totals[ch];
+
+        size_t pick = rows - 1;
+        if (total > 0) {
+            double r = ml_rand_unit(&state) * total;
+            size_t ch = 0;
+            while (ch + 1 < chunks && r >= totals[ch]) r -= totals[ch++];
+            size_t end = (ch + 1) * grain < rows ? (ch + 1) * grain : rows;
+            for (size_t i = ch * grain; i < end; i++) {
+                r -= mind[i];
+                if (r < 0) { pick = i; break; }
+                pick = i;
             }
-            // Always write as int for kmeans
-            write_value(y_pred, i, "i32", best_id);
+        } else {
+            /* every row coincides with a center already */
+            pick = (size_t)(ml_rand_unit(&state) * rows);
         }
+
+        double* center = centers + c * cols;
+        memcpy(center, X + pick * cols, cols * sizeof(double));
+        job.center = center;
+        fossil_data_parallel_for(rows, grain, ml_seed_chunk, &job);
     }
-    else return -4;
 
+    free(totals);
+    free(mind);
     return 0;
 }
 
-/* ============================================================
-   FREE
-   ============================================================ */
+static int ml_kmeans_seed(
+    const double* X, size_t rows, size_t cols,
+    const fossil_data_ml_options_t* opts, double* centers)
+{
+    if (!opts->init || !strcmp(opts->init, "kmeans++"))
+        return ml_kmeans_seed_pp(X, rows, cols, opts->k, opts->seed, centers);
+    if (!strcmp(opts->init, "first")) {
+        memcpy(centers, X, opts->k * cols * sizeof(double));
+        return 0;
+    }
+    return -1;
+}
 
-int fossil_data_ml_free_model(void* model_handle)
+/* ------------------------------------------------------------
+   Assignment strategies
+   ------------------------------------------------------------ */
+
+/*
+ * Elkan keeps a rows*k table of lower bounds, which only pays off when
+ * distances are expensive; "auto" uses Hamerly for small k, few columns,
+ * or when the table would not fit this budget.
+ */
+#define ML_ELKAN_MIN_K       20
+#define ML_ELKAN_MIN_COLS    16
+#define ML_ELKAN_MAX_BOUNDS  ((size_t)1 << 25)
+
+enum { ML_KMEANS_LLOYD, ML_KMEANS_HAMERLY, ML_KMEANS_ELKAN };
+
+typedef struct {
+    const double* X;
+    size_t rows, cols, k;
+    int algo;
+    int first;           /* first assignment pass: bounds not set yet */
+    double* centers;
+    size_t* labels;
+    double* upper;       /* hamerly/elkan: distance bound to own center */
+    double* lower;       /* hamerly: rows, elkan: rows*k */
+    double* cc;          /* elkan: k*k center distances */
+    double* half_min;    /* half distance to the closest other center */
+    double* moved;       /* per-center movement of the last update */
+    unsigned char* stale;/* elkan: upper bound not tight */
+
+    /* per-chunk accumulators, acc_stride bytes apart */
+    unsigned char* acc;
+    size_t acc_stride;
+    size_t* changed;     /* per-chunk count of relabelled rows */
+    size_t grain;
+    size_t chunks;
+} ml_kmeans_state_t;
+
+/* Accumulator block of a chunk: k*cols sums followed by k counts. */
+static double* ml_kmeans_acc_sums(const ml_kmeans_state_t* st, size_t chunk)
 {
-    if(!model_handle)
-        return 0; /* treat null as already freed, not an error */
+    return (double*)(st->acc + chunk * st->acc_stride);
+}
 
-    fossil_ml_model_t* m = model_handle;
+static size_t* ml_kmeans_acc_counts(const ml_kmeans_state_t* st, size_t chunk)
+{
+    return (size_t*)(ml_kmeans_acc_sums(st, chunk) + st->k * st->cols);
+}
+
+static void ml_kmeans_center_gaps(ml_kmeans_state_t* st)
+{
+    size_t k = st->k, cols = st->cols;
+    for (size_t a = 0; a < k; a++) st->half_min[a] = HUGE_VAL;
+    for (size_t a = 0; a < k; a++) {
+        for (size_t b = a + 1; b < k; b++) {
+            double d = sqrt(ml_sqdist(st->centers + a * cols, st->centers + b * cols, cols));
+            if (st->cc) { st->cc[a * k + b] = d; st->cc[b * k + a] = d; }
+            if (0.5 * d < st->half_min[a]) st->half_min[a] = 0.5 * d;
+            if (0.5 * d < st->half_min[b]) st->half_min[b] = 0.5 * d;
+        }
+    }
+}
+
+/* Closest and second closest center distance of row i, by full scan. */
+static size_t ml_kmeans_scan2(const ml_kmeans_state_t* st, size_t i, double* d1, double* d2)
+{
+    const double* x = st->X + i * st->cols;
+    size_t best = 0;
+    double b1 = HUGE_VAL, b2 = HUGE_VAL;
+    for (size_t c = 0; c < st->k; c++) {
+        double d = ml_sqdist(x, st->centers + c * st->cols, st->cols);
+        if (d < b1) { b2 = b1; b1 = d; best = c; }
+        else if (d < b2) b2 = d;
+    }
+    *d1 = sqrt(b1);
+    *d2 = sqrt(b2);
+    return best;
+}
+
+/* Lloyd: full scan of every row. Returns the new label of row i. */
+static size_t ml_kmeans_row_lloyd(ml_kmeans_state_t* st, size_t i)
+{
+    return ml_nearest_center(st->X + i * st->cols, st->centers, st->k, st->cols);
+}
+
+/* Hamerly: one upper and one lower bound per row. */
+static size_t ml_kmeans_row_hamerly(ml_kmeans_state_t* st, size_t i)
+{
+    size_t cols = st->cols;
+    if (!st->first) {
+        size_t a = st->labels[i];
+        double bound = st->half_min[a] > st->lower[i] ? st->half_min[a] : st->lower[i];
+        if (st->upper[i] <= bound) return a;
+        st->upper[i] = sqrt(ml_sqdist(st->X + i * cols, st->centers + a * cols, cols));
+        if (st->upper[i] <= bound) return a;
+    }
+    double d1, d2;
+    size_t c = ml_kmeans_scan2(st, i, &d1, &d2);
+    st->upper[i] = d1;
+    st->lower[i] = d2;
+    return c;
+}
+
+/* Elkan: one lower bound per row and center, plus center-center distances. */
+static size_t ml_kmeans_row_elkan(ml_kmeans_state_t* st, size_t i)
+{
+    size_t k = st->k, cols = st->cols;
+    const double* x = st->X + i * cols;
+    double* lo = st->lower + i * k;
+
+    if (st->first) {
+        size_t best = 0;
+        double u = HUGE_VAL;
+        for (size_t c = 0; c < k; c++) {
+            /* skip centers that cannot win against the running best */
+            if (c > 0 && st->cc[best * k + c] >= 2.0 * u) { lo[c] = 0; continue; }
+            lo[c] = sqrt(ml_sqdist(x, st->centers + c * cols, cols));
+            if (lo[c] < u) { u = lo[c]; best = c; }
+        }
+        st->upper[i] = u;
+        st->stale[i] = 0;
+        return best;
+    }
 
-    if (m->weights)
+    size_t a = st->labels[i];
+    double u = st->upper[i];
+    if (u <= st->half_min[a]) return a;
+
+    for (size_t c = 0; c < k; c++) {
+        if (c == a || u <= lo[c] || u <= 0.5 * st->cc[a * k + c]) continue;
+        if (st->stale[i]) {
+            u = sqrt(ml_sqdist(x, st->centers + a * cols, cols));
+            lo[a] = u;
+            st->stale[i] = 0;
+            if (u <= lo[c] || u <= 0.5 * st->cc[a * k + c]) continue;
+        }
+        double d = sqrt(ml_sqdist(x, st->centers + c * cols, cols));
+        lo[c] = d;
+        if (d < u) { u = d; a = c; }
+    }
+    st->upper[i] = u;
+    return a;
+}
+
+/*
+ * Assignment pass fused with the accumulation for the next update, so
+ * every iteration reads X once.
+ */
+static void ml_kmeans_assign_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_kmeans_state_t* st = ctx;
+    size_t k = st->k, cols = st->cols;
+    double* sums = ml_kmeans_acc_sums(st, chunk);
+    size_t* counts = ml_kmeans_acc_counts(st, chunk);
+    size_t changed = 0;
+
+    memset(sums, 0, k * cols * sizeof(double));
+    memset(counts, 0, k * sizeof(size_t));
+    for (size_t i = begin; i < end; i++) {
+        size_t c =
+            st->algo == ML_KMEANS_ELKAN   ? ml_kmeans_row_elkan(st, i) :
+            st->algo == ML_KMEANS_HAMERLY ? ml_kmeans_row_hamerly(st, i) :
+                                            ml_kmeans_row_lloyd(st, i);
+        if (st->first || st->labels[i] != c) { st->labels[i] = c; changed++; }
+
+        const double* x = st->X + i * cols;
+        double* sum = sums + c * cols;
+        counts[c]++;
+        for (size_t j = 0; j < cols; j++)
+            sum[j] += x[j];
+    }
+    st->changed[chunk] = changed;
+}
+
+/* Move the bounds of every row by the movement of the centers. */
+static void ml_kmeans_shift_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_kmeans_state_t* st = ctx;
+    size_t k = st->k;
+    (void)chunk;
+
+    if (st->algo == ML_KMEANS_HAMERLY) {
+        size_t r = 0;
+        double p1 = 0, p2 = 0;
+        for (size_t c = 0; c < k; c++) {
+            if (st->moved[c] > p1) { p2 = p1; p1 = st->moved[c]; r = c; }
+            else if (st->moved[c] > p2) p2 = st->moved[c];
+        }
+        for (size_t i = begin; i < end; i++) {
+            size_t a = st->labels[i];
+            st->upper[i] += st->moved[a];
+            st->lower[i] -= (a == r) ? p2 : p1;
+        }
+    } else {
+        for (size_t i = begin; i < end; i++) {
+            double* lo = st->lower + i * k;
+            for (size_t c = 0; c < k; c++) {
+                double v = lo[c] - st->moved[c];
+                lo[c] = v > 0 ? v : 0;
+            }
+            st->upper[i] += st->moved[st->labels[i]];
+            st->stale[i] = 1;
+        }
+    }
+}
+
+static int ml_kmeans_algorithm(const char* name, size_t rows, size_t cols, size_t k)
+{
+    if (!name || !strcmp(name, "auto")) {
+        if (k < ML_ELKAN_MIN_K || cols <= ML_ELKAN_MIN_COLS) return ML_KMEANS_HAMERLY;
+        return rows <= ML_ELKAN_MAX_BOUNDS / k ? ML_KMEANS_ELKAN : ML_KMEANS_HAMERLY;
+    }
+    if (!strcmp(name, "lloyd"))   return ML_KMEANS_LLOYD;
+    if (!strcmp(name, "hamerly")) return ML_KMEANS_HAMERLY;
+    if (!strcmp(name, "elkan"))   return ML_KMEANS_ELKAN;
+    return -1;
+}
+
+/*
+ * Merge the chunk accumulators in chunk order and recompute centers.
+ * Writes each center's movement to moved[] and the merged counts to
+ * counts[], and returns the largest squared movement. A cluster that
+ * lost all of its rows keeps its previous center.
+ */
+static double ml_kmeans_update(ml_kmeans_state_t* st, double* sums, size_t* counts)
+{
+    size_t k = st->k, cols = st->cols;
+    memcpy(sums, ml_kmeans_acc_sums(st, 0), k * cols * sizeof(double));
+    memcpy(counts, ml_kmeans_acc_counts(st, 0), k * sizeof(size_t));
+    for (size_t ch = 1; ch < st->chunks; ch++) {
+        const double* s = ml_kmeans_acc_sums(st, ch);
+        const size_t* n = ml_kmeans_acc_counts(st, ch);
+        for (size_t j = 0; j < k * cols; j++) sums[j] += s[j];
+        for (size_t c = 0; c < k; c++) counts[c] += n[c];
+    }
+
+    double shift = 0;
+    for (size_t c = 0; c < k; c++) {
+        st->moved[c] = 0;
+        if (counts[c] == 0) continue;
+        double* center = st->centers + c * cols;
+        double moved = 0;
+        for (size_t j = 0; j < cols; j++) {
+            double v = sums[c * cols + j] / (double)counts[c];
+            double diff = v - center[j];
+            moved += diff * diff;
+            center[j] = v;
+        }
+        st->moved[c] = sqrt(moved);
+        if (moved > shift) shift = moved;
+    }
+    return shift;
+}
+
+/*
+ * Lloyd iterations with an optional bounds-based assignment step, run
+ * over row chunks on the worker pool. Stops after max_iter rounds, when
+ * no row changes cluster, or when no center moves further than tol.
+ */
+static int ml_fit_kmeans(
+    const double* X, size_t rows, size_t cols,
+    const fossil_data_ml_options_t* opts, fossil_ml_model_t* m)
+{
+    size_t k = m->k;
+    size_t max_iter = opts->max_iter ? opts->max_iter : ML_KMEANS_DEFAULT_ITERS;
+    int algo = ml_kmeans_algorithm(opts->algorithm, rows, cols, k);
+    if (algo < 0) return -1;
+
+    int rc = ml_kmeans_seed(X, rows, cols, opts, m->centers);
+    if (rc != 0) return rc;
+
+    ml_kmeans_state_t st;
+    memset(&st, 0, sizeof(st));
+    st.X = X; st.rows = rows; st.cols = cols; st.k = k;
+    st.algo = algo;
+    st.centers = m->centers;
+    st.acc_stride = ml_align_up(k * cols * sizeof(double) + k * sizeof(size_t), ML_CACHE_LINE);
+    st.grain = ml_kmeans_grain(rows, st.acc_stride);
+    st.chunks = fossil_data_parallel_chunks(rows, st.grain);
+
+    void* acc_block = malloc(st.chunks * st.acc_stride + ML_CACHE_LINE);
+    st.acc = acc_block ? ml_align_ptr(acc_block) : NULL;
+    st.changed = malloc(st.chunks * sizeof(size_t));
+    st.labels = malloc(rows * sizeof(size_t));
+    st.moved = malloc(k * sizeof(double));
+    st.half_min = malloc(k * sizeof(double));
+    size_t* counts = m->center_counts;
+    double* sums = malloc(k * cols * sizeof(double));
+    int ok = st.acc && st.changed && st.labels && st.moved && st.half_min && sums;
+    if (ok && algo != ML_KMEANS_LLOYD) {
+        st.upper = malloc(rows * sizeof(double));
+        st.lower = malloc(rows * (algo == ML_KMEANS_ELKAN ? k : 1) * sizeof(double));
+        ok = st.upper && st.lower;
+    }
+    if (ok && algo == ML_KMEANS_ELKAN) {
+        st.cc = malloc(k * k * sizeof(double));
+        st.stale = malloc(rows);
+        ok = st.cc && st.stale;
+    }
+
+    rc = ok ? 0 : -3;
+    double tol2 = opts->tol * opts->tol;
+    for (size_t it = 0; ok && it < max_iter; it++) {
+        st.first = (it == 0);
+        if (algo != ML_KMEANS_LLOYD)
+            ml_kmeans_center_gaps(&st);
+        fossil_data_parallel_for(rows, st.grain, ml_kmeans_assign_chunk, &st);
+
+        size_t changed = 0;
+        for (size_t ch = 0; ch < st.chunks; ch++)
+            changed += st.changed[ch];
+        if (changed == 0) break;
+
+        double shift = ml_kmeans_update(&st, sums, counts);
+        if (algo != ML_KMEANS_LLOYD)
+            fossil_data_parallel_for(rows, st.grain, ml_kmeans_shift_chunk, &st);
+        if (shift <= tol2) break;
+    }
+
+    free(sums);
+    free(st.stale);
+    free(st.cc);
+    free(st.lower);
+    free(st.upper);
+    free(st.half_min);
+    free(st.moved);
+    free(st.labels);
+    free(st.changed);
+    free(acc_block);
+    if (rc == 0) rc = ml_kmeans_finalize(m);
+    return rc;
+}
+
+/* ------------------------------------------------------------
+   Mini-batch / streaming k-means
+   ------------------------------------------------------------ */
+
+#define ML_MINIBATCH_DEFAULT_ITERS 100
+
+/*
+ * One mini-batch step (Sculley, 2010): assign the whole batch against
+ * the current centers, then move each center towards its rows with a
+ * per-center learning rate of 1 / rows absorbed so far. `labels` must
+ * hold n entries. Returns the largest squared center movement.
+ */
+static double ml_kmeans_minibatch_step(
+    fossil_ml_model_t* m, const double* batch, size_t n, size_t* labels)
+{
+    size_t k = m->k, cols = m->cols;
+    for (size_t i = 0; i < n; i++)
+        labels[i] = ml_nearest_center(batch + i * cols, m->centers, k, cols);
+
+    double shift = 0;
+    for (size_t i = 0; i < n; i++) {
+        size_t c = labels[i];
+        double* center = m->centers + c * cols;
+        const double* x = batch + i * cols;
+        double eta = 1.0 / (double)++m->center_counts[c];
+        double moved = 0;
+        for (size_t j = 0; j < cols; j++) {
+            double step = eta * (x[j] - center[j]);
+            center[j] += step;
+            moved += step * step;
+        }
+        if (moved > shift) shift = moved;
+    }
+    return shift;
+}
+
+/* Copy row i of X into out as f64. */
+static void ml_gather_row(const void* X, size_t i, size_t cols, ml_dtype_t t, double* out)
+{
+    ml_load(X, i * cols, cols, t, out);
+}
+
+/*
+ * Mini-batch training: seeds on a random sample of rows and then runs
+ * max_iter steps over random batches, so only batch-sized buffers are
+ * ever converted to f64, however large X is.
+ */
+static int ml_fit_kmeans_minibatch(
+    const void* X, const char* type_id, size_t rows, size_t cols,
+    const fossil_data_ml_options_t* opts, fossil_ml_model_t* m)
+{
+    size_t k = m->k, batch = opts->batch_size;
+    size_t max_iter = opts->max_iter ? opts->max_iter : ML_MINIBATCH_DEFAULT_ITERS;
+    /* min(max(3 * batch, k), rows), without forming 3 * batch past rows */
+    size_t init_n = batch <= rows / 3 ? 3 * batch : rows;
+    if (init_n < k) init_n = k;
+    if (init_n > rows) init_n = rows;
+
+    size_t buf_rows = init_n > batch ? init_n : batch;
+    if (cols > SIZE_MAX / sizeof(double) / buf_rows) return -3;
+    double* buf = malloc(buf_rows * cols * sizeof(double));
+    size_t* labels = malloc(batch * sizeof(size_t));
+    if (!buf || !labels) { free(buf); free(labels); return -3; }
+
+    ml_dtype_t dt = ml_dtype(type_id);
+    uint64_t state = opts->seed ^ 0xA5A5A5A5A5A5A5A5ULL;
+    int first = opts->init && !strcmp(opts->init, "first");
+    for (size_t i = 0; i < init_n; i++) {
+        size_t r = first ? i : (size_t)(ml_rand_unit(&state) * rows);
+        ml_gather_row(X, r, cols, dt, buf + i * cols);
+    }
+    int rc = ml_kmeans_seed(buf, init_n, cols, opts, m->centers);
+
+    double tol2 = opts->tol * opts->tol;
+    for (size_t it = 0; rc == 0 && it < max_iter; it++) {
+        for (size_t i = 0; i < batch; i++) {
+            size_t r = (size_t)(ml_rand_unit(&state) * rows);
+            ml_gather_row(X, r, cols, dt, buf + i * cols);
+        }
+        if (ml_kmeans_minibatch_step(m, buf, batch, labels) <= tol2 && it > 0)
+            break;
+    }
+
+    free(labels);
+    free(buf);
+    if (rc == 0) rc = ml_kmeans_finalize(m);
+    return rc;
+}
+
+/* Allocate an untrained kmeans model with k zeroed centers. */
+static fossil_ml_model_t* ml_kmeans_alloc(size_t k, size_t cols)
+{
+    fossil_ml_model_t* m = calloc(1, sizeof(*m));
+    if (!m) return NULL;
+    m->kind = MODEL_KMEANS;
+    m->k = k;
+    m->cols = cols;
+    m->centers = calloc(k * cols, sizeof(double));
+    m->center_counts = calloc(k, sizeof(size_t));
+    if (!m->centers || !m->center_counts) {
+        fossil_data_ml_free_model(m);
+        return NULL;
+    }
+    return m;
+}
+
+/* ============================================================
+   Coordinate descent for penalized linear regression
+   ============================================================ */
+
+#define ML_CD_DEFAULT_PASSES 1000
+
+/*
+ * Minimizes  1/(2n) |y - Xw|^2 + l1 |w|_1 + l2/2 |w|^2  one weight at a
+ * time. Columns are copied out once so each update streams a contiguous
+ * column, and the residual r = y - Xw is adjusted in place after every
+ * change, so an update costs O(rows) rather than a full prediction. The
+ * residual and weights survive between fits, which is what makes warm
+ * starts along a penalty path cheap.
+ */
+typedef struct {
+    size_t rows, cols;
+    double* Xt;      /* cols x rows, column-major copy of X */
+    double* sq;      /* mean of x_j^2 per column */
+    double* r;       /* residual for the current weights */
+    unsigned char* active;
+} ml_cd_t;
+
+static void ml_cd_free(ml_cd_t* cd)
+{
+    free(cd->Xt);
+    free(cd->sq);
+    free(cd->r);
+    free(cd->active);
+}
+
+/* Set up for weights w = 0, so the residual starts as y. */
+static int ml_cd_init(ml_cd_t* cd, const double* X, const double* y, const size_t* view,
+                      size_t rows, size_t cols)
+{
+    cd->rows = rows;
+    cd->cols = cols;
+    cd->Xt = malloc(rows * cols * sizeof(double));
+    cd->sq = malloc(cols * sizeof(double));
+    cd->r = malloc(rows * sizeof(double));
+    cd->active = calloc(cols, 1);
+    if (!cd->Xt || !cd->sq || !cd->r || !cd->active) { ml_cd_free(cd); return -3; }
+
+    enum { TILE = 32 };
+    for (size_t i0 = 0; i0 < rows; i0 += TILE) {
+        size_t i1 = i0 + TILE < rows ? i0 + TILE : rows;
+        for (size_t j0 = 0; j0 < cols; j0 += TILE) {
+            size_t j1 = j0 + TILE < cols ? j0 + TILE : cols;
+            for (size_t i = i0; i < i1; i++) {
+                const double* x = X + ml_view_row(view, i) * cols;
+                for (size_t j = j0; j < j1; j++)
+                    cd->Xt[j * rows + i] = x[j];
+            }
+        }
+    }
+    for (size_t j = 0; j < cols; j++) {
+        const double* xj = cd->Xt + j * rows;
+        cd->sq[j] = ml_dot(xj, xj, rows) / (double)rows;
+    }
+    for (size_t i = 0; i < rows; i++)
+        cd->r[i] = y[ml_view_row(view, i)];
+    return 0;
+}
+
+static double ml_soft_threshold(double z, double t)
+{
+    return z > t ? z - t : (z < -t ? z + t : 0.0);
+}
+
+/* One coordinate update; returns the change it made to the fitted values (RMS). */
+static double ml_cd_step(ml_cd_t* cd, double* w, size_t j, double l1, double l2)
+{
+    size_t rows = cd->rows;
+    const double* xj = cd->Xt + j * rows;
+    double denom = cd->sq[j] + l2;
+    if (denom <= 0) return 0;
+
+    double rho = ml_dot(xj, cd->r, rows) / (double)rows + cd->sq[j] * w[j];
+    double next = ml_soft_threshold(rho, l1) / denom;
+    double delta = next - w[j];
+    if (delta == 0) return 0;
+    for (size_t i = 0; i < rows; i++)
+        cd->r[i] -= delta * xj[i];
+    w[j] = next;
+    return fabs(delta) * sqrt(cd->sq[j]);
+}
+
+/*
+ * Cyclic passes until no update moves the fit by more than tol. After
+ * each full pass only the nonzero weights are revisited until they
+ * settle; a final full pass then confirms no zero weight wants to enter.
+ */
+static void ml_fit_cd(ml_cd_t* cd, double* w, double l1, double l2, double tol, size_t max_passes)
+{
+    size_t cols = cd->cols, passes = 0;
+    while (passes < max_passes) {
+        double change = 0;
+        for (size_t j = 0; j < cols; j++) {
+            double d = ml_cd_step(cd, w, j, l1, l2);
+            if (d > change) change = d;
+            cd->active[j] = w[j] != 0;
+        }
+        passes++;
+        if (change <= tol) break;
+
+        while (passes < max_passes) {
+            change = 0;
+            for (size_t j = 0; j < cols; j++) {
+                if (!cd->active[j]) continue;
+                double d = ml_cd_step(cd, w, j, l1, l2);
+                if (d > change) change = d;
+            }
+            passes++;
+            if (change <= tol) break;
+        }
+    }
+}
+
+/* Penalties for a coordinate-descent model ID; -4 if it is not one. */
+static int ml_cd_penalties(const char* model_id, double alpha, double l1_ratio,
+                           double* l1, double* l2)
+{
+    if (!strcmp(model_id, "ridge")) { *l1 = 0; *l2 = alpha; }
+    else if (!strcmp(model_id, "lasso")) { *l1 = alpha; *l2 = 0; }
+    else if (!strcmp(model_id, "elastic_net")) {
+        *l1 = alpha * l1_ratio;
+        *l2 = alpha * (1 - l1_ratio);
+    }
+    else return -4;
+    return 0;
+}
+
+/* ============================================================
+   Histogram trees
+   ============================================================ */
+
+#define ML_TREE_MAX_BINS     256
+#define ML_TREE_BIN_SAMPLE   200000   /* rows sampled to place bin edges */
+#define ML_TREE_WORK_GRAIN   65536    /* row-features (or bins) per task */
+#define ML_TREE_BIN_BLOCK    (1 << 20) /* sampled values per binning task */
+
+/*
+ * Features are binned once into u8 codes, stored feature-major so a
+ * histogram pass over one feature streams a single column. Edges are
+ * midpoints between neighbouring distinct values at sample quantiles;
+ * bin(x) counts the edges below x, so bin(x) <= b exactly when
+ * x <= edge[b] and trained thresholds apply to raw features. NaN takes
+ * the top bin and therefore always goes right.
+ */
+typedef struct {
+    size_t rows, cols;
+    uint8_t* bins;      /* cols x rows */
+    double* edges;      /* cols x (ML_TREE_MAX_BINS - 1) */
+    size_t* n_bins;     /* edges + 1 per feature */
+    size_t* bin_off;    /* feature offset into a histogram */
+    size_t total_bins;
+} ml_binned_t;
+
+typedef struct {
+    const double* X;
+    const size_t* view;
+    ml_binned_t* B;
+    size_t stride;      /* sample every stride-th row */
+    size_t max_bins;
+    int* failed;        /* per chunk */
+} ml_bin_job_t;
+
+/*
+ * LSD radix sort of non-NaN doubles in 11-bit digits, using `tmp` as the
+ * second buffer. Keys flip the sign bit of positives and every bit of
+ * negatives so unsigned order matches numeric order.
+ */
+static void ml_sort_f64(double* v, size_t n, double* tmp)
+{
+    enum { BITS = 11, RADIX = 1 << BITS };
+    uint64_t* keys = (uint64_t*)v;
+    uint64_t* other = (uint64_t*)tmp;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t u;
+        memcpy(&u, &v[i], sizeof(u));
+        keys[i] = (u >> 63) ? ~u : u ^ ((uint64_t)1 << 63);
+    }
+    size_t count[RADIX];
+    for (unsigned shift = 0; shift < 64; shift += BITS) {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++)
+            count[(keys[i] >> shift) & (RADIX - 1)]++;
+        if (n == 0 || count[(keys[0] >> shift) & (RADIX - 1)] == n) continue;
+        size_t sum = 0;
+        for (size_t d = 0; d < RADIX; d++) {
+            size_t c = count[d];
+            count[d] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++)
+            other[count[(keys[i] >> shift) & (RADIX - 1)]++] = keys[i];
+        uint64_t* swap = keys; keys = other; other = swap;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint64_t u = (keys[i] >> 63) ? keys[i] ^ ((uint64_t)1 << 63) : ~keys[i];
+        memcpy(&v[i], &u, sizeof(u));
+    }
+}
+
+/* Edges from n sorted non-NaN values; returns the edge count. */
+static size_t ml_bin_edges(const double* v, size_t n, size_t max_bins, double* edges)
+{
+    size_t distinct = n ? 1 : 0;
+    for (size_t i = 1; i < n; i++)
+        distinct += v[i] != v[i - 1];
+
+    size_t count = 0;
+    if (distinct <= max_bins) {
+        for (size_t i = 1; i < n; i++)
+            if (v[i] != v[i - 1])
+                edges[count++] = v[i - 1] / 2 + v[i] / 2;
+        return count;
+    }
+    size_t last = 0;
+    for (size_t q = 1; q < max_bins; q++) {
+        size_t pos = q * n / max_bins;
+        if (pos <= last) pos = last + 1;
+        while (pos < n && v[pos] == v[pos - 1]) pos++;
+        if (pos >= n) break;
+        edges[count++] = v[pos - 1] / 2 + v[pos] / 2;
+        last = pos;
+    }
+    return count;
+}
+
+/*
+ * Bin a block of features. X is read row by row for the whole block,
+ * once to sample and once to bin, instead of gathering one strided
+ * column per feature.
+ */
+static void ml_bin_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_bin_job_t* job = ctx;
+    ml_binned_t* B = job->B;
+    size_t rows = B->rows, cols = B->cols, nf = end - begin;
+    size_t cap = (rows + job->stride - 1) / job->stride;
+    double* sample = malloc(nf * cap * sizeof(double));
+    double* tmp = malloc(cap * sizeof(double));
+    size_t* n = calloc(nf, sizeof(size_t));
+    if (!sample || !tmp || !n) {
+        free(sample); free(tmp); free(n);
+        job->failed[chunk] = 1;
+        return;
+    }
+
+    for (size_t i = 0; i < rows; i += job->stride) {
+        const double* row = job->X + ml_view_row(job->view, i) * cols + begin;
+        for (size_t f = 0; f < nf; f++)
+            if (row[f] == row[f]) sample[f * cap + n[f]++] = row[f];
+    }
+    for (size_t f = 0; f < nf; f++) {
+        ml_sort_f64(sample + f * cap, n[f], tmp);
+        size_t n_edges = ml_bin_edges(sample + f * cap, n[f], job->max_bins,
+                                      B->edges + (begin + f) * (ML_TREE_MAX_BINS - 1));
+        B->n_bins[begin + f] = n_edges + 1;
+    }
+
+    for (size_t i = 0; i < rows; i++) {
+        const double* row = job->X + ml_view_row(job->view, i) * cols;
+        for (size_t f = begin; f < end; f++) {
+            const double* edges = B->edges + f * (ML_TREE_MAX_BINS - 1);
+            double x = row[f];
+            size_t lo = 0, hi = B->n_bins[f] - 1;
+            if (x != x) lo = hi;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (edges[mid] < x) lo = mid + 1; else hi = mid;
+            }
+            B->bins[f * rows + i] = (uint8_t)lo;
+        }
+    }
+    free(n);
+    free(tmp);
+    free(sample);
+}
+
+static void ml_binned_free(ml_binned_t* B)
+{
+    free(B->bins);
+    free(B->edges);
+    free(B->n_bins);
+    free(B->bin_off);
+}
+
+static int ml_bin_features(const double* X, const size_t* view, size_t rows, size_t cols,
+                           size_t max_bins, ml_binned_t* B)
+{
+    memset(B, 0, sizeof(*B));
+    B->rows = rows;
+    B->cols = cols;
+    B->bins = malloc(rows * cols);
+    B->edges = malloc(cols * (ML_TREE_MAX_BINS - 1) * sizeof(double));
+    B->n_bins = malloc(cols * sizeof(size_t));
+    B->bin_off = malloc(cols * sizeof(size_t));
+    size_t sampled = rows < ML_TREE_BIN_SAMPLE ? rows : ML_TREE_BIN_SAMPLE;
+    size_t grain = ML_TREE_BIN_BLOCK / sampled ? ML_TREE_BIN_BLOCK / sampled : 1;
+    size_t chunks = fossil_data_parallel_chunks(cols, grain);
+    int* failed = calloc(chunks, sizeof(int));
+    if (!B->bins || !B->edges || !B->n_bins || !B->bin_off || !failed) {
+        free(failed);
+        ml_binned_free(B);
+        return -3;
+    }
+
+    ml_bin_job_t job = { X, view, B, 1, max_bins, failed };
+    if (rows > ML_TREE_BIN_SAMPLE)
+        job.stride = (rows + ML_TREE_BIN_SAMPLE - 1) / ML_TREE_BIN_SAMPLE;
+    fossil_data_parallel_for(cols, grain, ml_bin_chunk, &job);
+    int rc = 0;
+    for (size_t c = 0; c < chunks; c++)
+        if (failed[c]) rc = -3;
+    free(failed);
+    if (rc != 0) { ml_binned_free(B); return rc; }
+
+    for (size_t f = 0; f < cols; f++) {
+        B->bin_off[f] = B->total_bins;
+        B->total_bins += B->n_bins[f];
+    }
+    return 0;
+}
+
+/* Gradient sum and row count per bin. */
+typedef struct {
+    double g;
+    double n;
+} ml_hist_t;
+
+typedef struct {
+    double gain;
+    size_t bin;
+} ml_split_t;
+
+/*
+ * Squared-loss trees on gradients g = prediction - y: a node's output is
+ * -G / (N + lambda) and a split gains GL^2/(NL+l) + GR^2/(NR+l) - G^2/(N+l).
+ * Rows of the node being grown are idx[begin, end); splits partition that
+ * range stably, so each child's rows stay in ascending order.
+ */
+typedef struct {
+    const ml_binned_t* B;
+    const double* g;
+    double* F;          /* running predictions, updated at each leaf */
+    double* gord;       /* gradients of the rows being histogrammed, in idx order */
+    size_t* idx;
+    size_t* tmp;
+    ml_hist_t** pool;   /* one histogram per depth, allocated on first use */
+    ml_split_t* best;   /* per feature */
+    ml_tree_node_t* nodes;
+    size_t n_nodes, cap;
+    size_t max_depth, min_leaf;
+    double lambda, lr;
+} ml_tree_builder_t;
+
+typedef struct {
+    const ml_tree_builder_t* b;
+    size_t begin, end;
+    ml_hist_t* hist;
+    double G, N;
+} ml_hist_job_t;
+
+static void ml_hist_chunk(void* ctx, size_t chunk, size_t fbegin, size_t fend)
+{
+    ml_hist_job_t* job = ctx;
+    const ml_tree_builder_t* b = job->b;
+    const ml_binned_t* B = b->B;
+    (void)chunk;
+    for (size_t f = fbegin; f < fend; f++) {
+        ml_hist_t* h = job->hist + B->bin_off[f];
+        const uint8_t* col = B->bins + f * B->rows;
+        const size_t* idx = b->idx + job->begin;
+        size_t n = job->end - job->begin;
+        memset(h, 0, B->n_bins[f] * sizeof(ml_hist_t));
+        for (size_t p = 0; p < n; p++) {
+            ml_hist_t* bin = &h[col[idx[p]]];
+            bin->g += b->gord[p];
+            bin->n += 1;
+        }
+    }
+}
+
+static void ml_split_chunk(void* ctx, size_t chunk, size_t fbegin, size_t fend)
+{
+    ml_hist_job_t* job = ctx;
+    const ml_tree_builder_t* b = job->b;
+    const ml_binned_t* B = b->B;
+    double G = job->G, N = job->N, lambda = b->lambda, min_leaf = (double)b->min_leaf;
+    double parent = G * G / (N + lambda);
+    (void)chunk;
+    for (size_t f = fbegin; f < fend; f++) {
+        const ml_hist_t* h = job->hist + B->bin_off[f];
+        ml_split_t best = { 0.0, SIZE_MAX };
+        double gl = 0, nl = 0;
+        for (size_t bin = 0; bin + 1 < B->n_bins[f]; bin++) {
+            gl += h[bin].g;
+            nl += h[bin].n;
+            double nr = N - nl;
+            if (nl < min_leaf) continue;
+            if (nr < min_leaf) break;
+            double gr = G - gl;
+            double gain = gl * gl / (nl + lambda) + gr * gr / (nr + lambda) - parent;
+            if (gain > best.gain) { best.gain = gain; best.bin = bin; }
+        }
+        b->best[f] = best;
+    }
+}
+
+static ml_hist_t* ml_tree_hist(ml_tree_builder_t* b, size_t depth)
+{
+    if (!b->pool[depth])
+        b->pool[depth] = malloc(b->B->total_bins * sizeof(ml_hist_t));
+    return b->pool[depth];
+}
+
+static void ml_tree_build_hist(ml_tree_builder_t* b, size_t begin, size_t end, ml_hist_t* hist)
+{
+    size_t n = end - begin;
+    size_t grain = n >= ML_TREE_WORK_GRAIN ? 1 : ML_TREE_WORK_GRAIN / (n ? n : 1);
+    for (size_t p = 0; p < n; p++)
+        b->gord[p] = b->g[b->idx[begin + p]];
+    ml_hist_job_t job = { b, begin, end, hist, 0, 0 };
+    fossil_data_parallel_for(b->B->cols, grain, ml_hist_chunk, &job);
+}
+
+static int ml_tree_push(ml_tree_builder_t* b, size_t* id)
+{
+    if (b->n_nodes == b->cap) {
+        size_t cap = b->cap ? 2 * b->cap : 64;
+        if (cap > UINT32_MAX) return -3;
+        ml_tree_node_t* nodes = realloc(b->nodes, cap * sizeof(ml_tree_node_t));
+        if (!nodes) return -3;
+        b->nodes = nodes;
+        b->cap = cap;
+    }
+    *id = b->n_nodes++;
+    return 0;
+}
+
+/*
+ * Grow the subtree over idx[begin, end) whose histogram is `hist`. Only
+ * the smaller child's histogram is built from rows; the larger one is
+ * the parent's minus it, computed in the parent's buffer. A node at
+ * depth d holds a buffer pool[j] with j <= d and borrows pool[d + 1] for
+ * its child, so a pool of max_depth + 1 histograms covers the tree.
+ */
+static int ml_tree_grow(ml_tree_builder_t* b, size_t begin, size_t end, ml_hist_t* hist, size_t depth)
+{
+    const ml_binned_t* B = b->B;
+    double G = 0, N = (double)(end - begin), spread = 0;
+    for (size_t bin = 0; bin < B->n_bins[0]; bin++) {
+        G += hist[bin].g;
+        if (hist[bin].n > 0) spread += hist[bin].g * hist[bin].g / hist[bin].n;
+    }
+    size_t id;
+    if (ml_tree_push(b, &id) != 0) return -3;
+
+    size_t feature = SIZE_MAX, bin = 0;
+    if (depth < b->max_depth && end - begin >= 2 * b->min_leaf) {
+        size_t grain = ML_TREE_WORK_GRAIN / (B->total_bins / B->cols + 1);
+        ml_hist_job_t job = { b, begin, end, hist, G, N };
+        fossil_data_parallel_for(B->cols, grain, ml_split_chunk, &job);
+        /* gains below rounding noise would split rows with equal gradients */
+        double best = 1e-12 * spread;
+        for (size_t f = 0; f < B->cols; f++) {
+            if (b->best[f].bin != SIZE_MAX && b->best[f].gain > best) {
+                best = b->best[f].gain;
+                feature = f;
+                bin = b->best[f].bin;
+            }
+        }
+    }
+
+    if (feature == SIZE_MAX) {
+        double value = -b->lr * G / (N + b->lambda);
+        b->nodes[id].feature = -1;
+        b->nodes[id].right = 0;
+        b->nodes[id].value = value;
+        for (size_t p = begin; p < end; p++)
+            b->F[b->idx[p]] += value;
+        return 0;
+    }
+
+    const uint8_t* col = B->bins + feature * B->rows;
+    size_t mid = begin, spill = 0;
+    for (size_t p = begin; p < end; p++) {
+        size_t r = b->idx[p];
+        if (col[r] <= bin) b->idx[mid++] = r;
+        else b->tmp[spill++] = r;
+    }
+    memcpy(b->idx + mid, b->tmp, spill * sizeof(size_t));
+
+    ml_hist_t* other = ml_tree_hist(b, depth + 1);
+    if (!other) return -3;
+    ml_hist_t *left, *right;
+    if (mid - begin <= end - mid) {
+        ml_tree_build_hist(b, begin, mid, other);
+        left = other;
+        right = hist;
+    } else {
+        ml_tree_build_hist(b, mid, end, other);
+        left = hist;
+        right = other;
+    }
+    for (size_t j = 0; j < B->total_bins; j++) {
+        hist[j].g -= other[j].g;
+        hist[j].n -= other[j].n;
+    }
+
+    b->nodes[id].feature = (int32_t)feature;
+    b->nodes[id].value = B->edges[feature * (ML_TREE_MAX_BINS - 1) + bin];
+    int rc = ml_tree_grow(b, begin, mid, left, depth + 1);
+    if (rc != 0) return rc;
+    b->nodes[id].right = (uint32_t)b->n_nodes;
+    return ml_tree_grow(b, mid, end, right, depth + 1);
+}
+
+/*
+ * Boosting on squared loss: each round fits a tree to the current
+ * residuals and adds it, scaled by lr, to the predictions. A decision
+ * tree is one round with lr = 1. The mean of y starts the predictions
+ * and is folded into the first tree's leaves, so a model's output is
+ * just the sum of its trees.
+ */
+static int ml_fit_trees(const double* X, const double* y, const size_t* view,
+                        size_t rows, size_t cols,
+                        size_t rounds, size_t max_depth, size_t min_leaf, size_t max_bins,
+                        double lambda, double lr, fossil_ml_model_t* m)
+{
+    if (cols > INT32_MAX) return -1;
+    ml_binned_t B;
+    int rc = ml_bin_features(X, view, rows, cols, max_bins, &B);
+    if (rc != 0) return rc;
+
+    ml_tree_builder_t b;
+    memset(&b, 0, sizeof(b));
+    b.B = &B;
+    b.max_depth = max_depth;
+    b.min_leaf = min_leaf;
+    b.lambda = lambda;
+    b.lr = lr;
+    double* g = malloc(rows * sizeof(double));
+    b.F = malloc(rows * sizeof(double));
+    b.idx = malloc(rows * sizeof(size_t));
+    b.tmp = malloc(rows * sizeof(size_t));
+    b.gord = malloc(rows * sizeof(double));
+    b.pool = calloc(max_depth + 1, sizeof(ml_hist_t*));
+    b.best = malloc(cols * sizeof(ml_split_t));
+    b.g = g;
+    m->roots = malloc(rounds * sizeof(size_t));
+    if (!g || !b.F || !b.idx || !b.tmp || !b.gord || !b.pool || !b.best || !m->roots) rc = -3;
+
+    double base = 0;
+    for (size_t i = 0; rc == 0 && i < rows; i++)
+        base += y[ml_view_row(view, i)];
+    base /= (double)rows;
+    for (size_t i = 0; rc == 0 && i < rows; i++)
+        b.F[i] = base;
+
+    for (size_t t = 0; rc == 0 && t < rounds; t++) {
+        for (size_t i = 0; i < rows; i++) {
+            g[i] = b.F[i] - y[ml_view_row(view, i)];
+            b.idx[i] = i;
+        }
+        ml_hist_t* root = ml_tree_hist(&b, 0);
+        if (!root) { rc = -3; break; }
+        ml_tree_build_hist(&b, 0, rows, root);
+        m->roots[t] = b.n_nodes;
+        rc = ml_tree_grow(&b, 0, rows, root, 0);
+        if (rc == 0) m->n_trees = t + 1;
+    }
+    if (rc == 0) {
+        size_t end = m->n_trees > 1 ? m->roots[1] : b.n_nodes;
+        for (size_t n = 0; n < end; n++)
+            if (b.nodes[n].feature < 0) b.nodes[n].value += base;
+    }
+
+    m->nodes = b.nodes;
+    m->n_nodes = b.n_nodes;
+    for (size_t d = 0; b.pool && d <= max_depth; d++)
+        free(b.pool[d]);
+    free(b.pool);
+    free(b.best);
+    free(b.gord);
+    free(b.tmp);
+    free(b.idx);
+    free(b.F);
+    free(g);
+    ml_binned_free(&B);
+    return rc;
+}
+
+/* Sum of every tree's leaf for each row, one tree at a time over the tile. */
+static void ml_tree_score_rows(const fossil_ml_model_t* m, const double* x, size_t n, double* out)
+{
+    size_t cols = m->cols;
+    for (size_t r = 0; r < n; r++)
+        out[r] = 0;
+    for (size_t t = 0; t < m->n_trees; t++) {
+        const ml_tree_node_t* tree = m->nodes + m->roots[t];
+        size_t root = m->roots[t];
+        for (size_t r = 0; r < n; r++) {
+            const double* row = x + r * cols;
+            size_t at = 0;
+            while (tree[at].feature >= 0)
+                at = row[tree[at].feature] <= tree[at].value ? at + 1 : tree[at].right - root;
+            out[r] += tree[at].value;
+        }
+    }
+}
+
+/*
+ * Rebuild the tree roots of a loaded model and check every node, so a
+ * damaged file cannot send a walk out of its tree: children always lie
+ * after their parent and inside the tree.
+ */
+static int ml_tree_index(fossil_ml_model_t* m, size_t n_trees)
+{
+    m->roots = malloc(n_trees * sizeof(size_t));
+    if (!m->roots) return -3;
+    size_t at = 0;
+    for (size_t t = 0; t < n_trees; t++) {
+        if (at >= m->n_nodes) return -5;
+        size_t root = at, open = 1;
+        while (open > 0) {
+            if (at >= m->n_nodes) return -5;
+            if (m->nodes[at].feature >= 0) open++; else open--;
+            at++;
+        }
+        for (size_t n = root; n < at; n++) {
+            const ml_tree_node_t* node = &m->nodes[n];
+            if (node->feature >= 0 &&
+                ((size_t)node->feature >= m->cols || node->right <= n + 1 || node->right >= at))
+                return -5;
+        }
+        m->roots[t] = root;
+    }
+    if (at != m->n_nodes) return -5;
+    m->n_trees = n_trees;
+    return 0;
+}
+
+/* ============================================================
+   IVF nearest-neighbor index
+   ============================================================ */
+
+#define ML_IVF_TRAIN_PER_LIST 64   /* sampled rows per list when clustering */
+#define ML_IVF_DEFAULT_ITERS  20
+#define ML_KNN_QUERY_GRAIN    16
+
+/*
+ * An inverted-file index: k-means splits the rows into lists, each list
+ * stores its rows contiguously, and a query scans only the lists whose
+ * centers are nearest. Scanning every list gives the exact answer.
+ */
+typedef struct {
+    double d;
+    size_t id;
+} ml_pair_t;
+
+/* Keep the `cap` smallest pairs in a max-heap. */
+static void ml_heap_offer(ml_pair_t* h, size_t* n, size_t cap, double d, size_t id)
+{
+    size_t i;
+    if (*n < cap) {
+        for (i = (*n)++; i > 0; ) {
+            size_t parent = (i - 1) / 2;
+            if (h[parent].d >= d) break;
+            h[i] = h[parent];
+            i = parent;
+        }
+    } else {
+        if (d >= h[0].d) return;
+        for (i = 0; ; ) {
+            size_t c = 2 * i + 1;
+            if (c >= *n) break;
+            if (c + 1 < *n && h[c + 1].d > h[c].d) c++;
+            if (h[c].d <= d) break;
+            h[i] = h[c];
+            i = c;
+        }
+    }
+    h[i].d = d;
+    h[i].id = id;
+}
+
+/* Heap sort: leaves the pairs in ascending distance. */
+static void ml_heap_sort(ml_pair_t* h, size_t n)
+{
+    for (size_t end = n; end > 1; end--) {
+        ml_pair_t top = h[0], last = h[end - 1];
+        size_t i = 0, size = end - 1;
+        for (;;) {
+            size_t c = 2 * i + 1;
+            if (c >= size) break;
+            if (c + 1 < size && h[c + 1].d > h[c].d) c++;
+            if (h[c].d <= last.d) break;
+            h[i] = h[c];
+            i = c;
+        }
+        h[i] = last;
+        h[end - 1] = top;
+    }
+}
+
+static void ml_knn_scan_list(const fossil_ml_model_t* m, const double* q, size_t list,
+                             ml_pair_t* best, size_t* found, size_t k)
+{
+    size_t cols = m->cols;
+    for (size_t p = m->list_offsets[list]; p < m->list_offsets[list + 1]; p++)
+        ml_heap_offer(best, found, k, ml_sqdist(q, m->list_vectors + p * cols, cols), p);
+}
+
+/*
+ * The k nearest stored vectors to q, ascending, as positions in
+ * list_vectors. If the probed lists hold fewer than k vectors the rest
+ * are scanned too, so k results always come back.
+ */
+static void ml_knn_search_one(const fossil_ml_model_t* m, const double* q, size_t k,
+                              size_t n_probe, ml_pair_t* lists, unsigned char* probed,
+                              ml_pair_t* best)
+{
+    size_t n_lists = m->k, cols = m->cols, nl = 0, found = 0;
+    for (size_t c = 0; c < n_lists; c++)
+        ml_heap_offer(lists, &nl, n_probe, ml_sqdist(q, m->centers + c * cols, cols), c);
+    ml_heap_sort(lists, nl);
+    for (size_t i = 0; i < nl; i++)
+        ml_knn_scan_list(m, q, lists[i].id, best, &found, k);
+
+    if (found < k && nl < n_lists) {
+        for (size_t i = 0; i < nl; i++) probed[lists[i].id] = 1;
+        for (size_t c = 0; c < n_lists; c++)
+            if (!probed[c]) ml_knn_scan_list(m, q, c, best, &found, k);
+        for (size_t i = 0; i < nl; i++) probed[lists[i].id] = 0;
+    }
+    ml_heap_sort(best, found);
+}
+
+typedef struct {
+    const fossil_ml_model_t* m;
+    const void* Q;
+    ml_dtype_t in;
+    size_t k, n_probe;
+    size_t* pos;        /* n x k positions in list order */
+    double* dist;       /* n x k squared distances, optional */
+    int* failed;        /* per chunk */
+} ml_knn_job_t;
+
+static void ml_knn_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_knn_job_t* job = ctx;
+    const fossil_ml_model_t* m = job->m;
+    size_t cols = m->cols, k = job->k;
+    ml_pair_t* lists = malloc(job->n_probe * sizeof(ml_pair_t));
+    ml_pair_t* best = malloc(k * sizeof(ml_pair_t));
+    unsigned char* probed = calloc(m->k, 1);
+    double* row = job->in == ML_DTYPE_F64 ? NULL : malloc(cols * sizeof(double));
+    if (!lists || !best || !probed || (job->in != ML_DTYPE_F64 && !row)) {
+        job->failed[chunk] = 1;
+    } else {
+        for (size_t i = begin; i < end; i++) {
+            const double* q = (const double*)job->Q + i * cols;
+            if (row) {
+                ml_load(job->Q, i * cols, cols, job->in, row);
+                q = row;
+            }
+            ml_knn_search_one(m, q, k, job->n_probe, lists, probed, best);
+            for (size_t j = 0; j < k; j++) {
+                job->pos[i * k + j] = best[j].id;
+                if (job->dist) job->dist[i * k + j] = best[j].d;
+            }
+        }
+    }
+    free(row);
+    free(probed);
+    free(best);
+    free(lists);
+}
+
+static int ml_knn_search(const fossil_ml_model_t* m, const void* Q, ml_dtype_t in, size_t n,
+                         size_t k, size_t n_probe, size_t* pos, double* dist)
+{
+    size_t chunks = fossil_data_parallel_chunks(n, ML_KNN_QUERY_GRAIN);
+    int* failed = calloc(chunks, sizeof(int));
+    if (!failed) return -3;
+    ml_knn_job_t job = { m, Q, in, k, n_probe ? n_probe : m->n_probe, pos, dist, failed };
+    if (job.n_probe > m->k) job.n_probe = m->k;
+    fossil_data_parallel_for(n, ML_KNN_QUERY_GRAIN, ml_knn_chunk, &job);
+    int rc = 0;
+    for (size_t c = 0; c < chunks; c++)
+        if (failed[c]) rc = -3;
+    free(failed);
+    return rc;
+}
+
+typedef struct {
+    const double* X;
+    const size_t* view;
+    const fossil_ml_model_t* m;
+    size_t* labels;
+} ml_ivf_assign_job_t;
+
+static void ml_ivf_assign_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_ivf_assign_job_t* job = ctx;
+    (void)chunk;
+    for (size_t i = begin; i < end; i++)
+        job->labels[i] = ml_nearest_center_pruned(
+            job->X + ml_view_row(job->view, i) * job->m->cols, job->m);
+}
+
+/*
+ * Cluster a sample of the rows into the lists, then file every row under
+ * its nearest center with a counting sort, keeping row order within a list.
+ */
+static int ml_fit_knn(const double* X, const double* y, const size_t* view,
+                      size_t rows, size_t cols,
+                      const fossil_data_ml_options_t* opts, fossil_ml_model_t** out)
+{
+    size_t n_lists = opts->n_lists ? opts->n_lists : (size_t)sqrt((double)rows);
+    if (n_lists == 0) n_lists = 1;
+    if (n_lists > rows) return -1;
+
+    size_t sampled = rows, stride = 1;
+    if (rows / ML_IVF_TRAIN_PER_LIST > n_lists) {
+        stride = rows / (n_lists * ML_IVF_TRAIN_PER_LIST);
+        sampled = (rows + stride - 1) / stride;
+    }
+    double* sample = NULL;
+    if (stride > 1 || view) {
+        sample = malloc(sampled * cols * sizeof(double));
+        if (!sample) return -3;
+        for (size_t i = 0; i < sampled; i++)
+            memcpy(sample + i * cols, X + ml_view_row(view, i * stride) * cols,
+                   cols * sizeof(double));
+    }
+
+    fossil_ml_model_t* m = ml_kmeans_alloc(n_lists, cols);
+    fossil_data_ml_options_t kopts = *opts;
+    kopts.k = n_lists;
+    kopts.batch_size = 0;
+    if (!kopts.max_iter) kopts.max_iter = ML_IVF_DEFAULT_ITERS;
+    int rc = m ? ml_fit_kmeans(sample ? sample : X, sampled, cols, &kopts, m) : -3;
+    free(sample);
+
+    size_t* labels = malloc(rows * sizeof(size_t));
+    if (rc == 0) {
+        m->kind = MODEL_KNN;
+        m->rows = rows;
+        m->list_vectors = malloc(rows * cols * sizeof(double));
+        m->list_ids = malloc(rows * sizeof(size_t));
+        m->list_offsets = calloc(n_lists + 1, sizeof(size_t));
+        if (y) m->targets = malloc(rows * sizeof(double));
+        if (!labels || !m->list_vectors || !m->list_ids || !m->list_offsets || (y && !m->targets))
+            rc = -3;
+    }
+    if (rc == 0) {
+        ml_ivf_assign_job_t job = { X, view, m, labels };
+        fossil_data_parallel_for(rows, ml_kmeans_grain(rows, 0), ml_ivf_assign_chunk, &job);
+
+        memset(m->center_counts, 0, n_lists * sizeof(size_t));
+        for (size_t i = 0; i < rows; i++)
+            m->center_counts[labels[i]]++;
+        for (size_t c = 0; c < n_lists; c++)
+            m->list_offsets[c + 1] = m->list_offsets[c] + m->center_counts[c];
+        size_t* fill = labels;   /* reuse: labels are consumed as rows are placed */
+        size_t* next = malloc(n_lists * sizeof(size_t));
+        if (!next) {
+            rc = -3;
+        } else {
+            memcpy(next, m->list_offsets, n_lists * sizeof(size_t));
+            for (size_t i = 0; i < rows; i++) {
+                size_t p = next[fill[i]]++, r = ml_view_row(view, i);
+                memcpy(m->list_vectors + p * cols, X + r * cols, cols * sizeof(double));
+                m->list_ids[p] = i;
+                if (y) m->targets[p] = y[r];
+            }
+            free(next);
+        }
+        m->n_neighbors = opts->n_neighbors ? opts->n_neighbors : 5;
+        m->n_probe = opts->n_probe ? opts->n_probe : (n_lists >= 16 ? n_lists / 16 : 1);
+        if (m->n_probe > n_lists) m->n_probe = n_lists;
+    }
+    free(labels);
+
+    if (rc != 0) {
+        fossil_data_ml_free_model(m);
+        return rc;
+    }
+    *out = m;
+    return 0;
+}
+
+/*
+ * k-NN values: the mean target of the neighbors, or with `vote` the
+ * most common target, ties going to the nearer neighbor.
+ */
+static int ml_knn_values(const fossil_ml_model_t* m, const void* X, ml_dtype_t in, size_t rows,
+                         int vote, double* values)
+{
+    if (!m->targets) return -1;
+    size_t k = m->n_neighbors < m->rows ? m->n_neighbors : m->rows;
+    size_t* pos = malloc(rows * k * sizeof(size_t));
+    int rc = pos ? ml_knn_search(m, X, in, rows, k, 0, pos, NULL) : -3;
+
+    for (size_t i = 0; rc == 0 && i < rows; i++) {
+        const size_t* nb = pos + i * k;
+        double value = 0;
+        if (vote) {
+            size_t best_count = 0;
+            for (size_t a = 0; a < k; a++) {
+                size_t count = 0;
+                for (size_t b = 0; b < k; b++)
+                    count += m->targets[nb[b]] == m->targets[nb[a]];
+                if (count > best_count) { best_count = count; value = m->targets[nb[a]]; }
+            }
+        } else {
+            for (size_t a = 0; a < k; a++)
+                value += m->targets[nb[a]];
+            value /= (double)k;
+        }
+        values[i] = value;
+    }
+    free(pos);
+    return rc;
+}
+
+/* k-NN prediction; integer outputs vote instead of averaging. */
+static int ml_knn_predict(const fossil_ml_model_t* m, const void* X, ml_dtype_t in, size_t rows,
+                          void* y_pred, ml_dtype_t out)
+{
+    double* values = malloc(rows * sizeof(double));
+    if (!values) return -3;
+    int rc = ml_knn_values(m, X, in, rows, out != ML_DTYPE_F32 && out != ML_DTYPE_F64, values);
+    if (rc == 0) ml_store(y_pred, 0, rows, out, values);
+    free(values);
+    return rc;
+}
+
+/* ============================================================
+   OPTIONS
+   ============================================================ */
+
+void fossil_data_ml_options_init(fossil_data_ml_options_t* opts)
+{
+    if (!opts) return;
+    memset(opts, 0, sizeof(*opts));
+    opts->k = 3;
+    opts->max_iter = 0;
+    opts->tol = 1e-4;
+    opts->seed = 42;
+    opts->init = "kmeans++";
+    opts->algorithm = "auto";
+    opts->l2 = 0.0;
+    opts->l1 = 0.0;
+    opts->l1_ratio = 0.5;
+    opts->max_depth = 0;
+    opts->min_samples_leaf = 0;
+    opts->max_bins = 0;
+    opts->n_lists = 0;
+    opts->n_probe = 0;
+    opts->n_neighbors = 5;
+}
+
+/* ============================================================
+   TRAIN
+   ============================================================ */
+
+int fossil_data_ml_train(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    void** model_handle)
+{
+    return fossil_data_ml_train_ex(X, y, rows, cols, type_id, model_id, NULL, model_handle);
+}
+
+static double ml_regression_lr(const fossil_data_ml_options_t* opts, int logistic)
+{
+    return opts->learning_rate > 0 ? opts->learning_rate : (logistic ? 0.01 : 0.001);
+}
+
+static size_t ml_regression_iters(const fossil_data_ml_options_t* opts, int logistic)
+{
+    return opts->max_iter ? opts->max_iter : (logistic ? 400 : 500);
+}
+
+/*
+ * Fit any model but kmeans on f64 data through a row view (NULL for all
+ * rows). y may be NULL only for "knn". Shared by training and
+ * cross-validation, which passes one converted copy to every fold.
+ */
+static int ml_train_view(const double* X, const double* y, const size_t* view,
+                         size_t rows, size_t cols, const char* model_id,
+                         const fossil_data_ml_options_t* opts, fossil_ml_model_t** out)
+{
+    *out = NULL;
+    if (!strcmp(model_id, "knn")) return ml_fit_knn(X, y, view, rows, cols, opts, out);
+
+    fossil_ml_model_t* m = calloc(1, sizeof(*m));
+    if (!m) return -3;
+    m->rows = rows;
+    m->cols = cols;
+    int rc;
+
+    /* ---------- LINEAR / LOGISTIC REGRESSION ---------- */
+    if (!strcmp(model_id, "linear_regression") ||
+        !strcmp(model_id, "logistic_regression")) {
+        int logistic = !strcmp(model_id, "logistic_regression");
+        m->kind = logistic ? MODEL_LOGISTIC : MODEL_LINEAR;
+        m->weights = calloc(cols, sizeof(double));
+        rc = m->weights
+            ? ml_fit_gradient(X, NULL, view, y, 1, NULL, rows, cols, 1, logistic,
+                              ml_regression_lr(opts, logistic),
+                              ml_regression_iters(opts, logistic), &opts->l2, m->weights)
+            : -3;
+    }
+
+    /* ---------- RIDGE / LASSO / ELASTIC NET ---------- */
+    else if (!strcmp(model_id, "ridge") || !strcmp(model_id, "lasso") ||
+             !strcmp(model_id, "elastic_net")) {
+        double l1 = !strcmp(model_id, "ridge") ? 0 : opts->l1;
+        double l2 = !strcmp(model_id, "lasso") ? 0 : opts->l2;
+        m->kind = MODEL_LINEAR;
+        m->weights = calloc(cols, sizeof(double));
+        ml_cd_t cd;
+        if (l1 < 0 || l2 < 0) rc = -1;
+        else rc = m->weights ? ml_cd_init(&cd, X, y, view, rows, cols) : -3;
+        if (rc == 0) {
+            ml_fit_cd(&cd, m->weights, l1, l2, opts->tol,
+                      opts->max_iter ? opts->max_iter : ML_CD_DEFAULT_PASSES);
+            ml_cd_free(&cd);
+        }
+    }
+
+    /* ---------- DECISION TREE / GRADIENT BOOSTING ---------- */
+    else if (!strcmp(model_id, "decision_tree") || !strcmp(model_id, "gradient_boosting")) {
+        int boosted = !strcmp(model_id, "gradient_boosting");
+        size_t max_bins = opts->max_bins ? opts->max_bins : ML_TREE_MAX_BINS;
+        m->kind = boosted ? MODEL_GRADIENT_BOOSTING : MODEL_DECISION_TREE;
+        if (max_bins < 2 || max_bins > ML_TREE_MAX_BINS || opts->l2 < 0) rc = -1;
+        else rc = ml_fit_trees(X, y, view, rows, cols,
+                               boosted ? (opts->max_iter ? opts->max_iter : 100) : 1,
+                               opts->max_depth ? opts->max_depth : (boosted ? 6 : 10),
+                               opts->min_samples_leaf ? opts->min_samples_leaf : 1,
+                               max_bins, opts->l2,
+                               boosted && opts->learning_rate > 0 ? opts->learning_rate
+                                                                  : (boosted ? 0.1 : 1.0),
+                               m);
+    }
+    else {
+        rc = -4;
+    }
+
+    if (rc != 0) { fossil_data_ml_free_model(m); return rc; }
+    *out = m;
+    return 0;
+}
+
+int fossil_data_ml_train_ex(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle)
+{
+    // Validate arguments
+    if (!model_handle) return -1;
+    *model_handle = NULL;
+    if (!X || !type_id || !model_id || rows == 0 || cols == 0) return -1;
+    if (!strcmp(model_id, "kmeans") || !strcmp(model_id, "knn")) {
+        // For kmeans and knn, y can be NULL
+    } else {
+        if (!y) return -1;
+    }
+    if (!is_numeric_type(type_id)) return -2;
+
+    fossil_data_ml_options_t defaults;
+    fossil_data_ml_options_init(&defaults);
+    const fossil_data_ml_options_t* opts = options ? options : &defaults;
+
+    /* ---------- KMEANS ---------- */
+    if (!strcmp(model_id, "kmeans")) {
+        if (opts->k == 0 || opts->k > rows) return -1;
+        fossil_ml_model_t* m = ml_kmeans_alloc(opts->k, cols);
+        if (!m) return -3;
+        m->rows = rows;
+
+        int rc;
+        if (opts->batch_size > 0) {
+            // Batches draw rows with replacement; more than rows buys nothing
+            fossil_data_ml_options_t mb = *opts;
+            if (mb.batch_size > rows) mb.batch_size = rows;
+            rc = ml_fit_kmeans_minibatch(X, type_id, rows, cols, &mb, m);
+        } else {
+            double* X_owned;
+            const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+            rc = Xd ? ml_fit_kmeans(Xd, rows, cols, opts, m) : -3;
+            free(X_owned);
+        }
+        if (rc != 0) { fossil_data_ml_free_model(m); return rc; }
+        *model_handle = m;
+        return 0;
+    }
+
+    fossil_ml_model_t* m = NULL;
+    double *X_owned, *y_owned = NULL;
+    const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+    const double* yd = y ? load_f64(y, rows, type_id, &y_owned) : NULL;
+    int rc = (Xd && (yd || !y)) ? ml_train_view(Xd, yd, NULL, rows, cols, model_id, opts, &m) : -3;
+    free(X_owned);
+    free(y_owned);
+    if (rc != 0) return rc;
+    *model_handle = m;
+    return 0;
+}
+
+/* ============================================================
+   PARTIAL FIT
+   ============================================================ */
+
+int fossil_data_ml_partial_fit(
+    const void* X,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle)
+{
+    if (!model_handle || !X || !type_id || !model_id || rows == 0 || cols == 0)
+        return -1;
+    if (!is_numeric_type(type_id)) return -2;
+    if (strcmp(model_id, "kmeans")) return -4;
+
+    fossil_data_ml_options_t defaults;
+    fossil_data_ml_options_init(&defaults);
+    const fossil_data_ml_options_t* opts = options ? options : &defaults;
+
+    fossil_ml_model_t* m = *model_handle;
+    if (m && (m->kind != MODEL_KMEANS || m->cols != cols || !m->center_counts))
+        return -1;
+    if (!m && (opts->k == 0 || opts->k > rows))
+        return -1;
+
+    double* X_owned;
+    const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+    size_t* labels = malloc(rows * sizeof(size_t));
+    int rc = (Xd && labels) ? 0 : -3;
+
+    fossil_ml_model_t* created = NULL;
+    if (rc == 0 && !m) {
+        created = ml_kmeans_alloc(opts->k, cols);
+        rc = created ? ml_kmeans_seed(Xd, rows, cols, opts, created->centers) : -3;
+        m = created;
+    }
+    if (rc == 0) {
+        ml_kmeans_minibatch_step(m, Xd, rows, labels);
+        m->rows += rows;
+        rc = ml_kmeans_finalize(m);
+    }
+
+    free(labels);
+    free(X_owned);
+    if (rc != 0) {
+        if (created) fossil_data_ml_free_model(created);
+        return rc;
+    }
+    *model_handle = m;
+    return 0;
+}
+
+int fossil_data_ml_train_multi(
+    const void* X,
+    const void* Y,
+    size_t rows,
+    size_t cols,
+    size_t y_cols,
+    const size_t* y_index,
+    const double* l2,
+    size_t n_models,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handles)
+{
+    if (!model_handles || !X || !Y || !type_id || !model_id || rows == 0 || cols == 0 ||
+        y_cols == 0 || n_models == 0)
+        return -1;
+    if (!is_numeric_type(type_id)) return -2;
+    int logistic;
+    if (!strcmp(model_id, "linear_regression")) logistic = 0;
+    else if (!strcmp(model_id, "logistic_regression")) logistic = 1;
+    else return -4;
+    if (!y_index && n_models > y_cols) return -1;
+    for (size_t i = 0; y_index && i < n_models; i++)
+        if (y_index[i] >= y_cols) return -1;
+    for (size_t i = 0; l2 && i < n_models; i++)
+        if (!(l2[i] >= 0)) return -1;
+    /* n_models is consistent with the targets now; only then touch the handles. */
+    for (size_t i = 0; i < n_models; i++) model_handles[i] = NULL;
+
+    fossil_data_ml_options_t defaults;
+    fossil_data_ml_options_init(&defaults);
+    const fossil_data_ml_options_t* opts = options ? options : &defaults;
+    if (n_models > SIZE_MAX / sizeof(double) / cols) return -3;
+
+    double *X_owned, *Y_owned;
+    const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+    const double* Yd = load_f64(Y, rows * y_cols, type_id, &Y_owned);
+    double* W = calloc(n_models * cols, sizeof(double));
+    double* penalty = malloc(n_models * sizeof(double));
+    int rc = (Xd && Yd && W && penalty) ? 0 : -3;
+
+    if (rc == 0) {
+        for (size_t i = 0; i < n_models; i++)
+            penalty[i] = l2 ? l2[i] : opts->l2;
+        rc = ml_fit_gradient(Xd, NULL, NULL, Yd, y_cols, y_index, rows, cols, n_models, logistic,
+                             ml_regression_lr(opts, logistic),
+                             ml_regression_iters(opts, logistic), penalty, W);
+    }
+
+    for (size_t i = 0; rc == 0 && i < n_models; i++) {
+        fossil_ml_model_t* m = calloc(1, sizeof(*m));
+        double* w = malloc(cols * sizeof(double));
+        if (!m || !w) { free(m); free(w); rc = -3; break; }
+        memcpy(w, W + i * cols, cols * sizeof(double));
+        m->kind = logistic ? MODEL_LOGISTIC : MODEL_LINEAR;
+        m->rows = rows;
+        m->cols = cols;
+        m->weights = w;
+        model_handles[i] = m;
+    }
+    if (rc != 0) {
+        for (size_t i = 0; i < n_models; i++) {
+            fossil_data_ml_free_model(model_handles[i]);
+            model_handles[i] = NULL;
+        }
+    }
+
+    free(penalty);
+    free(W);
+    free(X_owned);
+    free(Y_owned);
+    return rc;
+}
+
+/* ============================================================
+   PREDICT
+   ============================================================ */
+
+/*
+ * Batch inference works on tiles of rows: each tile is converted to f64
+ * once, scored in one tight loop (a GEMV for regression, a tile-by-centers
+ * distance block for kmeans), and written back with one typed store.
+ * Tiles are independent and run on the worker pool.
+ */
+#define ML_PREDICT_TILE  256
+#define ML_PREDICT_STACK 4096   /* f64 elements of a tile kept on the stack */
+
+typedef struct {
+    const fossil_ml_model_t* m;
+    const void* X;
+    ml_dtype_t in;
+    void* y;
+    ml_dtype_t out;
+    int threshold;     /* logistic: emit 0/1 instead of probabilities */
+    const double* weights;  /* f64 regression weights for the tile path */
+    ml_qdot_fn qdot;        /* quantized model: integer kernel for `in` */
+    int qf32;               /* quantized model: f32 weights and features */
+    unsigned char* failed;  /* per chunk: tile allocation failed */
+} ml_predict_job_t;
+
+/* Integer kernel for a quantized model and feature type, or NULL. */
+static ml_qdot_fn ml_qdot_select(ml_precision_t prec, ml_dtype_t in)
+{
+    if (prec == ML_PREC_I8) {
+        if (in == ML_DTYPE_U8)  return ml_qdot_i8_u8;
+        if (in == ML_DTYPE_I8)  return ml_qdot_i8_s8;
+        if (in == ML_DTYPE_I16) return ml_qdot_i8_s16;
+    } else if (prec == ML_PREC_I16) {
+        if (in == ML_DTYPE_U8)  return ml_qdot_i16_u8;
+        if (in == ML_DTYPE_I8)  return ml_qdot_i16_s8;
+        if (in == ML_DTYPE_I16) return ml_qdot_i16_s16;
+    }
+    return NULL;
+}
+
+/* Expand regression weights of any precision to f64. */
+static void ml_dequantize(const fossil_ml_model_t* m, double* out)
+{
+    size_t cols = m->cols;
+    switch (m->precision) {
+    case ML_PREC_F32:
+        for (size_t j = 0; j < cols; j++) out[j] = ((const float*)m->qweights)[j];
+        break;
+    case ML_PREC_I16:
+        for (size_t j = 0; j < cols; j++) out[j] = m->qscale * ((const int16_t*)m->qweights)[j];
+        break;
+    case ML_PREC_I8:
+        for (size_t j = 0; j < cols; j++) out[j] = m->qscale * ((const int8_t*)m->qweights)[j];
+        break;
+    default:
+        memcpy(out, m->weights, cols * sizeof(double));
+        break;
+    }
+}
+
+/* True when `p` was allocated by the model rather than pointing into a loaded file. */
+static int ml_owned(const fossil_ml_model_t* m, const void* p)
+{
+    uintptr_t lo = (uintptr_t)m->backing, at = (uintptr_t)p;
+    return !lo || at < lo || at >= lo + m->backing_size;
+}
+
+int fossil_data_ml_quantize(void* model_handle, const char* precision)
+{
+    if (!model_handle || !precision) return -1;
+    ml_precision_t prec;
+    if (!strcmp(precision, "f64"))      prec = ML_PREC_F64;
+    else if (!strcmp(precision, "f32")) prec = ML_PREC_F32;
+    else if (!strcmp(precision, "i16")) prec = ML_PREC_I16;
+    else if (!strcmp(precision, "i8"))  prec = ML_PREC_I8;
+    else return -2;
+
+    fossil_ml_model_t* m = model_handle;
+    if (m->kind == MODEL_KMEANS || m->kind == MODEL_KNN || ml_is_tree(m)) return -1;
+    if (m->kind != MODEL_LINEAR && m->kind != MODEL_LOGISTIC) return -4;
+    if (prec == m->precision) return 0;
+
+    size_t cols = m->cols;
+    double* w = malloc(cols * sizeof(double));
+    if (!w) return -3;
+    ml_dequantize(m, w);
+
+    void* q = NULL;
+    double scale = 1.0;
+    if (prec == ML_PREC_F32) {
+        float* qf = malloc(cols * sizeof(float));
+        if (!qf) { free(w); return -3; }
+        for (size_t j = 0; j < cols; j++) qf[j] = (float)w[j];
+        q = qf;
+    } else if (prec != ML_PREC_F64) {
+        /* symmetric per-model scale: the largest |weight| maps to qmax */
+        double qmax = prec == ML_PREC_I8 ? 127.0 : 32767.0;
+        double maxabs = 0;
+        for (size_t j = 0; j < cols; j++)
+            if (fabs(w[j]) > maxabs) maxabs = fabs(w[j]);
+        if (maxabs > 0) scale = maxabs / qmax;
+        q = malloc(cols * (prec == ML_PREC_I8 ? sizeof(int8_t) : sizeof(int16_t)));
+        if (!q) { free(w); return -3; }
+        for (size_t j = 0; j < cols; j++) {
+            double v = floor(w[j] / scale + 0.5);
+            v = v > qmax ? qmax : (v < -qmax ? -qmax : v);
+            if (prec == ML_PREC_I8) ((int8_t*)q)[j] = (int8_t)v;
+            else ((int16_t*)q)[j] = (int16_t)v;
+        }
+    }
+
+    if (m->weights && ml_owned(m, m->weights)) free(m->weights);
+    if (m->qweights && ml_owned(m, m->qweights)) free(m->qweights);
+    m->weights = NULL;
+    m->qweights = NULL;
+    if (prec == ML_PREC_F64) {
+        m->weights = w;
+    } else {
+        free(w);
+        m->qweights = q;
+    }
+    m->precision = prec;
+    m->qscale = scale;
+    return 0;
+}
+
+/* Apply the logistic link to raw regression scores. */
+static void ml_link(const fossil_ml_model_t* m, size_t n, int threshold, double* out)
+{
+    if (m->kind != MODEL_LOGISTIC) return;
+    for (size_t r = 0; r < n; r++) {
+        double p = sigmoid(out[r]);
+        out[r] = threshold ? (p >= 0.5 ? 1.0 : 0.0) : p;
+    }
+}
+
+/* Score `n` f64 rows into `out`; shared by every predict path. */
+static void ml_score_rows(const fossil_ml_model_t* m, const double* w, const double* x,
+                          size_t n, int threshold, double* out)
+{
+    size_t cols = m->cols;
+    if (m->kind == MODEL_KMEANS) {
+        for (size_t r = 0; r < n; r++)
+            out[r] = (double)ml_nearest_center_pruned(x + r * cols, m);
+        return;
+    }
+    if (m->kind == MODEL_DECISION_TREE || m->kind == MODEL_GRADIENT_BOOSTING) {
+        ml_tree_score_rows(m, x, n, out);
+        return;
+    }
+    for (size_t r = 0; r < n; r++)
+        out[r] = ml_dot(w, x + r * cols, cols);
+    ml_link(m, n, threshold, out);
+}
+
+/* Score rows of a quantized model straight from the caller's features. */
+static void ml_score_quantized(const ml_predict_job_t* job, size_t begin, size_t n, double* out)
+{
+    const fossil_ml_model_t* m = job->m;
+    size_t cols = m->cols;
+    if (job->qf32) {
+        const float* x = (const float*)job->X + begin * cols;
+        for (size_t r = 0; r < n; r++)
+            out[r] = ml_dot_f32(m->qweights, x + r * cols, cols);
+    } else {
+        size_t width = job->in == ML_DTYPE_I16 ? sizeof(int16_t) : sizeof(int8_t);
+        const char* x = (const char*)job->X + begin * cols * width;
+        for (size_t r = 0; r < n; r++)
+            out[r] = m->qscale * (double)job->qdot(m->qweights, x + r * cols * width, cols);
+    }
+    ml_link(m, n, job->threshold, out);
+}
+
+static void ml_predict_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_predict_job_t* job = ctx;
+    size_t cols = job->m->cols, n = end - begin;
+    double scores[ML_PREDICT_TILE];
+
+    if (job->qdot || job->qf32) {
+        ml_score_quantized(job, begin, n, scores);
+        ml_store(job->y, begin, n, job->out, scores);
+        return;
+    }
+
+    double stack_tile[ML_PREDICT_STACK];
+    double* heap_tile = NULL;
+    const double* x = (const double*)job->X + begin * cols;
+
+    if (job->in != ML_DTYPE_F64) {
+        double* tile = stack_tile;
+        if (n * cols > ML_PREDICT_STACK) {
+            tile = heap_tile = malloc(n * cols * sizeof(double));
+            if (!tile) { job->failed[chunk] = 1; return; }
+        }
+        ml_load(job->X, begin * cols, n * cols, job->in, tile);
+        x = tile;
+    }
+
+    ml_score_rows(job->m, job->weights, x, n, job->threshold, scores);
+    ml_store(job->y, begin, n, job->out, scores);
+    free(heap_tile);
+}
+
+int fossil_data_ml_predict(
+    const void* X,
+    size_t rows,
+    size_t cols,
+    void* y_pred,
+    void* model_handle,
+    const char* type_id)
+{
+    // Validate arguments
+    if (!model_handle || !type_id || !X || !y_pred || rows == 0 || cols == 0)
+        return -1;
+    ml_dtype_t dt = ml_dtype(type_id);
+    if (dt == ML_DTYPE_INVALID)
+        return -2;
+
+    fossil_ml_model_t* m = (fossil_ml_model_t*)model_handle;
+    if (m->kind != MODEL_LINEAR && m->kind != MODEL_LOGISTIC && m->kind != MODEL_KMEANS &&
+        m->kind != MODEL_KNN && !ml_is_tree(m))
+        return -4;
+    if (cols != m->cols)
+        return -1;
+    if (m->kind == MODEL_KNN)
+        return ml_knn_predict(m, X, dt, rows, y_pred, dt);
+
+    ml_predict_job_t job;
+    job.m = m;
+    job.X = X;
+    job.in = dt;
+    job.y = y_pred;
+    // kmeans always writes cluster indices as int; logistic emits 0/1 for integer outputs
+    job.out = m->kind == MODEL_KMEANS ? ML_DTYPE_I32 : dt;
+    job.threshold = (dt == ML_DTYPE_I32 || dt == ML_DTYPE_I64);
+    job.weights = m->weights;
+    job.qdot = NULL;
+    job.qf32 = 0;
+
+    // Quantized models score supported feature types directly, anything else in f64
+    double* dequantized = NULL;
+    if (m->kind != MODEL_KMEANS && m->precision != ML_PREC_F64) {
+        job.qdot = ml_qdot_select(m->precision, dt);
+        job.qf32 = m->precision == ML_PREC_F32 && dt == ML_DTYPE_F32;
+        if (!job.qdot && !job.qf32) {
+            dequantized = malloc(cols * sizeof(double));
+            if (!dequantized) return -3;
+            ml_dequantize(m, dequantized);
+            job.weights = dequantized;
+        }
+    }
+
+    size_t chunks = fossil_data_parallel_chunks(rows, ML_PREDICT_TILE);
+    job.failed = calloc(chunks, 1);
+    int rc = job.failed ? 0 : -3;
+
+    if (rc == 0)
+        fossil_data_parallel_for(rows, ML_PREDICT_TILE, ml_predict_chunk, &job);
+
+    for (size_t c = 0; rc == 0 && c < chunks; c++)
+        if (job.failed[c]) rc = -3;
+    free(job.failed);
+    free(dequantized);
+    return rc;
+}
+
+/* ============================================================
+   NEAREST NEIGHBORS
+   ============================================================ */
+
+int fossil_data_ml_knn_query(
+    const void* model_handle,
+    const void* Q,
+    size_t n_queries,
+    size_t cols,
+    const char* type_id,
+    size_t k,
+    size_t n_probe,
+    size_t* indices,
+    double* distances)
+{
+    if (!model_handle || !Q || !type_id || !indices || n_queries == 0 || k == 0)
+        return -1;
+    ml_dtype_t dt = ml_dtype(type_id);
+    if (dt == ML_DTYPE_INVALID) return -2;
+    const fossil_ml_model_t* m = model_handle;
+    if (m->kind != MODEL_KNN) return -4;
+    if (cols != m->cols || k > m->rows) return -1;
+
+    int rc = ml_knn_search(m, Q, dt, n_queries, k, n_probe, indices, distances);
+    if (rc != 0) return rc;
+    for (size_t i = 0; i < n_queries * k; i++)
+        indices[i] = m->list_ids[indices[i]];
+    return 0;
+}
+
+/* ============================================================
+   PREDICTOR
+   ============================================================ */
+
+/*
+ * A predictor is an immutable snapshot of a model bound to one input
+ * type: parameters are copied into a single block, and the per-feature
+ * kernels read the caller's row in its own type, so scoring one row
+ * needs no allocation, conversion buffer or string comparison.
+ */
+typedef double (*ml_row_kernel_t)(const double* params, const void* row, size_t cols);
+
+typedef struct {
+    fossil_ml_model_kind_t kind;
+    size_t cols;
+    size_t k;
+    const double* weights;        /* regression */
+    const double* centers;        /* kmeans */
+    const double* center_bounds;  /* kmeans */
+    ml_row_kernel_t dot;
+    ml_row_kernel_t sqdist;
+    ml_dtype_t out;
+    int threshold;
+    double* params;               /* weights, or centers followed by bounds */
+} ml_predictor_t;
+
+#define ML_ROW_KERNELS(name, ctype)                                            \
+    static double ml_row_dot_##name(const double* w, const void* row, size_t cols) \
+    {                                                                          \
+        const ctype* x = (const ctype*)row;                                    \
+        double s0 = 0, s1 = 0;                                                 \
+        size_t j = 0;                                                          \
+        for (; j + 2 <= cols; j += 2) {                                        \
+            s0 += w[j] * (double)x[j];                                         \
+            s1 += w[j + 1] * (double)x[j + 1];                                 \
+        }                                                                      \
+        if (j < cols) s0 += w[j] * (double)x[j];                               \
+        return s0 + s1;                                                        \
+    }                                                                          \
+    static double ml_row_sqdist_##name(const double* c, const void* row, size_t cols) \
+    {                                                                          \
+        const ctype* x = (const ctype*)row;                                    \
+        double d = 0;                                                          \
+        for (size_t j = 0; j < cols; j++) {                                    \
+            double diff = (double)x[j] - c[j];                                 \
+            d += diff * diff;                                                  \
+        }                                                                      \
+        return d;                                                              \
+    }
+
+ML_ROW_KERNELS(i8, int8_t)
+ML_ROW_KERNELS(i16, int16_t)
+ML_ROW_KERNELS(i32, int32_t)
+ML_ROW_KERNELS(i64, int64_t)
+ML_ROW_KERNELS(u8, uint8_t)
+ML_ROW_KERNELS(u16, uint16_t)
+ML_ROW_KERNELS(u32, uint32_t)
+ML_ROW_KERNELS(u64, uint64_t)
+ML_ROW_KERNELS(size, size_t)
+ML_ROW_KERNELS(f32, float)
+ML_ROW_KERNELS(boolean, bool)
+
+static double ml_row_dot_f64(const double* w, const void* row, size_t cols)
+{
+    return ml_dot(w, (const double*)row, cols);
+}
+
+static double ml_row_sqdist_f64(const double* c, const void* row, size_t cols)
+{
+    return ml_sqdist((const double*)row, c, cols);
+}
+
+static void ml_row_kernels(ml_dtype_t t, ml_row_kernel_t* dot, ml_row_kernel_t* sqdist)
+{
+    switch (t) {
+    case ML_DTYPE_I8:   *dot = ml_row_dot_i8;      *sqdist = ml_row_sqdist_i8;      break;
+    case ML_DTYPE_I16:  *dot = ml_row_dot_i16;     *sqdist = ml_row_sqdist_i16;     break;
+    case ML_DTYPE_I32:  *dot = ml_row_dot_i32;     *sqdist = ml_row_sqdist_i32;     break;
+    case ML_DTYPE_I64:  *dot = ml_row_dot_i64;     *sqdist = ml_row_sqdist_i64;     break;
+    case ML_DTYPE_U8:   *dot = ml_row_dot_u8;      *sqdist = ml_row_sqdist_u8;      break;
+    case ML_DTYPE_U16:  *dot = ml_row_dot_u16;     *sqdist = ml_row_sqdist_u16;     break;
+    case ML_DTYPE_U32:  *dot = ml_row_dot_u32;     *sqdist = ml_row_sqdist_u32;     break;
+    case ML_DTYPE_U64:  *dot = ml_row_dot_u64;     *sqdist = ml_row_sqdist_u64;     break;
+    case ML_DTYPE_SIZE: *dot = ml_row_dot_size;    *sqdist = ml_row_sqdist_size;    break;
+    case ML_DTYPE_F32:  *dot = ml_row_dot_f32;     *sqdist = ml_row_sqdist_f32;     break;
+    case ML_DTYPE_BOOL: *dot = ml_row_dot_boolean; *sqdist = ml_row_sqdist_boolean; break;
+    default:            *dot = ml_row_dot_f64;     *sqdist = ml_row_sqdist_f64;     break;
+    }
+}
+
+int fossil_data_ml_predictor_create(
+    void* model_handle,
+    size_t cols,
+    const char* type_id,
+    void** predictor)
+{
+    if (!predictor) return -1;
+    *predictor = NULL;
+    if (!model_handle || !type_id || cols == 0) return -1;
+    ml_dtype_t dt = ml_dtype(type_id);
+    if (dt == ML_DTYPE_INVALID) return -2;
+
+    const fossil_ml_model_t* m = model_handle;
+    if (m->kind != MODEL_LINEAR && m->kind != MODEL_LOGISTIC && m->kind != MODEL_KMEANS)
+        return -4;
+    if (cols != m->cols) return -1;
+
+    size_t nparams = m->kind == MODEL_KMEANS ? m->k * cols + m->k * m->k : cols;
+    ml_predictor_t* p = malloc(sizeof(*p) + nparams * sizeof(double));
+    if (!p) return -3;
+
+    p->params = (double*)(p + 1);
+    p->kind = m->kind;
+    p->cols = cols;
+    p->k = m->k;
+    p->weights = p->centers = p->center_bounds = NULL;
+    if (m->kind == MODEL_KMEANS) {
+        memcpy(p->params, m->centers, m->k * cols * sizeof(double));
+        memcpy(p->params + m->k * cols, m->center_bounds, m->k * m->k * sizeof(double));
+        p->centers = p->params;
+        p->center_bounds = p->params + m->k * cols;
+    } else {
+        ml_dequantize(m, p->params);
+        p->weights = p->params;
+    }
+    ml_row_kernels(dt, &p->dot, &p->sqdist);
+    p->out = m->kind == MODEL_KMEANS ? ML_DTYPE_I32 : dt;
+    p->threshold = (dt == ML_DTYPE_I32 || dt == ML_DTYPE_I64);
+
+    *predictor = p;
+    return 0;
+}
+
+int fossil_data_ml_predictor_score_one(
+    const void* predictor,
+    const void* row,
+    void* y_out)
+{
+    if (!predictor || !row || !y_out) return -1;
+    const ml_predictor_t* p = predictor;
+    double v;
+
+    if (p->kind == MODEL_KMEANS) {
+        size_t k = p->k, cols = p->cols, best_id = 0;
+        double best = p->sqdist(p->centers, row, cols);
+        for (size_t c = 1; c < k; c++) {
+            if (best <= p->center_bounds[best_id * k + c]) continue;
+            double d = p->sqdist(p->centers + c * cols, row, cols);
+            if (d < best) { best = d; best_id = c; }
+        }
+        *(int32_t*)y_out = (int32_t)best_id;
+        return 0;
+    }
+
+    v = p->dot(p->weights, row, p->cols);
+    if (p->kind == MODEL_LOGISTIC) {
+        v = sigmoid(v);
+        if (p->threshold) v = v >= 0.5 ? 1.0 : 0.0;
+    }
+    ml_store(y_out, 0, 1, p->out, &v);
+    return 0;
+}
+
+int fossil_data_ml_predictor_free(void* predictor)
+{
+    free(predictor);
+    return 0;
+}
+
+int fossil_data_ml_train_path(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const double* alphas,
+    size_t n_alphas,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handles)
+{
+    if (!model_handles || !X || !y || !alphas || !type_id || !model_id || rows == 0 ||
+        cols == 0 || n_alphas == 0)
+        return -1;
+    if (!is_numeric_type(type_id)) return -2;
+
+    fossil_data_ml_options_t defaults;
+    fossil_data_ml_options_init(&defaults);
+    const fossil_data_ml_options_t* opts = options ? options : &defaults;
+
+    double l1, l2;
+    if (ml_cd_penalties(model_id, 0, 0, &l1, &l2) != 0) return -4;
+    if (opts->l1_ratio < 0 || opts->l1_ratio > 1) return -1;
+    for (size_t a = 0; a < n_alphas; a++)
+        if (!(alphas[a] >= 0)) return -1;
+    /* The arguments are valid; only now touch the handles. */
+    for (size_t a = 0; a < n_alphas; a++)
+        model_handles[a] = NULL;
+
+    double *X_owned, *y_owned;
+    const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+    const double* yd = load_f64(y, rows, type_id, &y_owned);
+    ml_cd_t cd;
+    int rc = (Xd && yd) ? ml_cd_init(&cd, Xd, yd, NULL, rows, cols) : -3;
+    free(X_owned);
+    free(y_owned);
+    if (rc != 0) return rc;
+
+    // Each fit starts from the previous solution and its residual
+    double* w = calloc(cols, sizeof(double));
+    size_t passes = opts->max_iter ? opts->max_iter : ML_CD_DEFAULT_PASSES;
+    for (size_t a = 0; rc == 0 && a < n_alphas; a++) {
+        fossil_ml_model_t* m = calloc(1, sizeof(*m));
+        if (m) m->weights = malloc(cols * sizeof(double));
+        if (!w || !m || !m->weights) {
+            if (m) free(m->weights);
+            free(m);
+            rc = -3;
+            break;
+        }
+        ml_cd_penalties(model_id, alphas[a], opts->l1_ratio, &l1, &l2);
+        ml_fit_cd(&cd, w, l1, l2, opts->tol, passes);
+        m->kind = MODEL_LINEAR;
+        m->rows = rows;
+        m->cols = cols;
+        memcpy(m->weights, w, cols * sizeof(double));
+        model_handles[a] = m;
+    }
+    free(w);
+    ml_cd_free(&cd);
+
+    if (rc != 0) {
+        for (size_t a = 0; a < n_alphas; a++) {
+            fossil_data_ml_free_model(model_handles[a]);
+            model_handles[a] = NULL;
+        }
+    }
+    return rc;
+}
+
+/* ============================================================
+   CROSS-VALIDATION
+   ============================================================ */
+
+#define ML_CV_TILE 256   /* validation rows gathered per scoring pass */
+#define ML_CV_COPY_BUDGET ((size_t)256 << 20)   /* training copies of tasks in flight */
+
+typedef enum { ML_CV_MSE, ML_CV_MAE, ML_CV_ACCURACY } ml_cv_metric_t;
+
+/*
+ * Every (grid point, fold) task reads the same f64 copy of X and y.
+ * `order` lists the rows fold by fold, each fold in ascending row order,
+ * and then repeats: the training rows for the fold occupying
+ * [start, end) are the rows - (end - start) entries from order + end,
+ * which wrap round to the fold's start. No fold subset is ever copied.
+ */
+typedef struct {
+    const double* X;
+    const double* y;
+    const size_t* order;        /* 2 x rows */
+    const size_t* fold_start;   /* n_folds + 1 */
+    size_t rows, cols, n_folds;
+    const char* model_id;
+    const fossil_data_ml_options_t* grid;
+    ml_cv_metric_t metric;
+    double* scores;
+    int* rc;                    /* per task */
+} ml_cv_job_t;
+
+static int ml_cv_task(const ml_cv_job_t* job, size_t task)
+{
+    size_t g = task / job->n_folds, f = task % job->n_folds, cols = job->cols;
+    size_t start = job->fold_start[f], end = job->fold_start[f + 1];
+    fossil_ml_model_t* m;
+    int rc = ml_train_view(job->X, job->y, job->order + end, job->rows - (end - start), cols,
+                           job->model_id, &job->grid[g], &m);
+    if (rc != 0) return rc;
+
+    int classify = job->metric == ML_CV_ACCURACY;
+    double* tile = malloc(ML_CV_TILE * cols * sizeof(double));
+    double pred[ML_CV_TILE];
+    double total = 0;
+    if (!tile) rc = -3;
+    for (size_t t = start; rc == 0 && t < end; t += ML_CV_TILE) {
+        size_t n = end - t < ML_CV_TILE ? end - t : ML_CV_TILE;
+        for (size_t r = 0; r < n; r++)
+            memcpy(tile + r * cols, job->X + job->order[t + r] * cols, cols * sizeof(double));
+        if (m->kind == MODEL_KNN)
+            rc = ml_knn_values(m, tile, ML_DTYPE_F64, n, classify, pred);
+        else
+            ml_score_rows(m, m->weights, tile, n, classify, pred);
+        for (size_t r = 0; rc == 0 && r < n; r++) {
+            double err = pred[r] - job->y[job->order[t + r]];
+            if (job->metric == ML_CV_MSE) total += err * err;
+            else if (job->metric == ML_CV_MAE) total += fabs(err);
+            else total += floor(pred[r] + 0.5) == job->y[job->order[t + r]];
+        }
+    }
+    free(tile);
+    fossil_data_ml_free_model(m);
+    if (rc == 0) job->scores[task] = total / (double)(end - start);
+    return rc;
+}
+
+/*
+ * Coordinate descent fits on a transposed copy of their training rows and
+ * kNN keeps its rows in the index, so those tasks each hold about one
+ * copy of the data while they run.
+ */
+static int ml_cv_copies_rows(const char* model_id)
+{
+    return !strcmp(model_id, "ridge") || !strcmp(model_id, "lasso") ||
+           !strcmp(model_id, "elastic_net") || !strcmp(model_id, "knn");
+}
+
+static void ml_cv_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_cv_job_t* job = ctx;
+    (void)chunk;
+    for (size_t t = begin; t < end; t++)
+        job->rc[t] = ml_cv_task(job, t);
+}
+
+/*
+ * Shuffle rows into near-equal folds with the seeded generator, then
+ * bucket them by fold in row order so each fold reads X front to back.
+ */
+static void ml_cv_folds(size_t rows, size_t n_folds, uint64_t seed,
+                        size_t* order, size_t* fold_of, size_t* fold_start)
+{
+    uint64_t state = seed;
+    for (size_t i = 0; i < rows; i++)
+        order[i] = i;
+    for (size_t i = rows - 1; i > 0; i--) {
+        size_t j = (size_t)(ml_rand_next(&state) % (i + 1));
+        size_t swap = order[i]; order[i] = order[j]; order[j] = swap;
+    }
+    for (size_t f = 0; f < n_folds; f++) {
+        size_t lo = f * rows / n_folds, hi = (f + 1) * rows / n_folds;
+        for (size_t i = lo; i < hi; i++)
+            fold_of[order[i]] = f;
+        fold_start[f] = lo;
+    }
+    fold_start[n_folds] = rows;
+
+    size_t* next = order + rows;   /* second half is scratch until the copy below */
+    memcpy(next, fold_start, n_folds * sizeof(size_t));
+    for (size_t i = 0; i < rows; i++)
+        order[next[fold_of[i]]++] = i;
+    memcpy(order + rows, order, rows * sizeof(size_t));
+}
+
+int fossil_data_ml_cross_validate(
+    const void* X,
+    const void* y,
+    size_t rows,
+    size_t cols,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* grid,
+    size_t n_grid,
+    size_t n_folds,
+    const char* metric,
+    double* scores,
+    size_t* best)
+{
+    if (!X || !y || !type_id || !model_id || !grid || !scores || rows == 0 || cols == 0 ||
+        n_grid == 0 || n_folds < 2 || n_folds > rows)
+        return -1;
+    if (!is_numeric_type(type_id)) return -2;
+    if (!strcmp(model_id, "kmeans")) return -4;
+
+    ml_cv_metric_t kind;
+    if (!metric || !strcmp(metric, "mse")) kind = ML_CV_MSE;
+    else if (!strcmp(metric, "mae")) kind = ML_CV_MAE;
+    else if (!strcmp(metric, "accuracy")) kind = ML_CV_ACCURACY;
+    else return -1;
+
+    size_t n_tasks = n_grid * n_folds;
+    size_t* order = malloc(2 * rows * sizeof(size_t));
+    size_t* fold_of = malloc(rows * sizeof(size_t));
+    size_t* fold_start = malloc((n_folds + 1) * sizeof(size_t));
+    int* task_rc = calloc(n_tasks, sizeof(int));
+    double *X_owned = NULL, *y_owned = NULL;
+    const double* Xd = load_f64(X, rows * cols, type_id, &X_owned);
+    const double* yd = load_f64(y, rows, type_id, &y_owned);
+    int rc = (order && fold_of && fold_start && task_rc && Xd && yd) ? 0 : -3;
+
+    if (rc == 0) {
+        ml_cv_folds(rows, n_folds, grid[0].seed, order, fold_of, fold_start);
+        ml_cv_job_t job = { Xd, yd, order, fold_start, rows, cols, n_folds,
+                            model_id, grid, kind, scores, task_rc };
+        // With a task per thread, fits run whole on workers; otherwise one
+        // after another, each spreading its own work over the pool. Tasks
+        // that copy their rows run as at most `lanes` chunks, which bounds
+        // how many copies are alive at once.
+        size_t threads = fossil_data_parallel_get_threads(), lanes = threads;
+        if (ml_cv_copies_rows(model_id)) {
+            size_t cap = ML_CV_COPY_BUDGET / (rows * cols * sizeof(double));
+            if (cap < lanes) lanes = cap;
+        }
+        if (n_tasks >= threads && lanes > 1)
+            fossil_data_parallel_for(n_tasks, (n_tasks + lanes - 1) / lanes, ml_cv_chunk, &job);
+        else
+            ml_cv_chunk(&job, 0, 0, n_tasks);
+        for (size_t t = 0; t < n_tasks && rc == 0; t++)
+            rc = task_rc[t];
+    }
+
+    if (rc == 0 && best) {
+        double best_mean = 0;
+        for (size_t g = 0; g < n_grid; g++) {
+            double mean = 0;
+            for (size_t f = 0; f < n_folds; f++)
+                mean += scores[g * n_folds + f];
+            mean /= (double)n_folds;
+            int better = kind == ML_CV_ACCURACY ? mean > best_mean : mean < best_mean;
+            if (g == 0 || better) { *best = g; best_mean = mean; }
+        }
+    }
+
+    free(X_owned);
+    free(y_owned);
+    free(task_rc);
+    free(fold_start);
+    free(fold_of);
+    free(order);
+    return rc;
+}
+
+/* ============================================================
+   SPARSE INPUT
+   ============================================================ */
+
+static void ml_csr_free(ml_csr_t* S)
+{
+    free(S->owned_indptr);
+    free(S->owned_indices);
+    free(S->owned_values);
+}
+
+/*
+ * Validate a caller's sparse matrix and view it as f64 CSR. CSC input
+ * is transposed once with a counting pass; columns are visited in
+ * order, so each CSR row comes out sorted.
+ */
+static int ml_csr_from(const fossil_data_ml_sparse_t* X, const char* type_id, ml_csr_t* S)
+{
+    memset(S, 0, sizeof(*S));
+    if (!X || !type_id || !X->layout || !X->indptr || X->rows == 0 || X->cols == 0)
+        return -1;
+    if (!is_numeric_type(type_id)) return -2;
+    int csc;
+    if (!strcmp(X->layout, "csr")) csc = 0;
+    else if (!strcmp(X->layout, "csc")) csc = 1;
+    else return -1;
+
+    size_t outer = csc ? X->cols : X->rows;
+    size_t inner = csc ? X->rows : X->cols;
+    if (X->indptr[0] != 0) return -1;
+    for (size_t o = 0; o < outer; o++)
+        if (X->indptr[o + 1] < X->indptr[o]) return -1;
+    size_t nnz = X->indptr[outer];
+    if (nnz > 0 && (!X->indices || !X->values)) return -1;
+    for (size_t p = 0; p < nnz; p++)
+        if (X->indices[p] >= inner) return -1;
+
+    S->rows = X->rows;
+    S->cols = X->cols;
+    const double* values = nnz ? load_f64(X->values, nnz, type_id, &S->owned_values) : NULL;
+    if (nnz && !values) return -3;
+    if (!csc) {
+        S->indptr = X->indptr;
+        S->indices = X->indices;
+        S->values = values;
+        return 0;
+    }
+
+    size_t* indptr = calloc(X->rows + 1, sizeof(size_t));
+    size_t* indices = malloc((nnz ? nnz : 1) * sizeof(size_t));
+    double* out = malloc((nnz ? nnz : 1) * sizeof(double));
+    if (!indptr || !indices || !out) {
+        free(indptr); free(indices); free(out);
+        ml_csr_free(S);
+        return -3;
+    }
+    for (size_t p = 0; p < nnz; p++)
+        indptr[X->indices[p] + 1]++;
+    for (size_t r = 0; r < X->rows; r++)
+        indptr[r + 1] += indptr[r];
+    size_t* fill = malloc(X->rows * sizeof(size_t));
+    if (!fill) {
+        free(indptr); free(indices); free(out);
+        ml_csr_free(S);
+        return -3;
+    }
+    memcpy(fill, indptr, X->rows * sizeof(size_t));
+    for (size_t c = 0; c < X->cols; c++) {
+        for (size_t p = X->indptr[c]; p < X->indptr[c + 1]; p++) {
+            size_t dst = fill[X->indices[p]]++;
+            indices[dst] = c;
+            out[dst] = values[p];
+        }
+    }
+    free(fill);
+    free(S->owned_values);
+    S->owned_indptr = indptr;
+    S->owned_indices = indices;
+    S->owned_values = out;
+    S->indptr = indptr;
+    S->indices = indices;
+    S->values = out;
+    return 0;
+}
+
+static double ml_csr_row_dot(const ml_csr_t* S, size_t i, const double* w)
+{
+    size_t at = S->indptr[i];
+    return ml_sparse_dot(w, S->indices + at, S->values + at, S->indptr[i + 1] - at);
+}
+
+/* Squared norms of k dense centers. */
+static void ml_center_norms(const double* centers, size_t k, size_t cols, double* norms)
+{
+    for (size_t c = 0; c < k; c++)
+        norms[c] = ml_dot(centers + c * cols, centers + c * cols, cols);
+}
+
+/*
+ * Nearest center of a sparse row: |x - c|^2 = |x|^2 - 2 x.c + |c|^2, and
+ * |x|^2 is the same for every center, so only the sparse dot remains.
+ */
+static size_t ml_sparse_nearest(const ml_csr_t* S, size_t i, const double* centers,
+                                const double* norms, size_t k, size_t cols, double* score)
+{
+    size_t best_id = 0;
+    double best = norms[0] - 2 * ml_csr_row_dot(S, i, centers);
+    for (size_t c = 1; c < k; c++) {
+        double d = norms[c] - 2 * ml_csr_row_dot(S, i, centers + c * cols);
+        if (d < best) { best = d; best_id = c; }
+    }
+    if (score) *score = best;
+    return best_id;
+}
+
+typedef struct {
+    const ml_csr_t* S;
+    const double* centers;
+    const double* norms;
+    size_t k;
+    size_t* labels;
+    size_t* changed;   /* per chunk */
+    const double* xnorm;
+    double* mind;      /* seeding: squared distance to the nearest center */
+    double* totals;    /* seeding: per-chunk sum of mind */
+    int first;
+} ml_sparse_kmeans_job_t;
+
+static void ml_sparse_assign_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_sparse_kmeans_job_t* job = ctx;
+    size_t changed = 0;
+    for (size_t i = begin; i < end; i++) {
+        size_t c = ml_sparse_nearest(job->S, i, job->centers, job->norms,
+                                     job->k, job->S->cols, NULL);
+        if (c != job->labels[i]) { job->labels[i] = c; changed++; }
+    }
+    job->changed[chunk] = changed;
+}
+
+/* k-means++ distance update against the newest center job->centers. */
+static void ml_sparse_seed_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_sparse_kmeans_job_t* job = ctx;
+    double cnorm = job->norms[0], total = 0;
+    for (size_t i = begin; i < end; i++) {
+        double d = job->xnorm[i] + cnorm - 2 * ml_csr_row_dot(job->S, i, job->centers);
+        if (d < 0) d = 0;
+        if (job->first || d < job->mind[i]) job->mind[i] = d;
+        total += job->mind[i];
+    }
+    job->totals[chunk] = total;
+}
+
+static void ml_csr_densify_row(const ml_csr_t* S, size_t i, double* out)
+{
+    memset(out, 0, S->cols * sizeof(double));
+    for (size_t p = S->indptr[i]; p < S->indptr[i + 1]; p++)
+        out[S->indices[p]] += S->values[p];
+}
+
+/* Same seeding rules and random stream as the dense ml_kmeans_seed. */
+static int ml_sparse_kmeans_seed(const ml_csr_t* S, const fossil_data_ml_options_t* opts,
+                                 double* centers)
+{
+    size_t rows = S->rows, cols = S->cols, k = opts->k;
+    if (opts->init && !strcmp(opts->init, "first")) {
+        for (size_t c = 0; c < k; c++)
+            ml_csr_densify_row(S, c, centers + c * cols);
+        return 0;
+    }
+    if (opts->init && strcmp(opts->init, "kmeans++")) return -1;
+
+    size_t grain = ml_kmeans_grain(rows, 0);
+    size_t chunks = fossil_data_parallel_chunks(rows, grain);
+    double* xnorm = malloc(rows * sizeof(double));
+    double* mind = malloc(rows * sizeof(double));
+    double* totals = malloc(chunks * sizeof(double));
+    if (!xnorm || !mind || !totals) { free(xnorm); free(mind); free(totals); return -3; }
+    for (size_t i = 0; i < rows; i++) {
+        size_t at = S->indptr[i], nnz = S->indptr[i + 1] - at;
+        xnorm[i] = ml_dot(S->values + at, S->values + at, nnz);
+    }
+
+    uint64_t state = opts->seed;
+    size_t pick = (size_t)(ml_rand_unit(&state) * rows);
+    double cnorm;
+    ml_sparse_kmeans_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.S = S;
+    job.norms = &cnorm;
+    job.xnorm = xnorm;
+    job.mind = mind;
+    job.totals = totals;
+    job.first = 1;
+
+    for (size_t c = 0; c < k; c++) {
+        if (c > 0) {
+            double total = 0;
+            for (size_t ch = 0; ch < chunks; ch++)
+                total += totals[ch];
+            pick = rows - 1;
+            if (total > 0) {
+                double r = ml_rand_unit(&state) * total;
+                size_t ch = 0;
+                while (ch + 1 < chunks && r >= totals[ch]) r -= totals[ch++];
+                size_t end = (ch + 1) * grain < rows ? (ch + 1) * grain : rows;
+                for (size_t i = ch * grain; i < end; i++) {
+                    r -= mind[i];
+                    pick = i;
+                    if (r < 0) break;
+                }
+            } else {
+                pick = (size_t)(ml_rand_unit(&state) * rows);
+            }
+        }
+        double* center = centers + c * cols;
+        ml_csr_densify_row(S, pick, center);
+        cnorm = ml_dot(center, center, cols);
+        job.centers = center;
+        fossil_data_parallel_for(rows, grain, ml_sparse_seed_chunk, &job);
+        job.first = 0;
+    }
+
+    free(totals);
+    free(mind);
+    free(xnorm);
+    return 0;
+}
+
+/*
+ * Lloyd iterations over sparse rows: assignment costs O(nnz * k) and runs
+ * on the pool; the update adds only stored values into the center sums.
+ */
+static int ml_fit_kmeans_sparse(const ml_csr_t* S, const fossil_data_ml_options_t* opts,
+                                fossil_ml_model_t* m)
+{
+    size_t rows = S->rows, cols = S->cols, k = m->k;
+    size_t max_iter = opts->max_iter ? opts->max_iter : ML_KMEANS_DEFAULT_ITERS;
+    int rc = ml_sparse_kmeans_seed(S, opts, m->centers);
+    if (rc != 0) return rc;
+
+    size_t grain = ml_kmeans_grain(rows, 0);
+    size_t chunks = fossil_data_parallel_chunks(rows, grain);
+    size_t* labels = malloc(rows * sizeof(size_t));
+    size_t* changed = malloc(chunks * sizeof(size_t));
+    double* norms = malloc(k * sizeof(double));
+    double* sums = malloc(k * cols * sizeof(double));
+    size_t* counts = m->center_counts;
+    if (!labels || !changed || !norms || !sums) rc = -3;
+
+    ml_sparse_kmeans_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.S = S;
+    job.centers = m->centers;
+    job.norms = norms;
+    job.k = k;
+    job.labels = labels;
+    job.changed = changed;
+
+    for (size_t i = 0; rc == 0 && i < rows; i++) labels[i] = k;
+    double tol2 = opts->tol * opts->tol;
+    for (size_t it = 0; rc == 0 && it < max_iter; it++) {
+        ml_center_norms(m->centers, k, cols, norms);
+        fossil_data_parallel_for(rows, grain, ml_sparse_assign_chunk, &job);
+        size_t moved_rows = 0;
+        for (size_t ch = 0; ch < chunks; ch++)
+            moved_rows += changed[ch];
+        if (moved_rows == 0) break;
+
+        memset(sums, 0, k * cols * sizeof(double));
+        memset(counts, 0, k * sizeof(size_t));
+        for (size_t i = 0; i < rows; i++) {
+            double* sum = sums + labels[i] * cols;
+            for (size_t p = S->indptr[i]; p < S->indptr[i + 1]; p++)
+                sum[S->indices[p]] += S->values[p];
+            counts[labels[i]]++;
+        }
+        double shift = 0;
+        for (size_t c = 0; c < k; c++) {
+            if (counts[c] == 0) continue;
+            double* center = m->centers + c * cols;
+            double moved = 0;
+            for (size_t j = 0; j < cols; j++) {
+                double v = sums[c * cols + j] / (double)counts[c];
+                double diff = v - center[j];
+                moved += diff * diff;
+                center[j] = v;
+            }
+            if (moved > shift) shift = moved;
+        }
+        if (shift <= tol2) break;
+    }
+
+    free(sums);
+    free(norms);
+    free(changed);
+    free(labels);
+    if (rc == 0) rc = ml_kmeans_finalize(m);
+    return rc;
+}
+
+int fossil_data_ml_train_sparse(
+    const fossil_data_ml_sparse_t* X,
+    const void* y,
+    const char* type_id,
+    const char* model_id,
+    const fossil_data_ml_options_t* options,
+    void** model_handle)
+{
+    if (!model_handle) return -1;
+    *model_handle = NULL;
+    if (!model_id) return -1;
+    int kmeans = !strcmp(model_id, "kmeans");
+    int logistic = !strcmp(model_id, "logistic_regression");
+    if (!kmeans && !logistic && strcmp(model_id, "linear_regression")) return -4;
+    if (!kmeans && !y) return -1;
+
+    fossil_data_ml_options_t defaults;
+    fossil_data_ml_options_init(&defaults);
+    const fossil_data_ml_options_t* opts = options ? options : &defaults;
+
+    ml_csr_t S;
+    int rc = ml_csr_from(X, type_id, &S);
+    if (rc != 0) return rc;
+
+    fossil_ml_model_t* m = NULL;
+    if (kmeans) {
+        if (opts->k == 0 || opts->k > S.rows) {
+            rc = -1;
+        } else {
+            m = ml_kmeans_alloc(opts->k, S.cols);
+            rc = m ? ml_fit_kmeans_sparse(&S, opts, m) : -3;
+        }
+    } else {
+        m = calloc(1, sizeof(*m));
+        double* y_owned = NULL;
+        const double* yd = m ? load_f64(y, S.rows, type_id, &y_owned) : NULL;
+        if (m) {
+            m->kind = logistic ? MODEL_LOGISTIC : MODEL_LINEAR;
+            m->cols = S.cols;
+            m->weights = calloc(S.cols, sizeof(double));
+        }
+        rc = (m && yd && m->weights)
+            ? ml_fit_gradient(NULL, &S, NULL, yd, 1, NULL, S.rows, S.cols, 1, logistic,
+                              ml_regression_lr(opts, logistic),
+                              ml_regression_iters(opts, logistic), &opts->l2, m->weights)
+            : -3;
+        free(y_owned);
+    }
+    if (m) m->rows = S.rows;
+    ml_csr_free(&S);
+
+    if (rc != 0) {
+        fossil_data_ml_free_model(m);
+        return rc;
+    }
+    *model_handle = m;
+    return 0;
+}
+
+typedef struct {
+    const fossil_ml_model_t* m;
+    const ml_csr_t* S;
+    const double* weights;   /* regression, dequantized when needed */
+    const double* norms;     /* kmeans center norms */
+    void* y;
+    ml_dtype_t out;
+    int threshold;
+} ml_sparse_predict_job_t;
+
+/* Value of feature f in sparse row i; rows are short, so a scan is enough. */
+static double ml_csr_value(const ml_csr_t* S, size_t i, size_t f)
+{
+    double v = 0;
+    for (size_t p = S->indptr[i]; p < S->indptr[i + 1]; p++)
+        if (S->indices[p] == f) v += S->values[p];
+    return v;
+}
+
+static double ml_csr_tree_score(const ml_csr_t* S, size_t i, const fossil_ml_model_t* m)
+{
+    double sum = 0;
+    for (size_t t = 0; t < m->n_trees; t++) {
+        size_t at = m->roots[t];
+        while (m->nodes[at].feature >= 0) {
+            const ml_tree_node_t* node = &m->nodes[at];
+            at = ml_csr_value(S, i, (size_t)node->feature) <= node->value ? at + 1 : node->right;
+        }
+        sum += m->nodes[at].value;
+    }
+    return sum;
+}
+
+static void ml_sparse_predict_chunk(void* ctx, size_t chunk, size_t begin, size_t end)
+{
+    ml_sparse_predict_job_t* job = ctx;
+    const fossil_ml_model_t* m = job->m;
+    double scores[ML_PREDICT_TILE];
+    size_t n = end - begin;
+    (void)chunk;
+
+    for (size_t r = 0; r < n; r++) {
+        if (m->kind == MODEL_KMEANS)
+            scores[r] = (double)ml_sparse_nearest(job->S, begin + r, m->centers, job->norms,
+                                                  m->k, m->cols, NULL);
+        else if (ml_is_tree(m))
+            scores[r] = ml_csr_tree_score(job->S, begin + r, m);
+        else
+            scores[r] = ml_csr_row_dot(job->S, begin + r, job->weights);
+    }
+    ml_link(m, n, job->threshold, scores);
+    ml_store(job->y, begin, n, job->out, scores);
+}
+
+int fossil_data_ml_predict_sparse(
+    const fossil_data_ml_sparse_t* X,
+    void* y_pred,
+    void* model_handle,
+    const char* type_id)
+{
+    if (!model_handle || !y_pred) return -1;
+    fossil_ml_model_t* m = model_handle;
+    if (m->kind != MODEL_LINEAR && m->kind != MODEL_LOGISTIC && m->kind != MODEL_KMEANS &&
+        !ml_is_tree(m))
+        return -4;
+    if (X && X->cols != m->cols) return -1;
+
+    ml_csr_t S;
+    int rc = ml_csr_from(X, type_id, &S);
+    if (rc != 0) return rc;
+
+    ml_dtype_t dt = ml_dtype(type_id);
+    ml_sparse_predict_job_t job;
+    job.m = m;
+    job.S = &S;
+    job.weights = m->weights;
+    job.norms = NULL;
+    job.y = y_pred;
+    job.out = m->kind == MODEL_KMEANS ? ML_DTYPE_I32 : dt;
+    job.threshold = (dt == ML_DTYPE_I32 || dt == ML_DTYPE_I64);
+
+    double* scratch = NULL;
+    if (m->kind == MODEL_KMEANS) {
+        scratch = malloc(m->k * sizeof(double));
+        if (scratch) ml_center_norms(m->centers, m->k, m->cols, scratch);
+        job.norms = scratch;
+    } else if (m->precision != ML_PREC_F64) {
+        scratch = malloc(m->cols * sizeof(double));
+        if (scratch) ml_dequantize(m, scratch);
+        job.weights = scratch;
+    }
+    if ((m->kind == MODEL_KMEANS || m->precision != ML_PREC_F64) && !scratch) rc = -3;
+
+    if (rc == 0)
+        fossil_data_parallel_for(S.rows, ML_PREDICT_TILE, ml_sparse_predict_chunk, &job);
+
+    free(scratch);
+    ml_csr_free(&S);
+    return rc;
+}
+
+/* ============================================================
+   SERIALIZATION
+   ============================================================ */
+
+/*
+ * File layout (native little-endian, all offsets from the file start):
+ *
+ *   ml_file_header_t        128 bytes
+ *   weights  [cols]         regression only, element type per precision
+ *   centers  double[k*cols] kmeans only
+ *   bounds   double[k*k]    kmeans only
+ *   counts   uint64_t[k]    kmeans only
+ *   nodes    ml_tree_node_t[n_nodes]  trees only, every tree in preorder
+ *
+ * Each section starts on an ML_FILE_ALIGN boundary so a mapped file can
+ * be used in place: loaded models point their arrays into the file image
+ * and only the small count array is converted.
+ */
+#define ML_FILE_MAGIC   "FOSSILML"
+#define ML_FILE_VERSION 1u
+#define ML_FILE_ENDIAN  0x01020304u
+#define ML_FILE_ALIGN   64
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t kind;
+    uint32_t precision;      /* ml_precision_t of the weights section */
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t k;
+    uint64_t weights_off;
+    uint64_t centers_off;
+    uint64_t bounds_off;
+    uint64_t counts_off;
+    uint64_t file_size;
+    double qscale;
+    uint64_t nodes_off;
+    uint64_t n_nodes;
+    uint64_t n_trees;
+    uint64_t pad;
+} ml_file_header_t;
+
+static size_t ml_precision_size(ml_precision_t p)
+{
+    switch (p) {
+    case ML_PREC_F32: return sizeof(float);
+    case ML_PREC_I16: return sizeof(int16_t);
+    case ML_PREC_I8:  return sizeof(int8_t);
+    default:          return sizeof(double);
+    }
+}
+
+typedef char ml_file_header_size_check[sizeof(ml_file_header_t) == 128 ? 1 : -1];
+
+static uint64_t ml_file_section(uint64_t* at, uint64_t bytes)
+{
+    uint64_t off = *at;
+    *at = (off + bytes + ML_FILE_ALIGN - 1) / ML_FILE_ALIGN * ML_FILE_ALIGN;
+    return off;
+}
+
+static FILE* ml_fopen(const char* path, const char* mode)
+{
+#if defined(_MSC_VER)
+    FILE* f = NULL;
+    return fopen_s(&f, path, mode) == 0 ? f : NULL;
+#else
+    return fopen(path, mode);
+#endif
+}
+
+/* Zero-pad from *pos up to the section offset `at`, then write the section. */
+static int ml_file_write(FILE* f, uint64_t* pos, uint64_t at, const void* data, size_t bytes)
+{
+    static const char zeros[ML_FILE_ALIGN];
+    size_t gap = (size_t)(at - *pos);
+    if (at < *pos || gap > ML_FILE_ALIGN) return -5;
+    if (fwrite(zeros, 1, gap, f) != gap || fwrite(data, 1, bytes, f) != bytes)
+        return -5;
+    *pos = at + bytes;
+    return 0;
+}
+
+int fossil_data_ml_save_model(const void* model_handle, const char* path)
+{
+    if (!model_handle || !path) return -1;
+    const fossil_ml_model_t* m = model_handle;
+    if (m->kind != MODEL_LINEAR && m->kind != MODEL_LOGISTIC && m->kind != MODEL_KMEANS &&
+        !ml_is_tree(m))
+        return -4;
+
+    ml_file_header_t h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, ML_FILE_MAGIC, sizeof(h.magic));
+    h.version = ML_FILE_VERSION;
+    h.endian = ML_FILE_ENDIAN;
+    h.kind = (uint32_t)m->kind;
+    h.rows = m->rows;
+    h.cols = m->cols;
+    h.k = m->kind == MODEL_KMEANS ? m->k : 0;
+
+    uint64_t at = sizeof(h);
+    uint64_t* counts = NULL;
+    if (ml_is_tree(m)) {
+        h.n_nodes = m->n_nodes;
+        h.n_trees = m->n_trees;
+        h.nodes_off = ml_file_section(&at, h.n_nodes * sizeof(ml_tree_node_t));
+    } else if (m->kind == MODEL_KMEANS) {
+        h.centers_off = ml_file_section(&at, h.k * h.cols * sizeof(double));
+        if (m->center_bounds)
+            h.bounds_off = ml_file_section(&at, h.k * h.k * sizeof(double));
+        if (m->center_counts) {
+            h.counts_off = ml_file_section(&at, h.k * sizeof(uint64_t));
+            counts = malloc(m->k * sizeof(uint64_t));
+            if (!counts) return -3;
+            for (size_t c = 0; c < m->k; c++) counts[c] = m->center_counts[c];
+        }
+    } else {
+        h.precision = (uint32_t)m->precision;
+        h.qscale = m->qscale;
+        h.weights_off = ml_file_section(&at, h.cols * ml_precision_size(m->precision));
+    }
+    h.file_size = at;
+
+    FILE* f = ml_fopen(path, "wb");
+    uint64_t pos = 0;
+    int rc = f ? 0 : -5;
+    if (rc == 0) rc = ml_file_write(f, &pos, 0, &h, sizeof(h));
+    if (rc == 0 && h.weights_off)
+        rc = ml_file_write(f, &pos, h.weights_off,
+                           m->precision == ML_PREC_F64 ? (const void*)m->weights : m->qweights,
+                           m->cols * ml_precision_size(m->precision));
+    if (rc == 0 && h.centers_off)
+        rc = ml_file_write(f, &pos, h.centers_off, m->centers, m->k * m->cols * sizeof(double));
+    if (rc == 0 && h.bounds_off)
+        rc = ml_file_write(f, &pos, h.bounds_off, m->center_bounds, m->k * m->k * sizeof(double));
+    if (rc == 0 && h.counts_off)
+        rc = ml_file_write(f, &pos, h.counts_off, counts, m->k * sizeof(uint64_t));
+    if (rc == 0 && h.nodes_off)
+        rc = ml_file_write(f, &pos, h.nodes_off, m->nodes, m->n_nodes * sizeof(ml_tree_node_t));
+    if (rc == 0) rc = ml_file_write(f, &pos, h.file_size, "", 0);
+    if (f && fclose(f) != 0 && rc == 0) rc = -5;
+    free(counts);
+    return rc;
+}
+
+/* Read a whole file into a heap block. */
+static int ml_file_read(const char* path, void** data, size_t* size)
+{
+    FILE* f = ml_fopen(path, "rb");
+    if (!f) return -5;
+    int rc = -5;
+    long len;
+    if (fseek(f, 0, SEEK_END) == 0 && (len = ftell(f)) > 0 && fseek(f, 0, SEEK_SET) == 0) {
+        *data = malloc((size_t)len);
+        if (!*data) {
+            rc = -3;
+        } else if (fread(*data, 1, (size_t)len, f) == (size_t)len) {
+            *size = (size_t)len;
+            rc = 0;
+        } else {
+            free(*data);
+        }
+    }
+    fclose(f);
+    return rc;
+}
+
+/*
+ * Map a file copy-on-write: the model reads the file image in place, and
+ * a later partial_fit writes private pages without touching the file.
+ */
+static int ml_file_map(const char* path, void** data, size_t* size)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -5;
+    LARGE_INTEGER len;
+    HANDLE mapping = NULL;
+    void* view = NULL;
+    if (GetFileSizeEx(file, &len) && len.QuadPart > 0 && (uint64_t)len.QuadPart <= SIZE_MAX)
+        mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (mapping) {
+        view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if (!view) return -5;
+    *data = view;
+    *size = (size_t)len.QuadPart;
+    return 0;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -5;
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= SIZE_MAX)
+        view = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) return -5;
+    *data = view;
+    *size = (size_t)st.st_size;
+    return 0;
+#endif
+}
+
+static void ml_file_release(void* data, size_t size, int mapped)
+{
+    if (!data) return;
+    if (!mapped) {
+        free(data);
+        return;
+    }
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+/* Check that a section of `bytes` at `off` lies inside the image and is aligned. */
+static int ml_file_section_ok(uint64_t off, uint64_t count, uint64_t elem, uint64_t size)
+{
+    if (off < sizeof(ml_file_header_t) || off % ML_FILE_ALIGN || off > size) return 0;
+    if (count != 0 && elem > (size - off) / count) return 0;
+    return 1;
+}
+
+static int ml_file_validate(const ml_file_header_t* h, size_t size)
+{
+    if (size < sizeof(*h) || memcmp(h->magic, ML_FILE_MAGIC, sizeof(h->magic)) != 0)
+        return 0;
+    if (h->version != ML_FILE_VERSION || h->endian != ML_FILE_ENDIAN || h->file_size != size)
+        return 0;
+    if (h->cols == 0 || h->cols > SIZE_MAX / sizeof(double)) return 0;
+    if (h->kind == MODEL_DECISION_TREE || h->kind == MODEL_GRADIENT_BOOSTING)
+        return h->n_nodes > 0 && h->n_nodes <= UINT32_MAX && h->n_trees > 0 &&
+               h->n_trees <= h->n_nodes &&
+               ml_file_section_ok(h->nodes_off, h->n_nodes, sizeof(ml_tree_node_t), size);
+    if (h->kind == MODEL_LINEAR || h->kind == MODEL_LOGISTIC)
+        return h->precision <= ML_PREC_I8 &&
+               ml_file_section_ok(h->weights_off, h->cols,
+                                  ml_precision_size((ml_precision_t)h->precision), size);
+    if (h->kind != MODEL_KMEANS || h->k == 0 || h->k > SIZE_MAX / h->cols / sizeof(double))
+        return 0;
+    if (!ml_file_section_ok(h->centers_off, h->k * h->cols, sizeof(double), size))
+        return 0;
+    if (h->bounds_off &&
+        (h->k > SIZE_MAX / h->k / sizeof(double) ||
+         !ml_file_section_ok(h->bounds_off, h->k * h->k, sizeof(double), size)))
+        return 0;
+    if (h->counts_off && !ml_file_section_ok(h->counts_off, h->k, sizeof(uint64_t), size))
+        return 0;
+    return 1;
+}
+
+int fossil_data_ml_load_model(const char* path, const char* mode, void** model_handle)
+{
+    if (!model_handle) return -1;
+    *model_handle = NULL;
+    if (!path) return -1;
+    int mapped;
+    if (!mode || strcmp(mode, "copy") == 0) mapped = 0;
+    else if (strcmp(mode, "mmap") == 0) mapped = 1;
+    else return -1;
+
+    void* image = NULL;
+    size_t size = 0;
+    int rc = mapped ? ml_file_map(path, &image, &size) : ml_file_read(path, &image, &size);
+    if (rc != 0) return rc;
+
+    ml_file_header_t h;
+    if (size >= sizeof(h)) memcpy(&h, image, sizeof(h));
+    if (!ml_file_validate(&h, size)) {
+        ml_file_release(image, size, mapped);
+        return -5;
+    }
+
+    fossil_ml_model_t* m = calloc(1, sizeof(*m));
+    if (!m) {
+        ml_file_release(image, size, mapped);
+        return -3;
+    }
+    char* base = image;
+    m->kind = (fossil_ml_model_kind_t)h.kind;
+    m->rows = (size_t)h.rows;
+    m->cols = (size_t)h.cols;
+    m->backing = image;
+    m->backing_size = size;
+    m->backing_mapped = mapped;
+
+    if (ml_is_tree(m)) {
+        m->nodes = (ml_tree_node_t*)(base + h.nodes_off);
+        m->n_nodes = (size_t)h.n_nodes;
+        rc = ml_tree_index(m, (size_t)h.n_trees);
+    } else if (m->kind == MODEL_KMEANS) {
+        m->k = (size_t)h.k;
+        m->centers = (double*)(base + h.centers_off);
+        if (h.bounds_off) m->center_bounds = (double*)(base + h.bounds_off);
+        if (h.counts_off) {
+            const uint64_t* counts = (const uint64_t*)(base + h.counts_off);
+            m->center_counts = malloc(m->k * sizeof(size_t));
+            if (!m->center_counts) rc = -3;
+            for (size_t c = 0; rc == 0 && c < m->k; c++)
+                m->center_counts[c] = (size_t)counts[c];
+        }
+        if (rc == 0 && !m->center_bounds) rc = ml_kmeans_finalize(m);
+    } else {
+        m->precision = (ml_precision_t)h.precision;
+        m->qscale = h.qscale;
+        if (m->precision == ML_PREC_F64) {
+            m->weights = (double*)(base + h.weights_off);
+        } else {
+            m->qweights = base + h.weights_off;
+        }
+    }
+
+    if (rc != 0) {
+        fossil_data_ml_free_model(m);
+        return rc;
+    }
+    *model_handle = m;
+    return 0;
+}
+
+/* ============================================================
+   FREE
+   ============================================================ */
+
+int fossil_data_ml_free_model(void* model_handle)
+{
+    if(!model_handle)
+        return 0; /* treat null as already freed, not an error */
+
+    fossil_ml_model_t* m = model_handle;
+    if (m->weights && ml_owned(m, m->weights))
         free(m->weights);
-    if (m->centers)
+    if (m->qweights && ml_owned(m, m->qweights))
+        free(m->qweights);
+    if (m->centers && ml_owned(m, m->centers))
         free(m->centers);
+    if (m->center_bounds && ml_owned(m, m->center_bounds))
+        free(m->center_bounds);
+    if (m->center_counts)
+        free(m->center_counts);
+    if (m->nodes && ml_owned(m, m->nodes))
+        free(m->nodes);
+    free(m->roots);
+    free(m->list_vectors);
+    free(m->list_ids);
+    free(m->list_offsets);
+    free(m->targets);
 
+    ml_file_release(m->backing, m->backing_size, m->backing_mapped);
     free(m);
     return 0;
 }
@@ -0,0 +1,296 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/data/parallel.h"
+
+#include <stdint.h>
+
+#if !defined(FOSSIL_DATA_NO_THREADS)
+#  if defined(_WIN32)
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#    include <unistd.h>
+#  endif
+#endif
+
+#define FOSSIL_DATA_PARALLEL_MAX_THREADS 256
+
+/* ---------------------------------------------------------
+ * Serial fallback
+ * --------------------------------------------------------- */
+
+size_t fossil_data_parallel_chunks(size_t count, size_t grain)
+{
+    if (grain == 0) grain = 1;
+    return count / grain + (count % grain != 0);
+}
+
+static void run_inline(size_t count, size_t grain, fossil_data_parallel_fn fn, void* ctx)
+{
+    size_t chunks = fossil_data_parallel_chunks(count, grain);
+    for (size_t c = 0; c < chunks; c++) {
+        size_t begin = c * grain;
+        size_t end = begin + grain < count ? begin + grain : count;
+        fn(ctx, c, begin, end);
+    }
+}
+
+#if defined(FOSSIL_DATA_NO_THREADS)
+
+int fossil_data_parallel_set_threads(size_t threads)
+{
+    (void)threads;
+    return 0;
+}
+
+size_t fossil_data_parallel_get_threads(void)
+{
+    return 1;
+}
+
+int fossil_data_parallel_for(size_t count, size_t grain, fossil_data_parallel_fn fn, void* ctx)
+{
+    if (!fn) return -1;
+    if (grain == 0) grain = 1;
+    run_inline(count, grain, fn, ctx);
+    return 0;
+}
+
+#else
+
+/* ---------------------------------------------------------
+ * Platform primitives
+ * --------------------------------------------------------- */
+
+#if defined(_WIN32)
+typedef SRWLOCK pool_mutex_t;
+typedef CONDITION_VARIABLE pool_cond_t;
+#define POOL_MUTEX_INIT SRWLOCK_INIT
+#define POOL_COND_INIT CONDITION_VARIABLE_INIT
+static void pool_lock(pool_mutex_t* m) { AcquireSRWLockExclusive(m); }
+static void pool_unlock(pool_mutex_t* m) { ReleaseSRWLockExclusive(m); }
+static int pool_trylock(pool_mutex_t* m) { return TryAcquireSRWLockExclusive(m) ? 0 : -1; }
+static void pool_wait(pool_cond_t* c, pool_mutex_t* m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static void pool_signal(pool_cond_t* c) { WakeConditionVariable(c); }
+static void pool_broadcast(pool_cond_t* c) { WakeAllConditionVariable(c); }
+#else
+typedef pthread_mutex_t pool_mutex_t;
+typedef pthread_cond_t pool_cond_t;
+#define POOL_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define POOL_COND_INIT PTHREAD_COND_INITIALIZER
+static void pool_lock(pool_mutex_t* m) { pthread_mutex_lock(m); }
+static void pool_unlock(pool_mutex_t* m) { pthread_mutex_unlock(m); }
+static int pool_trylock(pool_mutex_t* m) { return pthread_mutex_trylock(m); }
+static void pool_wait(pool_cond_t* c, pool_mutex_t* m) { pthread_cond_wait(c, m); }
+static void pool_signal(pool_cond_t* c) { pthread_cond_signal(c); }
+static void pool_broadcast(pool_cond_t* c) { pthread_cond_broadcast(c); }
+#endif
+
+/* ---------------------------------------------------------
+ * Pool state
+ *
+ * `lock` guards every field below. `region` is held for the
+ * whole duration of a parallel region; a region that cannot
+ * take it runs inline instead of queueing.
+ * --------------------------------------------------------- */
+
+static pool_mutex_t pool_region = POOL_MUTEX_INIT;
+static pool_mutex_t pool_mutex = POOL_MUTEX_INIT;
+static pool_cond_t pool_wake = POOL_COND_INIT;
+static pool_cond_t pool_done = POOL_COND_INIT;
+
+static size_t pool_requested = 0;   /* 0 = hardware default */
+static size_t pool_workers = 0;     /* threads spawned so far */
+static size_t pool_generation = 0;
+
+static struct {
+    fossil_data_parallel_fn fn;
+    void* ctx;
+    size_t count;
+    size_t grain;
+    size_t chunks;
+    size_t next;
+    size_t active;      /* workers taking part in this region */
+    size_t pending;     /* active workers not yet finished */
+} pool_job;
+
+static size_t hardware_threads(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+#else
+    return 1;
+#endif
+}
+
+static size_t clamp_threads(size_t n)
+{
+    if (n == 0) n = hardware_threads();
+    if (n > FOSSIL_DATA_PARALLEL_MAX_THREADS) n = FOSSIL_DATA_PARALLEL_MAX_THREADS;
+    return n;
+}
+
+/* Claim and run chunks of the current job until none are left. */
+static void drain_chunks(void)
+{
+    for (;;) {
+        pool_lock(&pool_mutex);
+        size_t c = pool_job.next;
+        if (c < pool_job.chunks) pool_job.next++;
+        fossil_data_parallel_fn fn = pool_job.fn;
+        void* ctx = pool_job.ctx;
+        size_t count = pool_job.count;
+        size_t grain = pool_job.grain;
+        size_t chunks = pool_job.chunks;
+        pool_unlock(&pool_mutex);
+
+        if (c >= chunks) return;
+        size_t begin = c * grain;
+        size_t end = begin + grain < count ? begin + grain : count;
+        fn(ctx, c, begin, end);
+    }
+}
+
+static void worker_loop(size_t id)
+{
+    size_t seen = 0;
+
+    pool_lock(&pool_mutex);
+    for (;;) {
+        while (pool_generation == seen)
+            pool_wait(&pool_wake, &pool_mutex);
+        seen = pool_generation;
+        if (id >= pool_job.active)
+            continue;
+
+        pool_unlock(&pool_mutex);
+        drain_chunks();
+        pool_lock(&pool_mutex);
+
+        if (--pool_job.pending == 0)
+            pool_signal(&pool_done);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI worker_main(LPVOID arg)
+{
+    worker_loop((size_t)(uintptr_t)arg);
+    return 0;
+}
+#else
+static void* worker_main(void* arg)
+{
+    worker_loop((size_t)(uintptr_t)arg);
+    return NULL;
+}
+#endif
+
+/* Spawn workers until `wanted` exist; returns how many are available. */
+static size_t ensure_workers(size_t wanted)
+{
+    while (pool_workers < wanted) {
+        void* arg = (void*)(uintptr_t)pool_workers;
+#if defined(_WIN32)
+        HANDLE h = CreateThread(NULL, 0, worker_main, arg, 0, NULL);
+        if (!h) break;
+        CloseHandle(h);
+#else
+        pthread_t t;
+        if (pthread_create(&t, NULL, worker_main, arg) != 0) break;
+        pthread_detach(t);
+#endif
+        pool_workers++;
+    }
+    return pool_workers < wanted ? pool_workers : wanted;
+}
+
+/* ---------------------------------------------------------
+ * Public API
+ * --------------------------------------------------------- */
+
+int fossil_data_parallel_set_threads(size_t threads)
+{
+    pool_lock(&pool_mutex);
+    pool_requested = threads;
+    pool_unlock(&pool_mutex);
+    return 0;
+}
+
+size_t fossil_data_parallel_get_threads(void)
+{
+    pool_lock(&pool_mutex);
+    size_t n = pool_requested;
+    pool_unlock(&pool_mutex);
+    return clamp_threads(n);
+}
+
+int fossil_data_parallel_for(size_t count, size_t grain, fossil_data_parallel_fn fn, void* ctx)
+{
+    if (!fn) return -1;
+    if (grain == 0) grain = 1;
+
+    size_t chunks = fossil_data_parallel_chunks(count, grain);
+    size_t threads = fossil_data_parallel_get_threads();
+    if (chunks <= 1 || threads <= 1 || pool_trylock(&pool_region) != 0) {
+        run_inline(count, grain, fn, ctx);
+        return 0;
+    }
+
+    /* The calling thread is one of the participants. */
+    size_t helpers = threads - 1;
+    if (helpers > chunks - 1) helpers = chunks - 1;
+
+    pool_lock(&pool_mutex);
+    helpers = ensure_workers(helpers);
+    pool_job.fn = fn;
+    pool_job.ctx = ctx;
+    pool_job.count = count;
+    pool_job.grain = grain;
+    pool_job.chunks = chunks;
+    pool_job.next = 0;
+    pool_job.active = helpers;
+    pool_job.pending = helpers;
+    pool_generation++;
+    pool_broadcast(&pool_wake);
+    pool_unlock(&pool_mutex);
+
+    drain_chunks();
+
+    pool_lock(&pool_mutex);
+    while (pool_job.pending != 0)
+        pool_wait(&pool_done, &pool_mutex);
+    pool_unlock(&pool_mutex);
+
+    pool_unlock(&pool_region);
+    return 0;
+}
+
+#endif /* FOSSIL_DATA_NO_THREADS */
@@ -23,95 +23,829 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/data/series.h"
+#include "fossil/data/parallel.h"
 
 #include <stdint.h>
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if !defined(FOSSIL_DATA_NO_THREADS)
+#  if defined(_WIN32)
+#    include <windows.h>
+#  else
+#    include <pthread.h>
+#  endif
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SERIES_HAVE_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 /* ---------------------------------------------------------
  * Type helpers
  * --------------------------------------------------------- */
 
-static int fossil_data_series_is_numeric(const char *type_id)
+/*
+ * Bulk kernels parse the type once and convert whole tiles. Integer
+ * types widen to 64-bit lanes and floating types to f64; bool is stored
+ * one byte per element. "hex", "oct" and "bin" are u64 values.
+ */
+typedef enum {
+    SERIES_I8, SERIES_I16, SERIES_I32, SERIES_I64,
+    SERIES_U8, SERIES_U16, SERIES_U32, SERIES_U64,
+    SERIES_SIZE, SERIES_BOOL, SERIES_F32, SERIES_F64,
+    SERIES_INVALID
+} fossil_data_series_dtype_t;
+
+static fossil_data_series_dtype_t fossil_data_series_dtype(const char *type_id)
 {
-    return
-        !strcmp(type_id,"i8")   || !strcmp(type_id,"i16") ||
-        !strcmp(type_id,"i32")  || !strcmp(type_id,"i64") ||
-        !strcmp(type_id,"u8")   || !strcmp(type_id,"u16") ||
-        !strcmp(type_id,"u32")  || !strcmp(type_id,"u64") ||
-        !strcmp(type_id,"f32")  || !strcmp(type_id,"f64") ||
-        !strcmp(type_id,"size") ||
-        !strcmp(type_id,"bool") ||
-        !strcmp(type_id,"hex")  ||
-        !strcmp(type_id,"oct")  ||
-        !strcmp(type_id,"bin");
+    if (!type_id) return SERIES_INVALID;
+    if (!strcmp(type_id,"i8"))   return SERIES_I8;
+    if (!strcmp(type_id,"i16"))  return SERIES_I16;
+    if (!strcmp(type_id,"i32"))  return SERIES_I32;
+    if (!strcmp(type_id,"i64"))  return SERIES_I64;
+    if (!strcmp(type_id,"u8"))   return SERIES_U8;
+    if (!strcmp(type_id,"u16"))  return SERIES_U16;
+    if (!strcmp(type_id,"u32"))  return SERIES_U32;
+    if (!strcmp(type_id,"u64") || !strcmp(type_id,"hex") ||
+        !strcmp(type_id,"oct") || !strcmp(type_id,"bin"))
+        return SERIES_U64;
+    if (!strcmp(type_id,"size")) return SERIES_SIZE;
+    if (!strcmp(type_id,"bool")) return SERIES_BOOL;
+    if (!strcmp(type_id,"f32"))  return SERIES_F32;
+    if (!strcmp(type_id,"f64"))  return SERIES_F64;
+    return SERIES_INVALID;
 }
 
-static double fossil_data_series_get(const void *data, size_t i, const char *type_id)
+static int fossil_data_series_is_float(fossil_data_series_dtype_t t)
 {
-    if (!strcmp(type_id,"i8"))   return ((const int8_t*)data)[i];
-    if (!strcmp(type_id,"i16"))  return ((const int16_t*)data)[i];
-    if (!strcmp(type_id,"i32"))  return ((const int32_t*)data)[i];
-    if (!strcmp(type_id,"i64"))  return (double)((const int64_t*)data)[i];
+    return t == SERIES_F32 || t == SERIES_F64;
+}
 
-    if (!strcmp(type_id,"u8"))   return ((const uint8_t*)data)[i];
-    if (!strcmp(type_id,"u16"))  return ((const uint16_t*)data)[i];
-    if (!strcmp(type_id,"u32"))  return ((const uint32_t*)data)[i];
-    if (!strcmp(type_id,"u64"))  return (double)((const uint64_t*)data)[i];
+#define SERIES_CONVERT(ctype, dtype, expr) \
+    { const ctype* p = (const ctype*)src + offset; \
+      for (size_t i = 0; i < n; i++) dst[i] = (dtype)(expr); } break
 
-    if (!strcmp(type_id,"hex") ||
-        !strcmp(type_id,"oct") ||
-        !strcmp(type_id,"bin"))
-        return (double)((const uint64_t*)data)[i];
+/* Widen n integers from src[offset..] into 64-bit lanes (two's complement). */
+static void fossil_data_series_load_u64(const void *src, size_t offset, size_t n,
+                                        fossil_data_series_dtype_t t, uint64_t *dst)
+{
+    switch (t) {
+    case SERIES_I8:   SERIES_CONVERT(int8_t,   uint64_t, (int64_t)p[i]);
+    case SERIES_I16:  SERIES_CONVERT(int16_t,  uint64_t, (int64_t)p[i]);
+    case SERIES_I32:  SERIES_CONVERT(int32_t,  uint64_t, (int64_t)p[i]);
+    case SERIES_I64:  SERIES_CONVERT(int64_t,  uint64_t, p[i]);
+    case SERIES_U8:   SERIES_CONVERT(uint8_t,  uint64_t, p[i]);
+    case SERIES_U16:  SERIES_CONVERT(uint16_t, uint64_t, p[i]);
+    case SERIES_U32:  SERIES_CONVERT(uint32_t, uint64_t, p[i]);
+    case SERIES_U64:  SERIES_CONVERT(uint64_t, uint64_t, p[i]);
+    case SERIES_SIZE: SERIES_CONVERT(size_t,   uint64_t, p[i]);
+    case SERIES_BOOL: SERIES_CONVERT(uint8_t,  uint64_t, p[i] != 0);
+    default: memset(dst, 0, n * sizeof(uint64_t)); break;
+    }
+}
 
-    if (!strcmp(type_id,"f32"))  return ((const float*)data)[i];
-    if (!strcmp(type_id,"f64"))  return ((const double*)data)[i];
+/* Convert n values from src[offset..] to f64. */
+static void fossil_data_series_load_f64(const void *src, size_t offset, size_t n,
+                                        fossil_data_series_dtype_t t, double *dst)
+{
+    switch (t) {
+    case SERIES_I8:   SERIES_CONVERT(int8_t,   double, p[i]);
+    case SERIES_I16:  SERIES_CONVERT(int16_t,  double, p[i]);
+    case SERIES_I32:  SERIES_CONVERT(int32_t,  double, p[i]);
+    case SERIES_I64:  SERIES_CONVERT(int64_t,  double, p[i]);
+    case SERIES_U8:   SERIES_CONVERT(uint8_t,  double, p[i]);
+    case SERIES_U16:  SERIES_CONVERT(uint16_t, double, p[i]);
+    case SERIES_U32:  SERIES_CONVERT(uint32_t, double, p[i]);
+    case SERIES_U64:  SERIES_CONVERT(uint64_t, double, p[i]);
+    case SERIES_SIZE: SERIES_CONVERT(size_t,   double, p[i]);
+    case SERIES_BOOL: SERIES_CONVERT(uint8_t,  double, p[i] != 0);
+    case SERIES_F32:  SERIES_CONVERT(float,    double, p[i]);
+    case SERIES_F64:  memcpy(dst, (const double*)src + offset, n * sizeof(double)); break;
+    default: memset(dst, 0, n * sizeof(double)); break;
+    }
+}
 
-    if (!strcmp(type_id,"bool")) return ((const uint8_t*)data)[i] ? 1.0 : 0.0;
-    if (!strcmp(type_id,"size")) return (double)((const size_t*)data)[i];
+#define SERIES_STORE(ctype, expr) \
+    { ctype* p = (ctype*)dst + offset; \
+      for (size_t i = 0; i < n; i++) p[i] = (ctype)(expr); } break
 
-    return 0.0;
+/* Narrow n 64-bit lanes into dst[offset..], wrapping like the type's own arithmetic. */
+static void fossil_data_series_store_u64(void *dst, size_t offset, size_t n,
+                                         fossil_data_series_dtype_t t, const uint64_t *src)
+{
+    switch (t) {
+    case SERIES_I8:   SERIES_STORE(int8_t,   (int64_t)src[i]);
+    case SERIES_I16:  SERIES_STORE(int16_t,  (int64_t)src[i]);
+    case SERIES_I32:  SERIES_STORE(int32_t,  (int64_t)src[i]);
+    case SERIES_I64:  SERIES_STORE(int64_t,  src[i]);
+    case SERIES_U8:   SERIES_STORE(uint8_t,  src[i]);
+    case SERIES_U16:  SERIES_STORE(uint16_t, src[i]);
+    case SERIES_U32:  SERIES_STORE(uint32_t, src[i]);
+    case SERIES_U64:  SERIES_STORE(uint64_t, src[i]);
+    case SERIES_SIZE: SERIES_STORE(size_t,   src[i]);
+    case SERIES_BOOL: SERIES_STORE(uint8_t,  src[i] != 0);
+    default: break;
+    }
 }
 
-static void fossil_data_series_store(void *out, size_t i, const char *type_id, double v)
+#define SERIES_STORE_SAT(ctype, lo, hi) \
+    { ctype* p = (ctype*)dst + offset; \
+      for (size_t i = 0; i < n; i++) { \
+          double v = src[i]; \
+          p[i] = v != v ? (ctype)0 : v >= (double)(hi) ? (hi) \
+               : v > (double)(lo) ? (ctype)v : (lo); \
+      } } break
+
+/*
+ * Store n f64 values into dst[offset..]. Integer types truncate toward
+ * zero and saturate at their range (NaN stores 0); bool is v > 0.5.
+ */
+static void fossil_data_series_store_f64(void *dst, size_t offset, size_t n,
+                                         fossil_data_series_dtype_t t, const double *src)
 {
-    if (!strcmp(type_id,"f64")) ((double*)out)[i] = v;
-    else if (!strcmp(type_id,"f32")) ((float*)out)[i] = (float)v;
-    else if (!strcmp(type_id,"i32")) ((int32_t*)out)[i] = (int32_t)v;
-    else if (!strcmp(type_id,"i64")) ((int64_t*)out)[i] = (int64_t)v;
-    else if (!strcmp(type_id,"u32")) ((uint32_t*)out)[i] = (uint32_t)(v < 0 ? 0 : v);
-    else if (!strcmp(type_id,"u64")) ((uint64_t*)out)[i] = (uint64_t)(v < 0 ? 0 : v);
-    else if (!strcmp(type_id,"bool")) ((uint8_t*)out)[i] = v > 0.5;
-    else if (!strcmp(type_id,"size")) ((size_t*)out)[i] = (size_t)(v < 0 ? 0 : v);
-    else ((double*)out)[i] = v; /* fallback */
+    switch (t) {
+    case SERIES_I8:   SERIES_STORE_SAT(int8_t,   INT8_MIN,  INT8_MAX);
+    case SERIES_I16:  SERIES_STORE_SAT(int16_t,  INT16_MIN, INT16_MAX);
+    case SERIES_I32:  SERIES_STORE_SAT(int32_t,  INT32_MIN, INT32_MAX);
+    case SERIES_I64:  SERIES_STORE_SAT(int64_t,  INT64_MIN, INT64_MAX);
+    case SERIES_U8:   SERIES_STORE_SAT(uint8_t,  0, UINT8_MAX);
+    case SERIES_U16:  SERIES_STORE_SAT(uint16_t, 0, UINT16_MAX);
+    case SERIES_U32:  SERIES_STORE_SAT(uint32_t, 0, UINT32_MAX);
+    case SERIES_U64:  SERIES_STORE_SAT(uint64_t, 0, UINT64_MAX);
+    case SERIES_SIZE: SERIES_STORE_SAT(size_t,   0, SIZE_MAX);
+    case SERIES_BOOL: SERIES_STORE(uint8_t, src[i] > 0.5);
+    case SERIES_F32:  SERIES_STORE(float, src[i]);
+    case SERIES_F64:  memcpy((double*)dst + offset, src, n * sizeof(double)); break;
+    default: break;
+    }
 }
 
 /* ---------------------------------------------------------
  * Cumulative sum
  * --------------------------------------------------------- */
 
+#define SERIES_SCAN_TILE  512                /* elements converted per step */
+#define SERIES_SCAN_GRAIN ((size_t)1 << 16)  /* elements per parallel chunk */
+
+/*
+ * In-register inclusive scans. Each writes out[i] = offset + local
+ * prefix (out may be NULL or equal to x) and returns the local prefix
+ * after the last element. Lanes are scanned with shifted adds and the
+ * running total is carried as a broadcast, so the association of every
+ * sum is fixed by the build, not by how the range was split.
+ */
+static double fossil_data_series_scan_f64(const double *x, double *out, size_t n,
+                                          double local, double offset)
+{
+    size_t i = 0;
+#if defined(__AVX__)
+    __m256d zero = _mm256_setzero_pd();
+    __m256d vl = _mm256_set1_pd(local), vo = _mm256_set1_pd(offset);
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        v = _mm256_add_pd(v, _mm256_blend_pd(zero, _mm256_permute_pd(v, 0x0), 0xA));
+        __m256d hi = _mm256_permute_pd(v, 0xF);
+        v = _mm256_add_pd(v, _mm256_permute2f128_pd(hi, hi, 0x08));
+        v = _mm256_add_pd(v, vl);
+        hi = _mm256_permute_pd(v, 0xF);
+        vl = _mm256_permute2f128_pd(hi, hi, 0x11);
+        if (out) _mm256_storeu_pd(out + i, _mm256_add_pd(v, vo));
+    }
+    local = _mm_cvtsd_f64(_mm256_castpd256_pd128(vl));
+#elif defined(SERIES_HAVE_SSE2)
+    __m128d vl = _mm_set1_pd(local), vo = _mm_set1_pd(offset);
+    for (; i + 2 <= n; i += 2) {
+        __m128d v = _mm_loadu_pd(x + i);
+        v = _mm_add_pd(v, _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(v), 8)));
+        v = _mm_add_pd(v, vl);
+        vl = _mm_unpackhi_pd(v, v);
+        if (out) _mm_storeu_pd(out + i, _mm_add_pd(v, vo));
+    }
+    local = _mm_cvtsd_f64(vl);
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    float64x2_t vl = vdupq_n_f64(local), vo = vdupq_n_f64(offset);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t v = vld1q_f64(x + i);
+        v = vaddq_f64(v, vextq_f64(vdupq_n_f64(0.0), v, 1));
+        v = vaddq_f64(v, vl);
+        vl = vdupq_laneq_f64(v, 1);
+        if (out) vst1q_f64(out + i, vaddq_f64(v, vo));
+    }
+    local = vgetq_lane_f64(vl, 0);
+#endif
+    for (; i < n; i++) {
+        local += x[i];
+        if (out) out[i] = offset + local;
+    }
+    return local;
+}
+
+/* Integer scan: exact modulo 2^64, so lane order does not matter. */
+static uint64_t fossil_data_series_scan_u64(const uint64_t *x, uint64_t *out, size_t n,
+                                            uint64_t local, uint64_t offset)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i zero = _mm256_setzero_si256();
+    __m256i vl = _mm256_set1_epi64x((long long)local), vo = _mm256_set1_epi64x((long long)offset);
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(x + i));
+        v = _mm256_add_epi64(v, _mm256_slli_si256(v, 8));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(zero,
+                _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 1, 0, 0)), 0xF0));
+        v = _mm256_add_epi64(v, vl);
+        vl = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+        if (out) _mm256_storeu_si256((__m256i*)(out + i), _mm256_add_epi64(v, vo));
+    }
+    local = (uint64_t)_mm_cvtsi128_si64(_mm256_castsi256_si128(vl));
+#elif (defined(__AVX__) || defined(SERIES_HAVE_SSE2)) && (defined(__x86_64__) || defined(_M_X64))
+    __m128i vl = _mm_set1_epi64x((long long)local), vo = _mm_set1_epi64x((long long)offset);
+    for (; i + 2 <= n; i += 2) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(x + i));
+        v = _mm_add_epi64(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi64(v, vl);
+        vl = _mm_unpackhi_epi64(v, v);
+        if (out) _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi64(v, vo));
+    }
+    local = (uint64_t)_mm_cvtsi128_si64(vl);
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    uint64x2_t vl = vdupq_n_u64(local), vo = vdupq_n_u64(offset);
+    for (; i + 2 <= n; i += 2) {
+        uint64x2_t v = vld1q_u64(x + i);
+        v = vaddq_u64(v, vextq_u64(vdupq_n_u64(0), v, 1));
+        v = vaddq_u64(v, vl);
+        vl = vdupq_laneq_u64(v, 1);
+        if (out) vst1q_u64(out + i, vaddq_u64(v, vo));
+    }
+    local = vgetq_lane_u64(vl, 0);
+#endif
+    for (; i < n; i++) {
+        local += x[i];
+        if (out) out[i] = offset + local;
+    }
+    return local;
+}
+
+/*
+ * Block scan over fixed chunks of SERIES_SCAN_GRAIN elements. Every
+ * chunk is scanned from zero and shifted by the sum of the chunk totals
+ * before it. With several threads a first pass computes the totals and
+ * a second applies the offsets; on one thread the same arithmetic runs
+ * in a single pass, so the output is the same for any thread count.
+ */
+typedef struct {
+    const void *in;
+    void *out;              /* NULL: totals only */
+    fossil_data_series_dtype_t t;
+    double *f_total;        /* per chunk, floating types */
+    uint64_t *u_total;      /* per chunk, integer types */
+    const double *f_offset;
+    const uint64_t *u_offset;
+} fossil_data_series_scan_job_t;
+
+static void fossil_data_series_scan_chunk(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_scan_job_t *job = ctx;
+    fossil_data_series_dtype_t t = job->t;
+
+    if (fossil_data_series_is_float(t)) {
+        double tile[SERIES_SCAN_TILE];
+        double local = 0, offset = job->out ? job->f_offset[chunk] : 0;
+        for (size_t i = begin; i < end; i += SERIES_SCAN_TILE) {
+            size_t n = end - i < SERIES_SCAN_TILE ? end - i : SERIES_SCAN_TILE;
+            if (t == SERIES_F64) {
+                local = fossil_data_series_scan_f64((const double*)job->in + i,
+                                                    job->out ? (double*)job->out + i : NULL,
+                                                    n, local, offset);
+                continue;
+            }
+            fossil_data_series_load_f64(job->in, i, n, t, tile);
+            local = fossil_data_series_scan_f64(tile, job->out ? tile : NULL, n, local, offset);
+            if (job->out) fossil_data_series_store_f64(job->out, i, n, t, tile);
+        }
+        job->f_total[chunk] = local;
+    } else {
+        uint64_t tile[SERIES_SCAN_TILE];
+        uint64_t local = 0, offset = job->out ? job->u_offset[chunk] : 0;
+        int direct = t == SERIES_I64 || t == SERIES_U64 ||
+                     (t == SERIES_SIZE && sizeof(size_t) == sizeof(uint64_t));
+        for (size_t i = begin; i < end; i += SERIES_SCAN_TILE) {
+            size_t n = end - i < SERIES_SCAN_TILE ? end - i : SERIES_SCAN_TILE;
+            if (direct) {
+                local = fossil_data_series_scan_u64((const uint64_t*)job->in + i,
+                                                    job->out ? (uint64_t*)job->out + i : NULL,
+                                                    n, local, offset);
+                continue;
+            }
+            fossil_data_series_load_u64(job->in, i, n, t, tile);
+            local = fossil_data_series_scan_u64(tile, job->out ? tile : NULL, n, local, offset);
+            if (job->out) fossil_data_series_store_u64(job->out, i, n, t, tile);
+        }
+        job->u_total[chunk] = local;
+    }
+}
+
+/*
+ * The single-threaded cumsum of [base, base + count): the same fixed
+ * chunks as the two-pass scan, with each chunk's total becoming the
+ * next chunk's offset, so both give the same result.
+ */
+static void fossil_data_series_cumsum_serial(const void *input, void *output, size_t base,
+                                             size_t count, fossil_data_series_dtype_t t)
+{
+    double f[2] = {0, 0};
+    uint64_t u[2] = {0, 0};
+    fossil_data_series_scan_job_t job = { input, output, t, f, u, f + 1, u + 1 };
+    for (size_t begin = 0; begin < count; begin += SERIES_SCAN_GRAIN) {
+        size_t end = count - begin < SERIES_SCAN_GRAIN ? count : begin + SERIES_SCAN_GRAIN;
+        fossil_data_series_scan_chunk(&job, 0, base + begin, base + end);
+        f[1] += f[0];
+        u[1] += u[0];
+    }
+}
+
 int fossil_data_series_cumsum(
     const void* input,
     void* output,
     size_t count,
     const char* type_id
 ){
-    if (!input || !output || count == 0 || !fossil_data_series_is_numeric(type_id))
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || t == SERIES_INVALID)
         return -1;
 
-    long double sum = 0.0;
-
-    for (size_t i=0;i<count;i++) {
-        sum += fossil_data_series_get(input,i,type_id);
-        fossil_data_series_store(output,i,type_id,(double)sum);
+    int is_float = fossil_data_series_is_float(t);
+    size_t chunks = fossil_data_parallel_chunks(count, SERIES_SCAN_GRAIN);
+    double *f = NULL;
+    uint64_t *u = NULL;
+    if (chunks > 1 && fossil_data_parallel_get_threads() > 1) {
+        f = malloc(2 * chunks * sizeof(double));
+        u = malloc(2 * chunks * sizeof(uint64_t));
     }
-
+    if (f && u) {
+        // Two passes: chunk totals, then every chunk again from its offset
+        fossil_data_series_scan_job_t job = { input, NULL, t, f, u, f + chunks, u + chunks };
+        fossil_data_parallel_for(count, SERIES_SCAN_GRAIN, fossil_data_series_scan_chunk, &job);
+        double *f_off = f + chunks;
+        uint64_t *u_off = u + chunks;
+        f_off[0] = 0;
+        u_off[0] = 0;
+        for (size_t c = 1; c < chunks; c++) {
+            if (is_float) f_off[c] = f_off[c - 1] + f[c - 1];
+            else          u_off[c] = u_off[c - 1] + u[c - 1];
+        }
+        job.out = output;
+        fossil_data_parallel_for(count, SERIES_SCAN_GRAIN, fossil_data_series_scan_chunk, &job);
+    } else {
+        fossil_data_series_cumsum_serial(input, output, 0, count, t);
+    }
+    free(f);
+    free(u);
     return 0;
 }
 
 /* ---------------------------------------------------------
- * Rolling mean
+ * Rolling windows
  * --------------------------------------------------------- */
 
+/*
+ * Rolling statistics share one streaming engine: values are pushed one
+ * at a time into a window state that returns the statistic over the
+ * last `window` values (fewer while the window fills). Outgoing values
+ * come from the state's own ring (min/max keep them in the deque
+ * instead), never from the input, and all memory is allocated at init.
+ */
+typedef enum {
+    SERIES_STAT_SUM, SERIES_STAT_MEAN, SERIES_STAT_VAR, SERIES_STAT_STD,
+    SERIES_STAT_MIN, SERIES_STAT_MAX, SERIES_STAT_QUANTILE
+} fossil_data_series_stat_t;
+
+typedef struct {
+    fossil_data_series_stat_t stat;
+    size_t window;
+    size_t ddof;            /* var/std */
+    double q;               /* quantile, in [0, 1] */
+    size_t pos;             /* values pushed so far */
+    size_t n;               /* values in the window */
+    size_t slot;            /* ring slot of the next value (pos % window) */
+    double *ring;           /* last `window` values (not min/max) */
+
+    /* sum/mean: compensated running sum; var/std: compensated sums of
+       d = x - shift and d^2, with the shift taken from the window itself */
+    double sum, comp;
+    double shift, s1, c1, s2, c2;
+    size_t refresh;         /* pushes left before the next exact recompute */
+
+    /* non-finite values in the ring, counted by kind and kept out of the
+       sums; the median keeps NaN out of its heaps too (in_lo = 2) */
+    size_t n_nan, n_pinf, n_ninf;
+
+    /* min/max: monotonic deque of (position, value), oldest at dq_head */
+    size_t *dq_pos;
+    double *dq_val;
+    size_t dq_head, dq_len;
+
+    /* quantile: max-heap `lo` holds the smallest values, min-heap `hi` the
+       rest; both hold ring slots, and `where` maps a slot to its index */
+    size_t *lo, *hi, *where;
+    size_t n_lo, n_hi;
+    unsigned char *in_lo;
+} fossil_data_series_window_t;
+
+static void fossil_data_series_window_free(fossil_data_series_window_t *w)
+{
+    free(w->ring);
+    free(w->dq_pos);
+    free(w->dq_val);
+    free(w->lo);
+    free(w->hi);
+    free(w->where);
+    free(w->in_lo);
+    memset(w, 0, sizeof(*w));
+}
+
+static int fossil_data_series_window_init(fossil_data_series_window_t *w,
+                                          fossil_data_series_stat_t stat, size_t window,
+                                          size_t ddof, double q)
+{
+    memset(w, 0, sizeof(*w));
+    if (window == 0 || !(q >= 0 && q <= 1)) return -1;
+    w->stat = stat;
+    w->window = window;
+    w->ddof = ddof;
+    w->q = q;
+    w->refresh = window;
+    int ok;
+    if (stat == SERIES_STAT_MIN || stat == SERIES_STAT_MAX) {
+        w->dq_pos = calloc(window, sizeof(size_t));
+        w->dq_val = calloc(window, sizeof(double));
+        ok = w->dq_pos && w->dq_val;
+    } else {
+        w->ring = calloc(window, sizeof(double));
+        ok = w->ring != NULL;
+    }
+    if (stat == SERIES_STAT_QUANTILE) {
+        w->lo = calloc(window, sizeof(size_t));
+        w->hi = calloc(window, sizeof(size_t));
+        w->where = calloc(window, sizeof(size_t));
+        w->in_lo = calloc(window, 1);
+        ok = ok && w->lo && w->hi && w->where && w->in_lo;
+    }
+    if (!ok) { fossil_data_series_window_free(w); return -3; }
+    return 0;
+}
+
+/* Empty a window state for a new series, keeping its allocations. */
+static void fossil_data_series_window_reset(fossil_data_series_window_t *w)
+{
+    if (w->ring) memset(w->ring, 0, w->window * sizeof(double));
+    w->pos = w->n = w->slot = 0;
+    w->sum = w->comp = w->shift = w->s1 = w->c1 = w->s2 = w->c2 = 0.0;
+    w->refresh = w->window;
+    w->n_nan = w->n_pinf = w->n_ninf = 0;
+    w->dq_head = w->dq_len = 0;
+    w->n_lo = w->n_hi = 0;
+}
+
+/* Count a non-finite value entering (by = 1) or leaving (by = -1) the ring. */
+static void fossil_data_series_nonfinite_count(size_t *n_nan, size_t *n_pinf, size_t *n_ninf,
+                                               double x, int by)
+{
+    size_t *n = x != x ? n_nan : x > 0 ? n_pinf : n_ninf;
+    *n += (size_t)by;
+}
+
+/* Compensated summation (branch-free TwoSum): comp collects the bits sum drops. */
+static void fossil_data_series_sum_add(double *sum, double *comp, double x)
+{
+    double t = *sum + x;
+    double z = t - *sum;
+    *comp += (*sum - (t - z)) + (x - z);
+    *sum = t;
+}
+
+/*
+ * Sliding updates accumulate rounding, so once per `window` pushes the
+ * sums are recomputed from the full ring: O(1) amortized, and drift
+ * never outlives one window. The variance shift moves to the newest
+ * value, so deviations stay small next to the values and a constant
+ * window sums exact zeros. acc is { sum, comp, s1, c1, s2, c2 }, and
+ * only the raw or the shifted sums are rebuilt when the other is unused.
+ * Non-finite values are skipped, as they are by the sliding updates.
+ */
+static void fossil_data_series_window_recompute(const double *ring, size_t window,
+                                                double shift, int raw, int shifted,
+                                                double *acc)
+{
+    memset(acc, 0, 6 * sizeof(double));
+    if (raw)
+        for (size_t i = 0; i < window; i++)
+            if (ring[i] - ring[i] == 0) fossil_data_series_sum_add(&acc[0], &acc[1], ring[i]);
+    if (shifted)
+        for (size_t i = 0; i < window; i++) {
+            if (ring[i] - ring[i] != 0) continue;
+            double d = ring[i] - shift;
+            fossil_data_series_sum_add(&acc[2], &acc[3], d);
+            fossil_data_series_sum_add(&acc[4], &acc[5], d * d);
+        }
+}
+
+/*
+ * The run functions below push v[0..count) in order, replacing each
+ * value by the statistic over the window ending at it. They hold the
+ * state in locals for the whole run (stores into the ring cannot alias
+ * it) and write it back at the end.
+ */
+
+/*
+ * sum, mean, var and std. out is indexed by stat (SUM..STD) and may hold
+ * several outputs at once, so features sharing a window share one state;
+ * only the sums some output reads are updated. Non-finite values stay in
+ * the ring but not in the sums; while any is in the window the outputs
+ * come from their counts instead, so they leave no residue behind.
+ */
+static void fossil_data_series_moments_run(fossil_data_series_window_t *w, const double *v,
+                                           size_t count, double *const *out)
+{
+    double *ring = w->ring;
+    size_t window = w->window, n = w->n, slot = w->slot, refresh = w->refresh;
+    double sum = w->sum, comp = w->comp, shift = w->shift;
+    double s1 = w->s1, c1 = w->c1, s2 = w->s2, c2 = w->c2;
+    size_t n_nan = w->n_nan, n_pinf = w->n_pinf, n_ninf = w->n_ninf;
+    int raw = out[SERIES_STAT_SUM] || out[SERIES_STAT_MEAN];
+    int shifted = out[SERIES_STAT_VAR] || out[SERIES_STAT_STD];
+
+    for (size_t i = 0; i < count; i++) {
+        double x = v[i];
+        int first = n == 0, full = n == window;
+        double old = ring[slot];
+        ring[slot] = x;
+        slot = slot + 1 == window ? 0 : slot + 1;
+        if (!full) n++;
+        // a non-finite value enters or leaves the sums as 0 and its
+        // shifted terms are skipped
+        int x_ok = x - x == 0, old_ok = !full || old - old == 0;
+        if (!x_ok) {
+            fossil_data_series_nonfinite_count(&n_nan, &n_pinf, &n_ninf, x, 1);
+            x = 0.0;
+        }
+        if (!old_ok) {
+            fossil_data_series_nonfinite_count(&n_nan, &n_pinf, &n_ninf, old, -1);
+            old = 0.0;
+        }
+        if (first) shift = x;
+
+        if (full && --refresh == 0) {
+            double acc[6];
+            if (x_ok) shift = x;
+            fossil_data_series_window_recompute(ring, window, shift, raw, shifted, acc);
+            sum = acc[0]; comp = acc[1]; s1 = acc[2]; c1 = acc[3]; s2 = acc[4]; c2 = acc[5];
+            refresh = window;
+        } else {
+            // the raw sum takes in and out as one delta (the ring starts
+            // zeroed); the shifted sums add each term exactly, since after
+            // a burst the squares can dwarf the window's own variance
+            if (raw) fossil_data_series_sum_add(&sum, &comp, x - old);
+            if (shifted) {
+                if (x_ok) {
+                    double d = x - shift;
+                    fossil_data_series_sum_add(&s1, &c1, d);
+                    fossil_data_series_sum_add(&s2, &c2, d * d);
+                }
+                if (full && old_ok) {
+                    double e = old - shift;
+                    fossil_data_series_sum_add(&s1, &c1, -e);
+                    fossil_data_series_sum_add(&s2, &c2, -(e * e));
+                }
+            }
+        }
+
+        if (n_nan + n_pinf + n_ninf) {
+            // NaN, or infinities of both signs, make the sum NaN; one sign wins
+            double inf = n_nan || (n_pinf && n_ninf) ? NAN : n_pinf ? INFINITY : -INFINITY;
+            if (out[SERIES_STAT_SUM]) out[SERIES_STAT_SUM][i] = inf;
+            if (out[SERIES_STAT_MEAN]) out[SERIES_STAT_MEAN][i] = inf;
+            if (out[SERIES_STAT_VAR]) out[SERIES_STAT_VAR][i] = NAN;
+            if (out[SERIES_STAT_STD]) out[SERIES_STAT_STD][i] = NAN;
+            continue;
+        }
+        if (out[SERIES_STAT_SUM]) out[SERIES_STAT_SUM][i] = sum + comp;
+        if (out[SERIES_STAT_MEAN]) out[SERIES_STAT_MEAN][i] = (sum + comp) / (double)n;
+        if (shifted) {
+            double d1 = s1 + c1;
+            double m2 = (s2 + c2) - d1 * d1 / (double)n;
+            // rounding can leave m2 just below 0; an overflowed NaN stays NaN
+            double var = n > w->ddof ? (m2 < 0 ? 0.0 : m2) / (double)(n - w->ddof) : 0.0;
+            if (out[SERIES_STAT_VAR]) out[SERIES_STAT_VAR][i] = var;
+            if (out[SERIES_STAT_STD]) out[SERIES_STAT_STD][i] = sqrt(var);
+        }
+    }
+
+    w->n = n; w->slot = slot; w->refresh = refresh; w->pos += count;
+    w->n_nan = n_nan; w->n_pinf = n_pinf; w->n_ninf = n_ninf;
+    w->sum = sum; w->comp = comp; w->shift = shift;
+    w->s1 = s1; w->c1 = c1; w->s2 = s2; w->c2 = c2;
+}
+
+/*
+ * min and max: values that can never be the extreme again leave the
+ * deque. NaN ranks above every value, so it holds the front (and the
+ * output) until it leaves the window, and nothing pops it early.
+ */
+static void fossil_data_series_extreme_run(fossil_data_series_window_t *w, double *v, size_t count)
+{
+    size_t *dq_pos = w->dq_pos;
+    double *dq_val = w->dq_val;
+    size_t window = w->window, head = w->dq_head, len = w->dq_len, p = w->pos;
+    int max = w->stat == SERIES_STAT_MAX;
+
+    for (size_t i = 0; i < count; i++, p++) {
+        double x = v[i];
+        if (len && dq_pos[head] + window <= p) {
+            head = head + 1 == window ? 0 : head + 1;
+            len--;
+        }
+        while (len) {
+            size_t back = head + len - 1;
+            if (back >= window) back -= window;
+            double b = dq_val[back];
+            if (b != b || (max ? b > x : b < x)) break;
+            len--;
+        }
+        size_t tail = head + len++;
+        if (tail >= window) tail -= window;
+        dq_pos[tail] = p;
+        dq_val[tail] = x;
+        v[i] = dq_val[head];
+    }
+
+    w->n = p < window ? p : window;
+    w->slot = p % window;
+    w->pos = p;
+    w->dq_head = head;
+    w->dq_len = len;
+}
+
+/* Indexed binary heap over ring slots; `max` orders lo, otherwise hi. */
+static int fossil_data_series_heap_before(const fossil_data_series_window_t *w, int max,
+                                          size_t a, size_t b)
+{
+    return max ? w->ring[a] > w->ring[b] : w->ring[a] < w->ring[b];
+}
+
+static void fossil_data_series_heap_set(fossil_data_series_window_t *w, int max,
+                                        size_t i, size_t slot)
+{
+    (max ? w->lo : w->hi)[i] = slot;
+    w->where[slot] = i;
+    w->in_lo[slot] = (unsigned char)max;
+}
+
+static void fossil_data_series_heap_fix(fossil_data_series_window_t *w, int max, size_t i)
+{
+    size_t *h = max ? w->lo : w->hi;
+    size_t n = max ? w->n_lo : w->n_hi;
+    size_t slot = h[i];
+    while (i > 0 && fossil_data_series_heap_before(w, max, slot, h[(i - 1) / 2])) {
+        fossil_data_series_heap_set(w, max, i, h[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && fossil_data_series_heap_before(w, max, h[c + 1], h[c])) c++;
+        if (!fossil_data_series_heap_before(w, max, h[c], slot)) break;
+        fossil_data_series_heap_set(w, max, i, h[c]);
+        i = c;
+    }
+    fossil_data_series_heap_set(w, max, i, slot);
+}
+
+static void fossil_data_series_heap_push(fossil_data_series_window_t *w, int max, size_t slot)
+{
+    size_t i = max ? w->n_lo++ : w->n_hi++;
+    fossil_data_series_heap_set(w, max, i, slot);
+    fossil_data_series_heap_fix(w, max, i);
+}
+
+static size_t fossil_data_series_heap_remove(fossil_data_series_window_t *w, int max, size_t i)
+{
+    size_t *h = max ? w->lo : w->hi;
+    size_t *n = max ? &w->n_lo : &w->n_hi;
+    size_t slot = h[i];
+    if (i != --*n) {
+        fossil_data_series_heap_set(w, max, i, h[*n]);
+        fossil_data_series_heap_fix(w, max, i);
+    }
+    return slot;
+}
+
+/*
+ * quantile: keep k + 1 values in lo so the heap tops bracket position h.
+ * NaN stays in the ring but out of the heaps (in_lo = 2), and the output
+ * is NaN while one is in the window.
+ */
+static void fossil_data_series_quantile_run(fossil_data_series_window_t *w, double *v, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        double x = v[i];
+        size_t slot = w->slot;
+        if (w->n < w->window)
+            w->n++;
+        else if (w->in_lo[slot] == 2)
+            w->n_nan--;
+        else
+            fossil_data_series_heap_remove(w, w->in_lo[slot], w->where[slot]);
+        w->ring[slot] = x;
+        w->slot = slot + 1 == w->window ? 0 : slot + 1;
+        if (x != x) {
+            w->in_lo[slot] = 2;
+            w->n_nan++;
+        } else {
+            fossil_data_series_heap_push(w, w->n_lo == 0 || x <= w->ring[w->lo[0]], slot);
+        }
+        size_t m = w->n_lo + w->n_hi;
+        if (m == 0) {
+            v[i] = NAN;
+            continue;
+        }
+
+        double h = w->q * (double)(m - 1);
+        size_t k = (size_t)h;
+        double frac = h - (double)k;
+        while (w->n_lo > k + 1)
+            fossil_data_series_heap_push(w, 0, fossil_data_series_heap_remove(w, 1, 0));
+        while (w->n_lo < k + 1)
+            fossil_data_series_heap_push(w, 1, fossil_data_series_heap_remove(w, 0, 0));
+        // lo was empty after the removal, so x may belong in hi
+        while (w->n_hi && w->ring[w->hi[0]] < w->ring[w->lo[0]]) {
+            size_t a = fossil_data_series_heap_remove(w, 1, 0);
+            size_t b = fossil_data_series_heap_remove(w, 0, 0);
+            fossil_data_series_heap_push(w, 1, b);
+            fossil_data_series_heap_push(w, 0, a);
+        }
+        double lo = w->ring[w->lo[0]];
+        v[i] = w->n_nan ? NAN : frac > 0 && w->n_hi ? lo + frac * (w->ring[w->hi[0]] - lo) : lo;
+    }
+    w->pos += count;
+}
+
+/* Push values through a window state in place. */
+static void fossil_data_series_window_apply(fossil_data_series_window_t *w, double *v, size_t count)
+{
+    switch (w->stat) {
+    case SERIES_STAT_MIN:
+    case SERIES_STAT_MAX:      fossil_data_series_extreme_run(w, v, count); break;
+    case SERIES_STAT_QUANTILE: fossil_data_series_quantile_run(w, v, count); break;
+    default: {
+        double *out[SERIES_STAT_STD + 1] = {NULL};
+        out[w->stat] = v;
+        fossil_data_series_moments_run(w, v, count, out);
+        break;
+    }
+    }
+}
+
+/* Run a window state over [base, base + count), one tile at a time. */
+static void fossil_data_series_window_run(fossil_data_series_window_t *w, const void *input,
+                                          void *output, size_t base, size_t count,
+                                          fossil_data_series_dtype_t t)
+{
+    double tile[SERIES_SCAN_TILE];
+    for (size_t i = 0; i < count; i += SERIES_SCAN_TILE) {
+        size_t n = count - i < SERIES_SCAN_TILE ? count - i : SERIES_SCAN_TILE;
+        fossil_data_series_load_f64(input, base + i, n, t, tile);
+        fossil_data_series_window_apply(w, tile, n);
+        fossil_data_series_store_f64(output, base + i, n, t, tile);
+    }
+}
+
+static int fossil_data_series_rolling(const void *input, void *output, size_t count,
+                                      size_t window, fossil_data_series_stat_t stat,
+                                      size_t ddof, double q, const char *type_id)
+{
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || window == 0 || t == SERIES_INVALID)
+        return -1;
+    fossil_data_series_window_t w;
+    int rc = fossil_data_series_window_init(&w, stat, window, ddof, q);
+    if (rc != 0) return rc;
+    fossil_data_series_window_run(&w, input, output, 0, count, t);
+    fossil_data_series_window_free(&w);
+    return 0;
+}
+
 int fossil_data_series_rolling_mean(
     const void* input,
     void* output,
@@ -119,26 +853,2270 @@ int fossil_data_series_rolling_mean(
     size_t window,
     const char* type_id
 ){
-    if (!input || !output || count == 0 || window == 0 ||
-        !fossil_data_series_is_numeric(type_id))
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_MEAN,
+                                      0, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_sum(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_SUM,
+                                      0, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_var(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_VAR,
+                                      ddof, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_std(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_STD,
+                                      ddof, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_min(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_MIN,
+                                      0, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_max(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_MAX,
+                                      0, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_median(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_QUANTILE,
+                                      0, 0.5, type_id);
+}
+
+int fossil_data_series_rolling_quantile(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t window,
+    double q,
+    const char* type_id
+){
+    return fossil_data_series_rolling(input, output, count, window, SERIES_STAT_QUANTILE,
+                                      0, q, type_id);
+}
+
+/* Map a statistic name onto a window kind; returns -1 if unknown. */
+static int fossil_data_series_stat_parse(const char *name, fossil_data_series_stat_t *stat,
+                                         double *q)
+{
+    *q = 0.5;
+    if (!name) return -1;
+    if (!strcmp(name, "sum"))         *stat = SERIES_STAT_SUM;
+    else if (!strcmp(name, "mean"))   *stat = SERIES_STAT_MEAN;
+    else if (!strcmp(name, "var"))    *stat = SERIES_STAT_VAR;
+    else if (!strcmp(name, "std"))    *stat = SERIES_STAT_STD;
+    else if (!strcmp(name, "min"))    *stat = SERIES_STAT_MIN;
+    else if (!strcmp(name, "max"))    *stat = SERIES_STAT_MAX;
+    else if (!strcmp(name, "median")) *stat = SERIES_STAT_QUANTILE;
+    else return -1;
+    return 0;
+}
+
+/*
+ * Fused pass: the input is converted one block at a time, and every
+ * feature group consumes the block while it is still in cache. Moment
+ * features with equal windows form one group over one state (a stat
+ * listed twice is computed once and copied); the rest are groups of
+ * one. Groups are independent, so a block's groups run across the pool,
+ * and each group's output matches the single call.
+ */
+typedef struct {
+    fossil_data_series_window_t *w;  /* indexed by feature; valid at leaders */
+    const size_t *group;             /* leader feature of each group */
+    const size_t *leader;            /* leader feature of each feature */
+    size_t n_stats;
+    const double *block;             /* converted input for [begin, begin + len) */
+    size_t begin, len;
+    void *const *outputs;
+    double *scratch;                 /* SERIES_SCAN_TILE doubles per feature */
+    fossil_data_series_dtype_t t;
+} fossil_data_series_multi_job_t;
+
+static void fossil_data_series_multi_group(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_multi_job_t *job = ctx;
+    (void)chunk;
+    for (size_t g = begin; g < end; g++) {
+        size_t lead = job->group[g];
+        fossil_data_series_window_t *w = &job->w[lead];
+        for (size_t i = 0; i < job->len; i += SERIES_SCAN_TILE) {
+            size_t n = job->len - i < SERIES_SCAN_TILE ? job->len - i : SERIES_SCAN_TILE;
+            double *tile = job->scratch + lead * SERIES_SCAN_TILE;
+            if (w->stat <= SERIES_STAT_STD) {
+                // A stat requested twice is computed once, at its first
+                // feature, and copied to the repeats
+                double *out[SERIES_STAT_STD + 1] = {NULL};
+                for (size_t k = lead; k < job->n_stats; k++)
+                    if (job->leader[k] == lead && !out[job->w[k].stat])
+                        out[job->w[k].stat] = job->scratch + k * SERIES_SCAN_TILE;
+                fossil_data_series_moments_run(w, job->block + i, n, out);
+                for (size_t k = lead; k < job->n_stats; k++) {
+                    double *dst = job->scratch + k * SERIES_SCAN_TILE;
+                    if (job->leader[k] == lead && out[job->w[k].stat] != dst)
+                        memcpy(dst, out[job->w[k].stat], n * sizeof(double));
+                }
+            } else {
+                memcpy(tile, job->block + i, n * sizeof(double));
+                fossil_data_series_window_apply(w, tile, n);
+            }
+            for (size_t k = lead; k < job->n_stats; k++)
+                if (job->leader[k] == lead)
+                    fossil_data_series_store_f64(job->outputs[k], job->begin + i, n, job->t,
+                                                 job->scratch + k * SERIES_SCAN_TILE);
+        }
+    }
+}
+
+int fossil_data_series_rolling_multi(
+    const void* input,
+    void* const* outputs,
+    size_t count,
+    const char* const* stats,
+    const size_t* windows,
+    size_t n_stats,
+    size_t ddof,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !outputs || !stats || !windows || count == 0 || n_stats == 0 ||
+        t == SERIES_INVALID)
         return -1;
+    for (size_t k = 0; k < n_stats; k++) {
+        fossil_data_series_stat_t stat;
+        double q;
+        if (!outputs[k] || windows[k] == 0 ||
+            fossil_data_series_stat_parse(stats[k], &stat, &q) != 0)
+            return -1;
+    }
+
+    size_t len = count < SERIES_SCAN_GRAIN ? count : SERIES_SCAN_GRAIN;
+    fossil_data_series_window_t *w = calloc(n_stats, sizeof(*w));
+    size_t *leader = malloc(2 * n_stats * sizeof(size_t));
+    double *scratch = malloc(n_stats * SERIES_SCAN_TILE * sizeof(double));
+    double *block = malloc(len * sizeof(double));
+    int rc = w && leader && scratch && block ? 0 : -3;
+
+    // Group moment features by window; each group is initialized at its
+    // first feature, and the members' states only record their stat
+    size_t *group = leader + n_stats, n_groups = 0, ready = 0;
+    for (size_t k = 0; rc == 0 && k < n_stats; k++, ready++) {
+        double q;
+        fossil_data_series_stat_parse(stats[k], &w[k].stat, &q);
+        leader[k] = k;
+        for (size_t j = 0; j < k && w[k].stat <= SERIES_STAT_STD; j++)
+            if (leader[j] == j && w[j].stat <= SERIES_STAT_STD && windows[j] == windows[k]) {
+                leader[k] = j;
+                break;
+            }
+        if (leader[k] != k) continue;
+        group[n_groups++] = k;
+        rc = fossil_data_series_window_init(&w[k], w[k].stat, windows[k], ddof, q);
+    }
 
-    long double sum = 0.0;
-    size_t start = 0;
+    fossil_data_series_multi_job_t job = {
+        w, group, leader, n_stats, block, 0, 0, outputs, scratch, t
+    };
+    for (size_t i = 0; rc == 0 && i < count; i += len) {
+        job.begin = i;
+        job.len = count - i < len ? count - i : len;
+        fossil_data_series_load_f64(input, i, job.len, t, block);
+        fossil_data_parallel_for(n_groups, 1, fossil_data_series_multi_group, &job);
+    }
+
+    for (size_t k = 0; k < ready; k++)
+        if (leader[k] == k) fossil_data_series_window_free(&w[k]);
+    free(w);
+    free(leader);
+    free(scratch);
+    free(block);
+    return rc;
+}
+
+/* ---------------------------------------------------------
+ * Streams
+ * --------------------------------------------------------- */
+
+/*
+ * A stream is a cumsum total or a rolling window state that lives
+ * between calls, so each batch costs O(batch) instead of a pass over
+ * the history. Rolling streams run the same window engine as the batch
+ * functions, so any split of a series into batches yields the batch
+ * output bit for bit.
+ */
+typedef struct {
+    int cumsum;
+    fossil_data_series_dtype_t t;
+    fossil_data_series_window_t w;  /* rolling streams */
+    double f_total;                 /* cumsum, floating types */
+    uint64_t u_total;               /* cumsum, integer types */
+    double last;                    /* newest rolling value */
+    size_t pos;                     /* values pushed so far */
+} fossil_data_series_stream_t;
 
-    for (size_t i=0;i<count;i++) {
+int fossil_data_series_stream_create(
+    const char* kind,
+    size_t window,
+    size_t ddof,
+    const char* type_id,
+    void** stream
+){
+    if (!stream) return -1;
+    *stream = NULL;
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    fossil_data_series_stat_t stat = SERIES_STAT_SUM;
+    double q = 0.5;
+    int cumsum = kind && !strcmp(kind, "cumsum");
+    if (t == SERIES_INVALID ||
+        (!cumsum && (window == 0 || fossil_data_series_stat_parse(kind, &stat, &q) != 0)))
+        return -1;
 
-        sum += fossil_data_series_get(input,i,type_id);
+    fossil_data_series_stream_t *s = calloc(1, sizeof(*s));
+    if (!s) return -3;
+    s->cumsum = cumsum;
+    s->t = t;
+    if (!cumsum) {
+        int rc = fossil_data_series_window_init(&s->w, stat, window, ddof, q);
+        if (rc != 0) { free(s); return rc; }
+    }
+    *stream = s;
+    return 0;
+}
 
-        /* Remove element leaving the window */
-        if (i >= window) {
-            sum -= fossil_data_series_get(input,start,type_id);
-            start++;
+int fossil_data_series_stream_push(
+    void* stream,
+    const void* input,
+    void* output,
+    size_t count
+){
+    fossil_data_series_stream_t *s = stream;
+    if (!s || (!input && count)) return -1;
+    fossil_data_series_dtype_t t = s->t;
+    for (size_t i = 0; i < count; i += SERIES_SCAN_TILE) {
+        size_t n = count - i < SERIES_SCAN_TILE ? count - i : SERIES_SCAN_TILE;
+        if (s->cumsum && !fossil_data_series_is_float(t)) {
+            uint64_t tile[SERIES_SCAN_TILE];
+            fossil_data_series_load_u64(input, i, n, t, tile);
+            s->u_total += fossil_data_series_scan_u64(tile, tile, n, 0, s->u_total);
+            if (output) fossil_data_series_store_u64(output, i, n, t, tile);
+            continue;
+        }
+        double tile[SERIES_SCAN_TILE];
+        fossil_data_series_load_f64(input, i, n, t, tile);
+        if (s->cumsum) {
+            s->f_total += fossil_data_series_scan_f64(tile, tile, n, 0, s->f_total);
+        } else {
+            fossil_data_series_window_apply(&s->w, tile, n);
+            s->last = tile[n - 1];
         }
+        if (output) fossil_data_series_store_f64(output, i, n, t, tile);
+    }
+    s->pos += count;
+    return 0;
+}
 
-        size_t denom = (i+1 < window) ? (i+1) : window;
-        fossil_data_series_store(output,i,type_id,(double)(sum/denom));
+int fossil_data_series_stream_value(const void* stream, void* value)
+{
+    const fossil_data_series_stream_t *s = stream;
+    if (!s || !value) return -1;
+    if (s->cumsum && !fossil_data_series_is_float(s->t)) {
+        fossil_data_series_store_u64(value, 0, 1, s->t, &s->u_total);
+        return 0;
     }
+    if (!s->cumsum && s->pos == 0) return -1;
+    fossil_data_series_store_f64(value, 0, 1, s->t, s->cumsum ? &s->f_total : &s->last);
+    return 0;
+}
 
+/*
+ * Saved state layout (native byte order, rejected elsewhere):
+ *
+ *   fossil_data_series_stream_header_t
+ *   ring     double[window]    sum, mean, var, std, median
+ *   dq_pos   uint64_t[window]  min, max
+ *   dq_val   double[window]    min, max
+ *   lo, hi   uint64_t[window]  median
+ *   where    uint64_t[window]  median
+ *   in_lo    uint8_t[window]   median (2 = NaN, in neither heap)
+ */
+#define SERIES_STREAM_MAGIC   "FOSSILSS"
+#define SERIES_STREAM_VERSION 1u
+#define SERIES_STREAM_ENDIAN  0x01020304u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t cumsum;
+    uint32_t dtype;
+    uint32_t stat;
+    uint32_t pad;
+    uint64_t window, ddof, pos, n, slot, refresh;
+    uint64_t dq_head, dq_len, n_lo, n_hi, u_total;
+    double q, sum, comp, shift, s1, c1, s2, c2, f_total, last;
+} fossil_data_series_stream_header_t;
+
+/* Bytes of window arrays a stream of this kind saves after the header. */
+static size_t fossil_data_series_stream_body(int cumsum, fossil_data_series_stat_t stat,
+                                             size_t window)
+{
+    if (cumsum) return 0;
+    if (stat == SERIES_STAT_MIN || stat == SERIES_STAT_MAX) return 16 * window;
+    if (stat == SERIES_STAT_QUANTILE) return 33 * window;
+    return 8 * window;
+}
+
+static void fossil_data_series_put_sizes(unsigned char **at, const size_t *v, size_t n)
+{
+    for (size_t i = 0; i < n; i++, *at += 8) {
+        uint64_t x = v[i];
+        memcpy(*at, &x, 8);
+    }
+}
+
+/* Read n sizes, rejecting any not below limit; returns 0 on success. */
+static int fossil_data_series_get_sizes(const unsigned char **at, size_t *v, size_t n,
+                                        uint64_t limit)
+{
+    for (size_t i = 0; i < n; i++, *at += 8) {
+        uint64_t x;
+        memcpy(&x, *at, 8);
+        if (x >= limit) return -1;
+        v[i] = (size_t)x;
+    }
+    return 0;
+}
+
+int fossil_data_series_stream_save(
+    const void* stream,
+    void* buffer,
+    size_t capacity,
+    size_t* size
+){
+    const fossil_data_series_stream_t *s = stream;
+    if (!s || !size) return -1;
+    const fossil_data_series_window_t *w = &s->w;
+    fossil_data_series_stream_header_t h;
+    size_t need = sizeof(h) + fossil_data_series_stream_body(s->cumsum, w->stat, w->window);
+    *size = need;
+    if (!buffer) return 0;
+    if (capacity < need) return -1;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SERIES_STREAM_MAGIC, sizeof(h.magic));
+    h.version = SERIES_STREAM_VERSION;
+    h.endian = SERIES_STREAM_ENDIAN;
+    h.cumsum = (uint32_t)s->cumsum;
+    h.dtype = (uint32_t)s->t;
+    h.stat = (uint32_t)w->stat;
+    h.window = w->window; h.ddof = w->ddof; h.pos = s->pos; h.n = w->n;
+    h.slot = w->slot; h.refresh = w->refresh;
+    h.dq_head = w->dq_head; h.dq_len = w->dq_len; h.n_lo = w->n_lo; h.n_hi = w->n_hi;
+    h.u_total = s->u_total;
+    h.q = w->q; h.sum = w->sum; h.comp = w->comp; h.shift = w->shift;
+    h.s1 = w->s1; h.c1 = w->c1; h.s2 = w->s2; h.c2 = w->c2;
+    h.f_total = s->f_total; h.last = s->last;
+
+    unsigned char *at = buffer;
+    memcpy(at, &h, sizeof(h));
+    at += sizeof(h);
+    size_t bytes = w->window * sizeof(double);
+    if (w->ring) { memcpy(at, w->ring, bytes); at += bytes; }
+    if (w->dq_pos) {
+        fossil_data_series_put_sizes(&at, w->dq_pos, w->window);
+        memcpy(at, w->dq_val, bytes);
+    }
+    if (w->lo) {
+        fossil_data_series_put_sizes(&at, w->lo, w->window);
+        fossil_data_series_put_sizes(&at, w->hi, w->window);
+        fossil_data_series_put_sizes(&at, w->where, w->window);
+        memcpy(at, w->in_lo, w->window);
+    }
+    return 0;
+}
+
+/*
+ * Check a loaded median state: every occupied ring slot sits in the heap
+ * in_lo names, below that heap's size, at the index where[] records, so
+ * the heaps hold exactly the window's n slots once each. Both heaps must
+ * also be ordered, with lo's top no greater than hi's, or the quantiles
+ * read from the tops would be wrong.
+ */
+static int fossil_data_series_heap_valid(const fossil_data_series_window_t *w)
+{
+    if (w->n_lo > w->n || w->n_nan > w->n - w->n_lo ||
+        w->n_hi != w->n - w->n_lo - w->n_nan)
+        return -1;
+    if (w->n < w->window && w->slot != w->n) return -1;
+    for (size_t slot = 0; slot < w->n; slot++) {
+        size_t i = w->where[slot];
+        double x = w->ring[slot];
+        if (w->in_lo[slot] > 2 || (w->in_lo[slot] == 2) != (x != x)) return -1;
+        if (w->in_lo[slot] == 2) continue;
+        const size_t *h = w->in_lo[slot] ? w->lo : w->hi;
+        if (i >= (w->in_lo[slot] ? w->n_lo : w->n_hi) || h[i] != slot) return -1;
+    }
+    for (size_t i = 1; i < w->n_lo; i++)
+        if (fossil_data_series_heap_before(w, 1, w->lo[i], w->lo[(i - 1) / 2])) return -1;
+    for (size_t i = 1; i < w->n_hi; i++)
+        if (fossil_data_series_heap_before(w, 0, w->hi[i], w->hi[(i - 1) / 2])) return -1;
+    if (w->n_lo && w->n_hi && w->ring[w->hi[0]] < w->ring[w->lo[0]]) return -1;
+    return 0;
+}
+
+int fossil_data_series_stream_load(const void* buffer, size_t size, void** stream)
+{
+    if (!stream) return -1;
+    *stream = NULL;
+    if (!buffer) return -1;
+
+    fossil_data_series_stream_header_t h;
+    if (size < sizeof(h)) return -5;
+    memcpy(&h, buffer, sizeof(h));
+    if (memcmp(h.magic, SERIES_STREAM_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != SERIES_STREAM_VERSION || h.endian != SERIES_STREAM_ENDIAN ||
+        h.cumsum > 1 || h.dtype >= SERIES_INVALID || h.stat > SERIES_STAT_QUANTILE ||
+        (!h.cumsum && (h.window == 0 || h.window > SIZE_MAX / 33)))
+        return -5;
+    fossil_data_series_stat_t stat = (fossil_data_series_stat_t)h.stat;
+    size_t window = (size_t)h.window;
+    if (size != sizeof(h) + fossil_data_series_stream_body((int)h.cumsum, stat, window))
+        return -5;
+    if (!h.cumsum && (h.n > window || h.slot >= window || h.refresh > window ||
+                      h.dq_head >= window || h.dq_len > window ||
+                      (h.n < window && h.slot != h.n) ||
+                      (stat == SERIES_STAT_QUANTILE &&
+                       (h.n_lo > h.n || h.n_hi > h.n - h.n_lo))))
+        return -5;
+
+    fossil_data_series_stream_t *s = calloc(1, sizeof(*s));
+    if (!s) return -3;
+    s->cumsum = (int)h.cumsum;
+    s->t = (fossil_data_series_dtype_t)h.dtype;
+    s->pos = (size_t)h.pos;
+    s->u_total = h.u_total;
+    s->f_total = h.f_total;
+    s->last = h.last;
+    if (s->cumsum) {
+        *stream = s;
+        return 0;
+    }
+
+    fossil_data_series_window_t *w = &s->w;
+    int rc = fossil_data_series_window_init(w, stat, window, (size_t)h.ddof, h.q);
+    if (rc != 0) { free(s); return rc == -1 ? -5 : rc; }
+    w->pos = (size_t)h.pos; w->n = (size_t)h.n; w->slot = (size_t)h.slot;
+    w->refresh = (size_t)h.refresh;
+    w->dq_head = (size_t)h.dq_head; w->dq_len = (size_t)h.dq_len;
+    w->n_lo = (size_t)h.n_lo; w->n_hi = (size_t)h.n_hi;
+    w->sum = h.sum; w->comp = h.comp; w->shift = h.shift;
+    w->s1 = h.s1; w->c1 = h.c1; w->s2 = h.s2; w->c2 = h.c2;
+
+    const unsigned char *at = (const unsigned char*)buffer + sizeof(h);
+    size_t bytes = window * sizeof(double);
+    if (w->ring) {
+        memcpy(w->ring, at, bytes);
+        at += bytes;
+        // the non-finite counts are not saved; the window's ring holds them
+        for (size_t i = 0; i < w->n; i++)
+            if (w->ring[i] - w->ring[i] != 0)
+                fossil_data_series_nonfinite_count(&w->n_nan, &w->n_pinf, &w->n_ninf,
+                                                   w->ring[i], 1);
+    }
+    if (w->dq_pos) {
+        rc = fossil_data_series_get_sizes(&at, w->dq_pos, window, UINT64_MAX);
+        memcpy(w->dq_val, at, bytes);
+    }
+    if (w->lo) {
+        rc = fossil_data_series_get_sizes(&at, w->lo, window, window);
+        if (rc == 0) rc = fossil_data_series_get_sizes(&at, w->hi, window, window);
+        if (rc == 0) rc = fossil_data_series_get_sizes(&at, w->where, window, window);
+        if (rc == 0) memcpy(w->in_lo, at, window);
+    }
+    if (rc != 0) rc = -5;
+    // The layout is sound; the state itself must be one the window engine
+    // can continue from
+    else if (w->refresh == 0 || (w->lo && fossil_data_series_heap_valid(w) != 0)) rc = -1;
+    if (rc != 0) {
+        fossil_data_series_window_free(w);
+        free(s);
+        return rc;
+    }
+    *stream = s;
+    return 0;
+}
+
+int fossil_data_series_stream_free(void* stream)
+{
+    fossil_data_series_stream_t *s = stream;
+    if (!s) return 0;
+    if (!s->cumsum) fossil_data_series_window_free(&s->w);
+    free(s);
+    return 0;
+}
+
+/* ---------------------------------------------------------
+ * Exponential smoothing
+ * --------------------------------------------------------- */
+
+/*
+ * The recurrences are serial in time, so many series are smoothed at
+ * once with one series per SIMD lane. Each block of series is staged
+ * tile by tile as rows of lanes (structure of arrays), so a series gets
+ * the same result in either layout and in any block. The tile shape
+ * follows the layout: time-major input is read as long row segments,
+ * series-major input as a few long runs per series.
+ */
+#define SERIES_EW_TILE   4096  /* staged doubles per tile */
+#define SERIES_EW_ROW    1024  /* series per block, time-major */
+#define SERIES_EW_COLUMN 32    /* series per block, series-major */
+
+#if defined(__AVX__)
+#define SERIES_EW_W 4
+typedef __m256d fossil_data_series_ew_vec_t;
+#define SERIES_EW_LOAD(p)     _mm256_loadu_pd(p)
+#define SERIES_EW_STORE(p, v) _mm256_storeu_pd((p), (v))
+#define SERIES_EW_SET1(x)     _mm256_set1_pd(x)
+#define SERIES_EW_ADD(a, b)   _mm256_add_pd((a), (b))
+#define SERIES_EW_SUB(a, b)   _mm256_sub_pd((a), (b))
+#define SERIES_EW_MUL(a, b)   _mm256_mul_pd((a), (b))
+#elif defined(SERIES_HAVE_SSE2)
+#define SERIES_EW_W 2
+typedef __m128d fossil_data_series_ew_vec_t;
+#define SERIES_EW_LOAD(p)     _mm_loadu_pd(p)
+#define SERIES_EW_STORE(p, v) _mm_storeu_pd((p), (v))
+#define SERIES_EW_SET1(x)     _mm_set1_pd(x)
+#define SERIES_EW_ADD(a, b)   _mm_add_pd((a), (b))
+#define SERIES_EW_SUB(a, b)   _mm_sub_pd((a), (b))
+#define SERIES_EW_MUL(a, b)   _mm_mul_pd((a), (b))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SERIES_EW_W 2
+typedef float64x2_t fossil_data_series_ew_vec_t;
+#define SERIES_EW_LOAD(p)     vld1q_f64(p)
+#define SERIES_EW_STORE(p, v) vst1q_f64((p), (v))
+#define SERIES_EW_SET1(x)     vdupq_n_f64(x)
+#define SERIES_EW_ADD(a, b)   vaddq_f64((a), (b))
+#define SERIES_EW_SUB(a, b)   vsubq_f64((a), (b))
+#define SERIES_EW_MUL(a, b)   vmulq_f64((a), (b))
+#else
+#define SERIES_EW_W 1
+typedef double fossil_data_series_ew_vec_t;
+#define SERIES_EW_LOAD(p)     (*(p))
+#define SERIES_EW_STORE(p, v) (*(p) = (v))
+#define SERIES_EW_SET1(x)     (x)
+#define SERIES_EW_ADD(a, b)   ((a) + (b))
+#define SERIES_EW_SUB(a, b)   ((a) - (b))
+#define SERIES_EW_MUL(a, b)   ((a) * (b))
+#endif
+
+typedef enum { SERIES_EW_MEAN, SERIES_EW_VAR, SERIES_EW_HOLT } fossil_data_series_ew_kind_t;
+
+/*
+ * Advance `lanes` series (a multiple of SERIES_EW_W) through `steps`
+ * rows of v in place; row r holds lane l at v[r * lanes + l]. a and b
+ * carry each lane's mean and variance, or level and trend. When first
+ * is set, row 0 starts every lane: mean or level at the value, variance
+ * and trend at 0.
+ */
+static void fossil_data_series_ew_block(fossil_data_series_ew_kind_t kind, double alpha,
+                                        double beta, double *v, size_t steps, size_t lanes,
+                                        double *a, double *b, int first)
+{
+    typedef fossil_data_series_ew_vec_t vec;
+    size_t r = 0;
+    if (first) {
+        for (size_t l = 0; l < lanes; l++) {
+            a[l] = v[l];
+            b[l] = 0.0;
+            if (kind == SERIES_EW_VAR) v[l] = 0.0;
+        }
+        r = 1;
+    }
+    const vec va = SERIES_EW_SET1(alpha), vc = SERIES_EW_SET1(1.0 - alpha);
+    const vec vb = SERIES_EW_SET1(beta), vd = SERIES_EW_SET1(1.0 - beta);
+
+    // lanes inside time: each step issues independent updates across lanes
+    for (; r < steps; r++) {
+        double *row = v + r * lanes;
+        for (size_t l = 0; l < lanes; l += SERIES_EW_W) {
+            vec x = SERIES_EW_LOAD(row + l);
+            vec m = SERIES_EW_LOAD(a + l);
+            if (kind == SERIES_EW_MEAN) {
+                m = SERIES_EW_ADD(m, SERIES_EW_MUL(va, SERIES_EW_SUB(x, m)));
+                SERIES_EW_STORE(row + l, m);
+            } else if (kind == SERIES_EW_VAR) {
+                vec d = SERIES_EW_SUB(x, m);
+                vec inc = SERIES_EW_MUL(va, d);
+                vec s = SERIES_EW_MUL(vc, SERIES_EW_ADD(SERIES_EW_LOAD(b + l),
+                                                        SERIES_EW_MUL(d, inc)));
+                m = SERIES_EW_ADD(m, inc);
+                SERIES_EW_STORE(b + l, s);
+                SERIES_EW_STORE(row + l, s);
+            } else {
+                vec t = SERIES_EW_LOAD(b + l);
+                vec lv = SERIES_EW_ADD(SERIES_EW_MUL(va, x),
+                                       SERIES_EW_MUL(vc, SERIES_EW_ADD(m, t)));
+                t = SERIES_EW_ADD(SERIES_EW_MUL(vb, SERIES_EW_SUB(lv, m)), SERIES_EW_MUL(vd, t));
+                m = lv;
+                SERIES_EW_STORE(b + l, t);
+                SERIES_EW_STORE(row + l, SERIES_EW_ADD(m, t));
+            }
+            SERIES_EW_STORE(a + l, m);
+        }
+    }
+}
+
+typedef struct {
+    fossil_data_series_ew_kind_t kind;
+    double alpha, beta;
+    const void *in;
+    void *out;
+    size_t n_series, count;
+    int by_series;          /* series-major: value (s, t) at s * count + t */
+    fossil_data_series_dtype_t t;
+} fossil_data_series_ew_job_t;
+
+static void fossil_data_series_ew_chunk(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_ew_job_t *job = ctx;
+    double tile[SERIES_EW_TILE], col[SERIES_EW_TILE / SERIES_EW_COLUMN];
+    double a[SERIES_EW_ROW], b[SERIES_EW_ROW];
+    size_t block = job->by_series ? SERIES_EW_COLUMN : SERIES_EW_ROW;
+    (void)chunk;
+
+    for (size_t g = begin; g < end; g++) {
+        size_t s0 = g * block;
+        size_t ns = job->n_series - s0 < block ? job->n_series - s0 : block;
+        size_t lanes = (ns + SERIES_EW_W - 1) / SERIES_EW_W * SERIES_EW_W;
+        size_t steps = SERIES_EW_TILE / (job->by_series ? SERIES_EW_COLUMN : lanes);
+        for (size_t t0 = 0; t0 < job->count; t0 += steps) {
+            size_t st = job->count - t0 < steps ? job->count - t0 : steps;
+            if (job->by_series) {
+                for (size_t l = 0; l < ns; l++) {
+                    fossil_data_series_load_f64(job->in, (s0 + l) * job->count + t0, st,
+                                                job->t, col);
+                    for (size_t k = 0; k < st; k++) tile[k * lanes + l] = col[k];
+                }
+            } else {
+                for (size_t k = 0; k < st; k++)
+                    fossil_data_series_load_f64(job->in, (t0 + k) * job->n_series + s0, ns,
+                                                job->t, tile + k * lanes);
+            }
+            for (size_t k = 0; k < st && ns < lanes; k++)
+                memset(tile + k * lanes + ns, 0, (lanes - ns) * sizeof(double));
+
+            fossil_data_series_ew_block(job->kind, job->alpha, job->beta, tile, st, lanes,
+                                        a, b, t0 == 0);
+
+            if (job->by_series) {
+                for (size_t l = 0; l < ns; l++) {
+                    for (size_t k = 0; k < st; k++) col[k] = tile[k * lanes + l];
+                    fossil_data_series_store_f64(job->out, (s0 + l) * job->count + t0, st,
+                                                 job->t, col);
+                }
+            } else {
+                for (size_t k = 0; k < st; k++)
+                    fossil_data_series_store_f64(job->out, (t0 + k) * job->n_series + s0, ns,
+                                                 job->t, tile + k * lanes);
+            }
+        }
+    }
+}
+
+static int fossil_data_series_ew(const void *input, void *output, size_t n_series, size_t count,
+                                 fossil_data_series_ew_kind_t kind, double alpha, double beta,
+                                 int by_series, const char *type_id)
+{
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || n_series == 0 || count == 0 || t == SERIES_INVALID ||
+        !(alpha > 0 && alpha <= 1) || !(beta >= 0 && beta <= 1))
+        return -1;
+    fossil_data_series_ew_job_t job = {
+        kind, alpha, beta, input, output, n_series, count, by_series, t
+    };
+    size_t block = by_series ? SERIES_EW_COLUMN : SERIES_EW_ROW;
+    size_t blocks = (n_series + block - 1) / block;
+    fossil_data_parallel_for(blocks, 1, fossil_data_series_ew_chunk, &job);
+    return 0;
+}
+
+int fossil_data_series_ewma(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    const char* type_id
+){
+    return fossil_data_series_ew(input, output, 1, count, SERIES_EW_MEAN, alpha, 0.0, 1, type_id);
+}
+
+int fossil_data_series_ewvar(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    const char* type_id
+){
+    return fossil_data_series_ew(input, output, 1, count, SERIES_EW_VAR, alpha, 0.0, 1, type_id);
+}
+
+int fossil_data_series_holt(
+    const void* input,
+    void* output,
+    size_t count,
+    double alpha,
+    double beta,
+    const char* type_id
+){
+    return fossil_data_series_ew(input, output, 1, count, SERIES_EW_HOLT, alpha, beta, 1, type_id);
+}
+
+int fossil_data_series_ew_many(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    const char* method,
+    double alpha,
+    double beta,
+    const char* layout,
+    const char* type_id
+){
+    fossil_data_series_ew_kind_t kind;
+    if (!method) return -1;
+    if (!strcmp(method, "ewma"))       kind = SERIES_EW_MEAN;
+    else if (!strcmp(method, "ewvar")) kind = SERIES_EW_VAR;
+    else if (!strcmp(method, "holt"))  kind = SERIES_EW_HOLT;
+    else return -1;
+    int by_series;
+    if (!layout || !strcmp(layout, "time")) by_series = 0;
+    else if (!strcmp(layout, "series")) by_series = 1;
+    else return -1;
+    if (kind != SERIES_EW_HOLT) beta = 0.0;
+    return fossil_data_series_ew(input, output, n_series, count, kind, alpha, beta, by_series,
+                                 type_id);
+}
+
+/* ---------------------------------------------------------
+ * Batches
+ * --------------------------------------------------------- */
+
+/*
+ * A batch is a block of n_series rows of count values, row s starting
+ * at s * stride. The type and arguments are checked once, rows are
+ * spread across the pool in chunks of roughly SERIES_SCAN_GRAIN values,
+ * and each row gets exactly what the single-series call returns for it.
+ */
+typedef struct {
+    const void *in;
+    void *out;
+    size_t count, stride;
+    fossil_data_series_dtype_t t;
+    fossil_data_series_stat_t stat;  /* rolling batches */
+    size_t window, ddof;
+    double q;
+    int *status;                     /* per chunk, rolling batches */
+} fossil_data_series_batch_job_t;
+
+static size_t fossil_data_series_batch_grain(size_t count)
+{
+    return count < SERIES_SCAN_GRAIN ? SERIES_SCAN_GRAIN / count : 1;
+}
+
+static void fossil_data_series_cumsum_rows(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_batch_job_t *job = ctx;
+    (void)chunk;
+    for (size_t r = begin; r < end; r++)
+        fossil_data_series_cumsum_serial(job->in, job->out, r * job->stride, job->count, job->t);
+}
+
+static void fossil_data_series_rolling_rows(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_batch_job_t *job = ctx;
+    fossil_data_series_window_t w;
+    job->status[chunk] = fossil_data_series_window_init(&w, job->stat, job->window,
+                                                        job->ddof, job->q);
+    if (job->status[chunk] != 0) return;
+    for (size_t r = begin; r < end; r++) {
+        if (r > begin) fossil_data_series_window_reset(&w);
+        fossil_data_series_window_run(&w, job->in, job->out, r * job->stride, job->count, job->t);
+    }
+    fossil_data_series_window_free(&w);
+}
+
+int fossil_data_series_cumsum_batch(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    size_t stride,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || n_series == 0 || count == 0 || stride < count ||
+        t == SERIES_INVALID)
+        return -1;
+    fossil_data_series_batch_job_t job = { input, output, count, stride, t,
+                                           SERIES_STAT_SUM, 0, 0, 0.0, NULL };
+    fossil_data_parallel_for(n_series, fossil_data_series_batch_grain(count),
+                             fossil_data_series_cumsum_rows, &job);
+    return 0;
+}
+
+int fossil_data_series_rolling_batch(
+    const void* input,
+    void* output,
+    size_t n_series,
+    size_t count,
+    size_t stride,
+    const char* stat,
+    size_t window,
+    size_t ddof,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    fossil_data_series_stat_t kind;
+    double q;
+    if (!input || !output || n_series == 0 || count == 0 || stride < count || window == 0 ||
+        t == SERIES_INVALID || fossil_data_series_stat_parse(stat, &kind, &q) != 0)
+        return -1;
+
+    size_t grain = fossil_data_series_batch_grain(count);
+    size_t chunks = fossil_data_parallel_chunks(n_series, grain);
+    int *status = calloc(chunks, sizeof(int));
+    if (!status) return -3;
+    fossil_data_series_batch_job_t job = { input, output, count, stride, t,
+                                           kind, window, ddof, q, status };
+    fossil_data_parallel_for(n_series, grain, fossil_data_series_rolling_rows, &job);
+    int rc = 0;
+    for (size_t c = 0; c < chunks && rc == 0; c++) rc = status[c];
+    free(status);
+    return rc;
+}
+
+/* ---------------------------------------------------------
+ * Resampling
+ * --------------------------------------------------------- */
+
+typedef enum {
+    SERIES_AGG_SUM,
+    SERIES_AGG_MEAN,
+    SERIES_AGG_MIN,
+    SERIES_AGG_MAX,
+    SERIES_AGG_LAST
+} fossil_data_series_agg_t;
+
+static int fossil_data_series_agg_parse(const char *name, fossil_data_series_agg_t *agg)
+{
+    if (!name) return -1;
+    if (!strcmp(name, "sum"))  { *agg = SERIES_AGG_SUM;  return 0; }
+    if (!strcmp(name, "mean")) { *agg = SERIES_AGG_MEAN; return 0; }
+    if (!strcmp(name, "min"))  { *agg = SERIES_AGG_MIN;  return 0; }
+    if (!strcmp(name, "max"))  { *agg = SERIES_AGG_MAX;  return 0; }
+    if (!strcmp(name, "last")) { *agg = SERIES_AGG_LAST; return 0; }
+    return -1;
+}
+
+/* floor(a / b) for b > 0. */
+static int64_t fossil_data_series_floor_div(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+int fossil_data_series_resample_span(
+    const fossil_data_series_timed_t* series,
+    int64_t period,
+    int64_t* origin,
+    size_t* n_buckets
+){
+    if (!series || !series->time || series->count == 0 || period <= 0 || !origin || !n_buckets)
+        return -1;
+    int64_t first = fossil_data_series_floor_div(series->time[0], period);
+    int64_t last = fossil_data_series_floor_div(series->time[series->count - 1], period);
+    if (last < first) return -1;
+    *origin = first * period;
+    *n_buckets = (size_t)((uint64_t)last - (uint64_t)first) + 1;
+    return 0;
+}
+
+static double fossil_data_series_agg_value(fossil_data_series_agg_t kind, size_t n, double sum,
+                                           double lo, double hi, double last)
+{
+    switch (kind) {
+    case SERIES_AGG_SUM:  return sum;
+    case SERIES_AGG_MEAN: return sum / (double)n;
+    case SERIES_AGG_MIN:  return lo;
+    case SERIES_AGG_MAX:  return hi;
+    default:              return last;
+    }
+}
+
+/* Buckets staged for storing, a tile at a time. */
+typedef struct {
+    double out[SERIES_SCAN_TILE];
+    size_t filled, k;         /* staged buckets, buckets written so far */
+    int64_t *time;            /* bucket start times, or NULL */
+    void *output;
+    fossil_data_series_dtype_t t;
+} fossil_data_series_bucket_t;
+
+static void fossil_data_series_bucket_put(fossil_data_series_bucket_t *b, double v, int64_t start)
+{
+    b->out[b->filled++] = v;
+    if (b->time) b->time[b->k] = start;
+    b->k++;
+    if (b->filled == SERIES_SCAN_TILE) {
+        fossil_data_series_store_f64(b->output, b->k - b->filled, b->filled, b->t, b->out);
+        b->filled = 0;
+    }
+}
+
+/*
+ * One merge pass over the samples and the buckets. Both advance in time
+ * order: a sample at or past the current bucket's end closes it (and any
+ * empty buckets in between), so each sample is compared against a single
+ * bucket boundary and no division happens per sample. Samples are
+ * converted and buckets stored a tile at a time.
+ */
+int fossil_data_series_resample(
+    const fossil_data_series_timed_t* series,
+    int64_t origin,
+    int64_t period,
+    size_t n_buckets,
+    const char* agg,
+    const char* fill,
+    int64_t* bucket_time,
+    void* output
+){
+    fossil_data_series_agg_t kind;
+    if (!series || (series->count > 0 && (!series->time || !series->values)) || !output ||
+        period <= 0 || n_buckets == 0 || fossil_data_series_agg_parse(agg, &kind) != 0)
+        return -1;
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(series->type_id);
+    if (t == SERIES_INVALID) return -1;
+    int ffill;
+    if (!fill || !strcmp(fill, "none")) ffill = 0;
+    else if (!strcmp(fill, "ffill")) ffill = 1;
+    else return -1;
+    /* Bucket ends up to origin + (n_buckets + 1) * period must fit in int64. */
+    if ((uint64_t)n_buckets >= (uint64_t)((INT64_MAX - (origin > 0 ? origin : 0)) / period))
+        return -1;
+
+    const int64_t *time = series->time;
+    size_t count = series->count;
+
+    /* Samples before origin only seed the forward fill. */
+    size_t first = 0;
+    while (first < count && time[first] < origin) {
+        if (first > 0 && time[first] < time[first - 1]) return -1;
+        first++;
+    }
+    int64_t seen = first > 0 ? time[first - 1] : INT64_MIN;
+    double prev = NAN, in[SERIES_SCAN_TILE];
+    if (first > 0) fossil_data_series_load_f64(series->values, first - 1, 1, t, &prev);
+
+    fossil_data_series_bucket_t b;
+    b.filled = b.k = 0;
+    b.time = bucket_time;
+    b.output = output;
+    b.t = t;
+    int64_t end = origin + period;
+    double sum = 0.0, lo = INFINITY, hi = -INFINITY, last = 0.0;
+    size_t n = 0;
+    for (size_t base = first; base < count && b.k < n_buckets; base += SERIES_SCAN_TILE) {
+        size_t m = count - base < SERIES_SCAN_TILE ? count - base : SERIES_SCAN_TILE;
+        fossil_data_series_load_f64(series->values, base, m, t, in);
+        for (size_t i = 0; i < m; i++) {
+            int64_t ts = time[base + i];
+            double v = in[i];
+            if (ts < seen) return -1;
+            seen = ts;
+            if (ts >= end) {
+                do {
+                    double out = n ? fossil_data_series_agg_value(kind, n, sum, lo, hi, last)
+                                   : ffill ? prev : NAN;
+                    prev = out;
+                    fossil_data_series_bucket_put(&b, out, end - period);
+                    end += period;
+                    n = 0;
+                } while (ts >= end && b.k < n_buckets);
+                if (b.k == n_buckets) break;
+                sum = 0.0;
+                lo = hi = v;
+            }
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+            sum += v;
+            last = v;
+            n++;
+        }
+    }
+    /* Close the open bucket, then the empty ones after the last sample. */
+    while (b.k < n_buckets) {
+        double out = n ? fossil_data_series_agg_value(kind, n, sum, lo, hi, last)
+                       : ffill ? prev : NAN;
+        prev = out;
+        fossil_data_series_bucket_put(&b, out, end - period);
+        end += period;
+        n = 0;
+    }
+    if (b.filled > 0) fossil_data_series_store_f64(output, b.k - b.filled, b.filled, t, b.out);
+    return 0;
+}
+
+/* ---------------------------------------------------------
+ * Time alignment
+ * --------------------------------------------------------- */
+
+#define SERIES_NO_MATCH SIZE_MAX
+
+/*
+ * First index in [lo, n) whose time is past t, given time[lo - 1] <= t.
+ * Gallops forward from lo and finishes with a binary search, so a short
+ * step costs one comparison and a long one O(log distance).
+ */
+static size_t fossil_data_series_gallop(const int64_t *time, size_t lo, size_t n, int64_t t)
+{
+    if (lo >= n || time[lo] > t) return lo;
+    size_t step = 1, hi = lo + 1;          /* time[lo] <= t */
+    while (hi < n && time[hi] <= t) {
+        lo = hi;
+        step <<= 1;
+        hi = n - lo > step ? lo + step : n;
+    }
+    lo++;                                  /* answer in [lo, hi] */
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (time[mid] <= t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* First index whose time is at or past t. */
+static size_t fossil_data_series_lower_bound(const int64_t *time, size_t n, int64_t t)
+{
+    return t == INT64_MIN ? 0 : fossil_data_series_gallop(time, 0, n, t - 1);
+}
+
+typedef struct {
+    const int64_t *time;
+    int *status;                           /* per chunk, 0 when sorted */
+} fossil_data_series_sorted_job_t;
+
+static void fossil_data_series_sorted_chunk(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_sorted_job_t *job = ctx;
+    const int64_t *time = job->time;
+    int bad = 0;
+    for (size_t i = begin > 0 ? begin : 1; i < end; i++) bad |= time[i] < time[i - 1];
+    job->status[chunk] = bad;
+}
+
+/* 0 when time does not decrease, -1 when it does, -3 on allocation failure. */
+static int fossil_data_series_check_sorted(const int64_t *time, size_t n)
+{
+    if (n < 2) return 0;
+    size_t chunks = fossil_data_parallel_chunks(n, SERIES_SCAN_GRAIN);
+    int *status = calloc(chunks, sizeof(int));
+    if (!status) return -3;
+    fossil_data_series_sorted_job_t job = { time, status };
+    fossil_data_parallel_for(n, SERIES_SCAN_GRAIN, fossil_data_series_sorted_chunk, &job);
+    int rc = 0;
+    for (size_t c = 0; c < chunks; c++)
+        if (status[c]) rc = -1;
+    free(status);
+    return rc;
+}
+
+#define SERIES_GATHER(ctype, missing) \
+    { ctype* p = (ctype*)dst + offset; const ctype* s = (const ctype*)src; \
+      for (size_t i = 0; i < n; i++) \
+          p[i] = idx[i] == SERIES_NO_MATCH ? (missing) : s[idx[i]]; } break
+
+/* dst[offset + i] = src[idx[i]]; unmatched elements store NaN, or 0 for integer types. */
+static void fossil_data_series_gather(void *dst, size_t offset, const void *src, const size_t *idx,
+                                      size_t n, fossil_data_series_dtype_t t)
+{
+    switch (t) {
+    case SERIES_I8:  case SERIES_U8: case SERIES_BOOL: SERIES_GATHER(uint8_t, 0);
+    case SERIES_I16: case SERIES_U16: SERIES_GATHER(uint16_t, 0);
+    case SERIES_I32: case SERIES_U32: SERIES_GATHER(uint32_t, 0);
+    case SERIES_I64: case SERIES_U64: SERIES_GATHER(uint64_t, 0);
+    case SERIES_SIZE: SERIES_GATHER(size_t, 0);
+    case SERIES_F32:  SERIES_GATHER(float, NAN);
+    case SERIES_F64:  SERIES_GATHER(double, NAN);
+    default: break;
+    }
+}
+
+typedef struct {
+    const int64_t *time;
+    const fossil_data_series_timed_t *right;
+    fossil_data_series_dtype_t t;
+    uint64_t tolerance;                    /* UINT64_MAX when unlimited */
+    void *output;
+    size_t *index;
+} fossil_data_series_asof_job_t;
+
+/*
+ * Each chunk finds its start in the right series by galloping from the
+ * front, then walks both sides together; a tile of matched indices is
+ * gathered into output in one call.
+ */
+static void fossil_data_series_asof_chunk(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_asof_job_t *job = ctx;
+    const int64_t *rtime = job->right->time;
+    size_t rn = job->right->count, j = 0;
+    size_t tile[SERIES_SCAN_TILE];
+    (void)chunk;
+    for (size_t base = begin; base < end; base += SERIES_SCAN_TILE) {
+        size_t m = end - base < SERIES_SCAN_TILE ? end - base : SERIES_SCAN_TILE;
+        size_t *idx = job->index ? job->index + base : tile;
+        for (size_t i = 0; i < m; i++) {
+            int64_t ts = job->time[base + i];
+            j = fossil_data_series_gallop(rtime, j, rn, ts);
+            idx[i] = j > 0 && (uint64_t)ts - (uint64_t)rtime[j - 1] <= job->tolerance
+                   ? j - 1 : SERIES_NO_MATCH;
+        }
+        if (job->output)
+            fossil_data_series_gather(job->output, base, job->right->values, idx, m, job->t);
+    }
+}
+
+/* As-of join on checked arguments; both time columns are known to be sorted. */
+static void fossil_data_series_asof_run(const int64_t *time, size_t count,
+                                        const fossil_data_series_timed_t *right,
+                                        fossil_data_series_dtype_t t, int64_t tolerance,
+                                        void *output, size_t *index)
+{
+    fossil_data_series_asof_job_t job = {
+        time, right, t, tolerance < 0 ? UINT64_MAX : (uint64_t)tolerance, output, index
+    };
+    fossil_data_parallel_for(count, SERIES_SCAN_GRAIN, fossil_data_series_asof_chunk, &job);
+}
+
+int fossil_data_series_asof(
+    const int64_t* time,
+    size_t count,
+    const fossil_data_series_timed_t* right,
+    int64_t tolerance,
+    void* output,
+    size_t* index
+){
+    if (!time || count == 0 || !right || (right->count > 0 && (!right->time || !right->values)) ||
+        (!output && !index))
+        return -1;
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(right->type_id);
+    if (t == SERIES_INVALID) return -1;
+    int rc = fossil_data_series_check_sorted(time, count);
+    if (rc == 0) rc = fossil_data_series_check_sorted(right->time, right->count);
+    if (rc != 0) return rc;
+    fossil_data_series_asof_run(time, count, right, t, tolerance, output, index);
+    return 0;
+}
+
+/*
+ * The union of timestamps is cut into time ranges at samples of the
+ * longest series. bounds holds, for every range c and series s, the
+ * first sample of s at or past the range start, so ranges are merged
+ * independently: once to count their rows and once to write them at
+ * their prefix offsets.
+ */
+typedef struct {
+    const fossil_data_series_timed_t *series;
+    size_t n_series;
+    const size_t *bounds;                  /* (ranges + 1) x n_series */
+    size_t *pos;                           /* ranges x n_series scratch */
+    int64_t *head;                         /* time at pos, INT64_MAX once exhausted */
+    size_t *rows;                          /* per range: count, then offset */
+    int64_t *out;                          /* NULL while counting */
+} fossil_data_series_merge_job_t;
+
+static void fossil_data_series_merge_chunk(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_merge_job_t *job = ctx;
+    size_t k = job->n_series;
+    (void)chunk;
+    for (size_t c = begin; c < end; c++) {
+        size_t *pos = job->pos + c * k;
+        int64_t *head = job->head + c * k;
+        const size_t *stop = job->bounds + (c + 1) * k;
+        size_t live = 0;
+        memcpy(pos, job->bounds + c * k, k * sizeof(size_t));
+        for (size_t s = 0; s < k; s++) {
+            live += pos[s] < stop[s];
+            head[s] = pos[s] < stop[s] ? job->series[s].time[pos[s]] : INT64_MAX;
+        }
+        int64_t *out = job->out ? job->out + job->rows[c] : NULL;
+        size_t rows = 0;
+        while (live > 0) {
+            int64_t t = head[0];
+            for (size_t s = 1; s < k; s++) t = head[s] < t ? head[s] : t;
+            if (out) out[rows] = t;
+            rows++;
+            for (size_t s = 0; s < k; s++) {
+                if (head[s] != t || pos[s] == stop[s]) continue;
+                const int64_t *time = job->series[s].time;
+                pos[s] = fossil_data_series_gallop(time, pos[s], stop[s], t);
+                if (pos[s] < stop[s]) head[s] = time[pos[s]];
+                else {
+                    head[s] = INT64_MAX;       /* exhausted */
+                    live--;
+                }
+            }
+        }
+        if (!out) job->rows[c] = rows;
+    }
+}
+
+int fossil_data_series_merge(
+    const fossil_data_series_timed_t* series,
+    size_t n_series,
+    int64_t tolerance,
+    int64_t* time,
+    void* const* outputs,
+    size_t capacity,
+    size_t* count
+){
+    if (!series || n_series == 0 || !count) return -1;
+    size_t longest = 0;
+    for (size_t s = 0; s < n_series; s++) {
+        const fossil_data_series_timed_t *x = &series[s];
+        if ((x->count > 0 && (!x->time || !x->values)) ||
+            fossil_data_series_dtype(x->type_id) == SERIES_INVALID)
+            return -1;
+        int rc = fossil_data_series_check_sorted(x->time, x->count);
+        if (rc != 0) return rc;
+        if (x->count > series[longest].count) longest = s;
+    }
+
+    size_t ranges = fossil_data_parallel_chunks(series[longest].count, SERIES_SCAN_GRAIN);
+    if (ranges == 0) ranges = 1;
+    size_t *bounds = malloc((ranges + 1) * n_series * sizeof(size_t));
+    size_t *pos = malloc(ranges * n_series * sizeof(size_t));
+    int64_t *head = malloc(ranges * n_series * sizeof(int64_t));
+    size_t *rows = malloc(ranges * sizeof(size_t));
+    if (!bounds || !pos || !head || !rows) {
+        free(bounds);
+        free(pos);
+        free(head);
+        free(rows);
+        return -3;
+    }
+    for (size_t s = 0; s < n_series; s++) {
+        bounds[s] = 0;
+        bounds[ranges * n_series + s] = series[s].count;
+    }
+    for (size_t c = 1; c < ranges; c++) {
+        int64_t start = series[longest].time[c * SERIES_SCAN_GRAIN];
+        for (size_t s = 0; s < n_series; s++)
+            bounds[c * n_series + s] =
+                fossil_data_series_lower_bound(series[s].time, series[s].count, start);
+    }
+
+    fossil_data_series_merge_job_t job = { series, n_series, bounds, pos, head, rows, NULL };
+    fossil_data_parallel_for(ranges, 1, fossil_data_series_merge_chunk, &job);
+    size_t total = 0;
+    for (size_t c = 0; c < ranges; c++) {
+        size_t r = rows[c];
+        rows[c] = total;
+        total += r;
+    }
+    *count = total;
+    int rc = 0;
+    if (time && capacity < total) rc = -1;
+    else if (time) {
+        job.out = time;
+        fossil_data_parallel_for(ranges, 1, fossil_data_series_merge_chunk, &job);
+        for (size_t s = 0; outputs && s < n_series; s++)
+            if (outputs[s] && total > 0)
+                fossil_data_series_asof_run(time, total, &series[s],
+                                            fossil_data_series_dtype(series[s].type_id),
+                                            tolerance, outputs[s], NULL);
+    }
+    free(bounds);
+    free(pos);
+    free(head);
+    free(rows);
+    return rc;
+}
+
+/* ---------------------------------------------------------
+ * Spectral
+ * --------------------------------------------------------- */
+
+#define SERIES_FFT_RADIX_MAX 13   /* larger prime factors go through Bluestein */
+#define SERIES_FFT_STAGES    64
+#define SERIES_FFT_CACHE     8    /* cached plans */
+#define SERIES_FFT_DIRECT    32   /* shorter kernels and lag ranges run direct */
+
+/*
+ * Complex values are interleaved (re, im) doubles and the butterflies
+ * keep one value per 128-bit register. A twiddle is stored as
+ * (re, re, -im, im) so a product is two multiplies and an add on the
+ * value and its swapped copy.
+ */
+#if defined(__AVX__) || defined(SERIES_HAVE_SSE2)
+typedef __m128d fossil_data_series_cpx_t;
+#define SERIES_CPX_LOAD(p)     _mm_loadu_pd(p)
+#define SERIES_CPX_STORE(p, v) _mm_storeu_pd((p), (v))
+#define SERIES_CPX_ADD(a, b)   _mm_add_pd((a), (b))
+#define SERIES_CPX_SUB(a, b)   _mm_sub_pd((a), (b))
+#define SERIES_CPX_SCALE(a, c) _mm_mul_pd((a), _mm_set1_pd(c))
+#define SERIES_CPX_SWAP(a)     _mm_shuffle_pd((a), (a), 1)
+#define SERIES_CPX_NEG_I(a)    _mm_xor_pd(SERIES_CPX_SWAP(a), _mm_set_pd(-0.0, 0.0))
+#define SERIES_CPX_MUL(a, w)   _mm_add_pd(_mm_mul_pd((a), _mm_loadu_pd(w)), \
+                                          _mm_mul_pd(SERIES_CPX_SWAP(a), _mm_loadu_pd((w) + 2)))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+typedef float64x2_t fossil_data_series_cpx_t;
+#define SERIES_CPX_LOAD(p)     vld1q_f64(p)
+#define SERIES_CPX_STORE(p, v) vst1q_f64((p), (v))
+#define SERIES_CPX_ADD(a, b)   vaddq_f64((a), (b))
+#define SERIES_CPX_SUB(a, b)   vsubq_f64((a), (b))
+#define SERIES_CPX_SCALE(a, c) vmulq_n_f64((a), (c))
+#define SERIES_CPX_SWAP(a)     vextq_f64((a), (a), 1)
+#define SERIES_CPX_NEG_I(a)    vmulq_f64(SERIES_CPX_SWAP(a), \
+                                         vcombine_f64(vdup_n_f64(1.0), vdup_n_f64(-1.0)))
+#define SERIES_CPX_MUL(a, w)   vfmaq_f64(vmulq_f64((a), vld1q_f64(w)), \
+                                         SERIES_CPX_SWAP(a), vld1q_f64((w) + 2))
+#else
+typedef struct { double re, im; } fossil_data_series_cpx_t;
+
+static fossil_data_series_cpx_t fossil_data_series_cpx(double re, double im)
+{
+    fossil_data_series_cpx_t v;
+    v.re = re;
+    v.im = im;
+    return v;
+}
+
+#define SERIES_CPX_LOAD(p)     fossil_data_series_cpx((p)[0], (p)[1])
+#define SERIES_CPX_STORE(p, v) ((p)[0] = (v).re, (p)[1] = (v).im)
+#define SERIES_CPX_ADD(a, b)   fossil_data_series_cpx((a).re + (b).re, (a).im + (b).im)
+#define SERIES_CPX_SUB(a, b)   fossil_data_series_cpx((a).re - (b).re, (a).im - (b).im)
+#define SERIES_CPX_SCALE(a, c) fossil_data_series_cpx((a).re * (c), (a).im * (c))
+#define SERIES_CPX_NEG_I(a)    fossil_data_series_cpx((a).im, -(a).re)
+#define SERIES_CPX_MUL(a, w)   fossil_data_series_cpx((a).re * (w)[0] + (a).im * (w)[2], \
+                                                      (a).im * (w)[1] + (a).re * (w)[3])
+#endif
+
+static void fossil_data_series_twiddle(double *w, double angle)
+{
+    double c = cos(angle), s = sin(angle);
+    w[0] = c;
+    w[1] = c;
+    w[2] = -s;
+    w[3] = s;
+}
+
+/*
+ * Complex forward transform of n points. Stage i is a Stockham pass of
+ * radix r over length len = r * m: it reads x[q + s*(p + k*m)] and
+ * writes the twiddled radix-r DFT to y[q + s*(r*p + j)], so the data
+ * ends in natural order without a bit-reversal pass. Lengths with a
+ * prime factor above SERIES_FFT_RADIX_MAX run Bluestein's chirp
+ * convolution on a power-of-two plan instead.
+ */
+typedef struct fossil_data_series_fft_s {
+    size_t n, stages;
+    size_t radix[SERIES_FFT_STAGES];
+    size_t tw_at[SERIES_FFT_STAGES];    /* twiddles of stage i in tw */
+    size_t root_at[SERIES_FFT_STAGES];  /* roots of unity for generic radices */
+    double *tw;
+    size_t work;                        /* complex scratch for a run */
+    struct fossil_data_series_fft_s *sub;
+    double *chirp, *kernel;             /* Bluestein, plain (re, im) */
+} fossil_data_series_fft_t;
+
+static void fossil_data_series_fft_free(fossil_data_series_fft_t *p)
+{
+    if (!p) return;
+    fossil_data_series_fft_free(p->sub);
+    free(p->tw);
+    free(p->chirp);
+    free(p->kernel);
+    free(p);
+}
+
+static void fossil_data_series_fft_run(const fossil_data_series_fft_t *p, double *x, double *work);
+
+/* Unscaled inverse: conjugate, forward, conjugate. */
+static void fossil_data_series_fft_inverse(const fossil_data_series_fft_t *p, double *x,
+                                           double *work)
+{
+    for (size_t i = 0; i < p->n; i++) x[2 * i + 1] = -x[2 * i + 1];
+    fossil_data_series_fft_run(p, x, work);
+    for (size_t i = 0; i < p->n; i++) x[2 * i + 1] = -x[2 * i + 1];
+}
+
+static fossil_data_series_fft_t *fossil_data_series_fft_create(size_t n);
+
+static fossil_data_series_fft_t *fossil_data_series_fft_bluestein(fossil_data_series_fft_t *p)
+{
+    size_t n = p->n, m = 1;
+    while (m < 2 * n - 1) m <<= 1;
+    p->sub = fossil_data_series_fft_create(m);
+    p->chirp = malloc(2 * n * sizeof(double));
+    p->kernel = calloc(2 * m, sizeof(double));
+    if (!p->sub || !p->chirp || !p->kernel) {
+        fossil_data_series_fft_free(p);
+        return NULL;
+    }
+    /* chirp[j] = exp(-pi i j^2 / n), with j^2 reduced mod 2n to keep the angle exact. */
+    size_t jj = 0;
+    for (size_t j = 0; j < n; j++) {
+        double angle = -M_PI * (double)jj / (double)n;
+        p->chirp[2 * j] = cos(angle);
+        p->chirp[2 * j + 1] = sin(angle);
+        jj = (jj + 2 * j + 1) % (2 * n);
+    }
+    /* Kernel: FFT of the conjugate chirp, wrapped, prescaled for the inverse. */
+    double *b = p->kernel;
+    for (size_t j = 0; j < n; j++) {
+        double re = p->chirp[2 * j] / (double)m, im = -p->chirp[2 * j + 1] / (double)m;
+        b[2 * j] = re;
+        b[2 * j + 1] = im;
+        if (j > 0) {
+            b[2 * (m - j)] = re;
+            b[2 * (m - j) + 1] = im;
+        }
+    }
+    double *scratch = malloc(2 * p->sub->work * sizeof(double));
+    if (!scratch) {
+        fossil_data_series_fft_free(p);
+        return NULL;
+    }
+    fossil_data_series_fft_run(p->sub, b, scratch);
+    free(scratch);
+    p->work = 2 * m;
+    return p;
+}
+
+static fossil_data_series_fft_t *fossil_data_series_fft_create(size_t n)
+{
+    fossil_data_series_fft_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->n = n;
+    p->work = n;
+    size_t rest = n;
+    while (rest > 1) {
+        size_t r = rest % 4 == 0 ? 4 : rest % 2 == 0 ? 2 : 0;
+        for (size_t f = 3; r == 0 && f <= SERIES_FFT_RADIX_MAX; f += 2)
+            if (rest % f == 0) r = f;
+        if (r == 0) return fossil_data_series_fft_bluestein(p);
+        p->radix[p->stages++] = r;
+        rest /= r;
+    }
+
+    size_t total = 0, len = n;
+    for (size_t i = 0; i < p->stages; i++) {
+        size_t r = p->radix[i];
+        p->tw_at[i] = total;
+        total += 4 * (r - 1) * (len / r);
+        p->root_at[i] = total;
+        if (r != 2 && r != 3 && r != 4) total += 4 * r;
+        len /= r;
+    }
+    p->tw = malloc((total > 0 ? total : 1) * sizeof(double));
+    if (!p->tw) {
+        fossil_data_series_fft_free(p);
+        return NULL;
+    }
+    len = n;
+    for (size_t i = 0; i < p->stages; i++) {
+        size_t r = p->radix[i], m = len / r;
+        double *w = p->tw + p->tw_at[i];
+        for (size_t q = 0; q < m; q++)
+            for (size_t j = 1; j < r; j++, w += 4)
+                fossil_data_series_twiddle(w, -2.0 * M_PI * (double)(j * q) / (double)len);
+        if (r != 2 && r != 3 && r != 4)
+            for (size_t j = 0; j < r; j++)
+                fossil_data_series_twiddle(p->tw + p->root_at[i] + 4 * j,
+                                           -2.0 * M_PI * (double)j / (double)r);
+        len = m;
+    }
+    return p;
+}
+
+static void fossil_data_series_fft_stage2(size_t m, size_t s, const double *tw,
+                                          const double *x, double *y)
+{
+    for (size_t p = 0; p < m; p++, tw += 4) {
+        const double *in = x + 2 * s * p;
+        double *out = y + 4 * s * p;
+        for (size_t q = 0; q < s; q++) {
+            fossil_data_series_cpx_t a0 = SERIES_CPX_LOAD(in + 2 * q);
+            fossil_data_series_cpx_t a1 = SERIES_CPX_LOAD(in + 2 * (q + s * m));
+            SERIES_CPX_STORE(out + 2 * q, SERIES_CPX_ADD(a0, a1));
+            SERIES_CPX_STORE(out + 2 * (q + s), SERIES_CPX_MUL(SERIES_CPX_SUB(a0, a1), tw));
+        }
+    }
+}
+
+static void fossil_data_series_fft_stage3(size_t m, size_t s, const double *tw,
+                                          const double *x, double *y)
+{
+    const double h = 0.86602540378443864676;   /* sin(2 pi / 3) */
+    for (size_t p = 0; p < m; p++, tw += 8) {
+        const double *in = x + 2 * s * p;
+        double *out = y + 6 * s * p;
+        for (size_t q = 0; q < s; q++) {
+            fossil_data_series_cpx_t a0 = SERIES_CPX_LOAD(in + 2 * q);
+            fossil_data_series_cpx_t a1 = SERIES_CPX_LOAD(in + 2 * (q + s * m));
+            fossil_data_series_cpx_t a2 = SERIES_CPX_LOAD(in + 2 * (q + 2 * s * m));
+            fossil_data_series_cpx_t t = SERIES_CPX_ADD(a1, a2);
+            fossil_data_series_cpx_t c = SERIES_CPX_SUB(a0, SERIES_CPX_SCALE(t, 0.5));
+            fossil_data_series_cpx_t d =
+                SERIES_CPX_SCALE(SERIES_CPX_NEG_I(SERIES_CPX_SUB(a1, a2)), h);
+            SERIES_CPX_STORE(out + 2 * q, SERIES_CPX_ADD(a0, t));
+            SERIES_CPX_STORE(out + 2 * (q + s), SERIES_CPX_MUL(SERIES_CPX_ADD(c, d), tw));
+            SERIES_CPX_STORE(out + 2 * (q + 2 * s), SERIES_CPX_MUL(SERIES_CPX_SUB(c, d), tw + 4));
+        }
+    }
+}
+
+static void fossil_data_series_fft_stage4(size_t m, size_t s, const double *tw,
+                                          const double *x, double *y)
+{
+    for (size_t p = 0; p < m; p++, tw += 12) {
+        const double *in = x + 2 * s * p;
+        double *out = y + 8 * s * p;
+        for (size_t q = 0; q < s; q++) {
+            fossil_data_series_cpx_t a0 = SERIES_CPX_LOAD(in + 2 * q);
+            fossil_data_series_cpx_t a1 = SERIES_CPX_LOAD(in + 2 * (q + s * m));
+            fossil_data_series_cpx_t a2 = SERIES_CPX_LOAD(in + 2 * (q + 2 * s * m));
+            fossil_data_series_cpx_t a3 = SERIES_CPX_LOAD(in + 2 * (q + 3 * s * m));
+            fossil_data_series_cpx_t t0 = SERIES_CPX_ADD(a0, a2);
+            fossil_data_series_cpx_t t1 = SERIES_CPX_SUB(a0, a2);
+            fossil_data_series_cpx_t t2 = SERIES_CPX_ADD(a1, a3);
+            fossil_data_series_cpx_t t3 = SERIES_CPX_NEG_I(SERIES_CPX_SUB(a1, a3));
+            SERIES_CPX_STORE(out + 2 * q, SERIES_CPX_ADD(t0, t2));
+            SERIES_CPX_STORE(out + 2 * (q + s), SERIES_CPX_MUL(SERIES_CPX_ADD(t1, t3), tw));
+            SERIES_CPX_STORE(out + 2 * (q + 2 * s), SERIES_CPX_MUL(SERIES_CPX_SUB(t0, t2), tw + 4));
+            SERIES_CPX_STORE(out + 2 * (q + 3 * s), SERIES_CPX_MUL(SERIES_CPX_SUB(t1, t3), tw + 8));
+        }
+    }
+}
+
+/* Odd radix up to SERIES_FFT_RADIX_MAX as a direct r-point DFT. */
+static void fossil_data_series_fft_stage_any(size_t r, size_t m, size_t s, const double *tw,
+                                             const double *roots, const double *x, double *y)
+{
+    fossil_data_series_cpx_t a[SERIES_FFT_RADIX_MAX];
+    for (size_t p = 0; p < m; p++, tw += 4 * (r - 1)) {
+        const double *in = x + 2 * s * p;
+        double *out = y + 2 * r * s * p;
+        for (size_t q = 0; q < s; q++) {
+            for (size_t k = 0; k < r; k++) a[k] = SERIES_CPX_LOAD(in + 2 * (q + k * s * m));
+            for (size_t j = 0; j < r; j++) {
+                fossil_data_series_cpx_t b = a[0];
+                for (size_t k = 1, e = j; k < r; k++, e = (e + j) % r)
+                    b = SERIES_CPX_ADD(b, SERIES_CPX_MUL(a[k], roots + 4 * e));
+                if (j > 0) b = SERIES_CPX_MUL(b, tw + 4 * (j - 1));
+                SERIES_CPX_STORE(out + 2 * (q + j * s), b);
+            }
+        }
+    }
+}
+
+static void fossil_data_series_fft_run(const fossil_data_series_fft_t *p, double *x, double *work)
+{
+    if (p->sub) {
+        size_t n = p->n, m = p->sub->n;
+        double *a = work, *scratch = work + 2 * m;
+        for (size_t j = 0; j < n; j++) {
+            double xr = x[2 * j], xi = x[2 * j + 1], cr = p->chirp[2 * j], ci = p->chirp[2 * j + 1];
+            a[2 * j] = xr * cr - xi * ci;
+            a[2 * j + 1] = xr * ci + xi * cr;
+        }
+        memset(a + 2 * n, 0, 2 * (m - n) * sizeof(double));
+        fossil_data_series_fft_run(p->sub, a, scratch);
+        for (size_t k = 0; k < m; k++) {
+            double ar = a[2 * k], ai = a[2 * k + 1];
+            double kr = p->kernel[2 * k], ki = p->kernel[2 * k + 1];
+            a[2 * k] = ar * kr - ai * ki;
+            a[2 * k + 1] = ar * ki + ai * kr;
+        }
+        fossil_data_series_fft_inverse(p->sub, a, scratch);
+        for (size_t k = 0; k < n; k++) {
+            double ar = a[2 * k], ai = a[2 * k + 1], cr = p->chirp[2 * k], ci = p->chirp[2 * k + 1];
+            x[2 * k] = ar * cr - ai * ci;
+            x[2 * k + 1] = ar * ci + ai * cr;
+        }
+        return;
+    }
+    double *src = x, *dst = work;
+    size_t s = 1, len = p->n;
+    for (size_t i = 0; i < p->stages; i++) {
+        size_t r = p->radix[i], m = len / r;
+        const double *tw = p->tw + p->tw_at[i];
+        if (r == 4) fossil_data_series_fft_stage4(m, s, tw, src, dst);
+        else if (r == 2) fossil_data_series_fft_stage2(m, s, tw, src, dst);
+        else if (r == 3) fossil_data_series_fft_stage3(m, s, tw, src, dst);
+        else fossil_data_series_fft_stage_any(r, m, s, tw, p->tw + p->root_at[i], src, dst);
+        double *swap = src;
+        src = dst;
+        dst = swap;
+        s *= r;
+        len = m;
+    }
+    if (src != x) memcpy(x, src, 2 * p->n * sizeof(double));
+}
+
+/*
+ * Real transform of n points. For even n the samples are read as n/2
+ * complex values, transformed at half length and split into the n/2 + 1
+ * bins of the real spectrum; odd n runs the full complex transform.
+ */
+typedef struct {
+    size_t n;
+    fossil_data_series_fft_t *cpx;
+    double *split;                  /* exp(-2 pi i k / n), k <= n/2 */
+    size_t work;                    /* doubles of scratch for a run */
+} fossil_data_series_rfft_t;
+
+static void fossil_data_series_rfft_free(fossil_data_series_rfft_t *p)
+{
+    if (!p) return;
+    fossil_data_series_fft_free(p->cpx);
+    free(p->split);
+    free(p);
+}
+
+static fossil_data_series_rfft_t *fossil_data_series_rfft_create(size_t n)
+{
+    fossil_data_series_rfft_t *p = calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    p->n = n;
+    int even = n % 2 == 0;
+    p->cpx = fossil_data_series_fft_create(even ? n / 2 : n);
+    p->split = even ? malloc((n + 2) * sizeof(double)) : NULL;
+    if (!p->cpx || (even && !p->split)) {
+        fossil_data_series_rfft_free(p);
+        return NULL;
+    }
+    for (size_t k = 0; even && k <= n / 2; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        p->split[2 * k] = cos(angle);
+        p->split[2 * k + 1] = sin(angle);
+    }
+    p->work = (even ? n : 2 * n) + 2 * p->cpx->work;
+    return p;
+}
+
+/* spectrum receives n/2 + 1 interleaved bins. */
+static void fossil_data_series_rfft_run(const fossil_data_series_rfft_t *p, const double *x,
+                                        double *spectrum, double *work)
+{
+    size_t n = p->n;
+    if (n % 2 != 0) {
+        for (size_t j = 0; j < n; j++) {
+            work[2 * j] = x[j];
+            work[2 * j + 1] = 0.0;
+        }
+        fossil_data_series_fft_run(p->cpx, work, work + 2 * n);
+        memcpy(spectrum, work, 2 * (n / 2 + 1) * sizeof(double));
+        return;
+    }
+    size_t m = n / 2;
+    double *z = work;
+    memcpy(z, x, n * sizeof(double));
+    fossil_data_series_fft_run(p->cpx, z, work + n);
+    for (size_t k = 0; k <= m; k++) {
+        size_t a = k % m, b = (m - k) % m;
+        double zr = z[2 * a], zi = z[2 * a + 1], cr = z[2 * b], ci = -z[2 * b + 1];
+        double er = 0.5 * (zr + cr), ei = 0.5 * (zi + ci);
+        double or_ = 0.5 * (zi - ci), oi = -0.5 * (zr - cr);   /* (z - c) / 2i */
+        double wr = p->split[2 * k], wi = p->split[2 * k + 1];
+        spectrum[2 * k] = er + wr * or_ - wi * oi;
+        spectrum[2 * k + 1] = ei + wr * oi + wi * or_;
+    }
+}
+
+/* Inverse of fossil_data_series_rfft_run, scaled by 1/n. */
+static void fossil_data_series_irfft_run(const fossil_data_series_rfft_t *p, const double *spectrum,
+                                         double *x, double *work)
+{
+    size_t n = p->n;
+    if (n % 2 != 0) {
+        for (size_t k = 0; k <= n / 2; k++) {
+            work[2 * k] = spectrum[2 * k];
+            work[2 * k + 1] = spectrum[2 * k + 1];
+            if (k > 0) {
+                work[2 * (n - k)] = spectrum[2 * k];
+                work[2 * (n - k) + 1] = -spectrum[2 * k + 1];
+            }
+        }
+        fossil_data_series_fft_inverse(p->cpx, work, work + 2 * n);
+        for (size_t j = 0; j < n; j++) x[j] = work[2 * j] / (double)n;
+        return;
+    }
+    size_t m = n / 2;
+    double *z = work;
+    for (size_t k = 0; k < m; k++) {
+        double xr = spectrum[2 * k], xi = spectrum[2 * k + 1];
+        double cr = spectrum[2 * (m - k)], ci = -spectrum[2 * (m - k) + 1];
+        double er = 0.5 * (xr + cr), ei = 0.5 * (xi + ci);
+        double dr = 0.5 * (xr - cr), di = 0.5 * (xi - ci);
+        double wr = p->split[2 * k], wi = -p->split[2 * k + 1];
+        double or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+        z[2 * k] = er - oi;                                    /* e + i o */
+        z[2 * k + 1] = ei + or_;
+    }
+    fossil_data_series_fft_inverse(p->cpx, z, work + n);
+    for (size_t j = 0; j < n; j++) x[j] = z[j] / (double)m;
+}
+
+/*
+ * Plans are cached by length. A caller holds a reference while it runs;
+ * when every slot is in use a fresh plan is built and dropped after.
+ */
+#if defined(FOSSIL_DATA_NO_THREADS)
+static void fossil_data_series_fft_lock(void) {}
+static void fossil_data_series_fft_unlock(void) {}
+#elif defined(_WIN32)
+static SRWLOCK fossil_data_series_fft_mutex = SRWLOCK_INIT;
+static void fossil_data_series_fft_lock(void)
+{
+    AcquireSRWLockExclusive(&fossil_data_series_fft_mutex);
+}
+static void fossil_data_series_fft_unlock(void)
+{
+    ReleaseSRWLockExclusive(&fossil_data_series_fft_mutex);
+}
+#else
+static pthread_mutex_t fossil_data_series_fft_mutex = PTHREAD_MUTEX_INITIALIZER;
+static void fossil_data_series_fft_lock(void)
+{
+    pthread_mutex_lock(&fossil_data_series_fft_mutex);
+}
+static void fossil_data_series_fft_unlock(void)
+{
+    pthread_mutex_unlock(&fossil_data_series_fft_mutex);
+}
+#endif
+
+static struct {
+    fossil_data_series_rfft_t *plan;
+    size_t refs, used;
+} fossil_data_series_fft_cache[SERIES_FFT_CACHE];
+static size_t fossil_data_series_fft_clock = 0;
+
+static fossil_data_series_rfft_t *fossil_data_series_rfft_acquire(size_t n)
+{
+    fossil_data_series_fft_lock();
+    for (size_t i = 0; i < SERIES_FFT_CACHE; i++) {
+        if (fossil_data_series_fft_cache[i].plan && fossil_data_series_fft_cache[i].plan->n == n) {
+            fossil_data_series_fft_cache[i].refs++;
+            fossil_data_series_fft_cache[i].used = ++fossil_data_series_fft_clock;
+            fossil_data_series_rfft_t *hit = fossil_data_series_fft_cache[i].plan;
+            fossil_data_series_fft_unlock();
+            return hit;
+        }
+    }
+    fossil_data_series_fft_unlock();
+
+    fossil_data_series_rfft_t *plan = fossil_data_series_rfft_create(n);
+    if (!plan) return NULL;
+    fossil_data_series_rfft_t *evict = NULL;
+    size_t slot = SERIES_FFT_CACHE;
+    fossil_data_series_fft_lock();
+    for (size_t i = 0; i < SERIES_FFT_CACHE; i++) {
+        if (fossil_data_series_fft_cache[i].plan && fossil_data_series_fft_cache[i].plan->n == n) {
+            /* Another caller built the same length meanwhile. */
+            evict = plan;
+            plan = fossil_data_series_fft_cache[i].plan;
+            fossil_data_series_fft_cache[i].refs++;
+            fossil_data_series_fft_cache[i].used = ++fossil_data_series_fft_clock;
+            slot = SERIES_FFT_CACHE;
+            break;
+        }
+        /* Prefer an empty slot, then the least recently used idle one. */
+        if (fossil_data_series_fft_cache[i].refs > 0) continue;
+        if (slot == SERIES_FFT_CACHE ||
+            (fossil_data_series_fft_cache[slot].plan &&
+             (!fossil_data_series_fft_cache[i].plan ||
+              fossil_data_series_fft_cache[i].used < fossil_data_series_fft_cache[slot].used)))
+            slot = i;
+    }
+    if (!evict && slot < SERIES_FFT_CACHE) {
+        evict = fossil_data_series_fft_cache[slot].plan;
+        fossil_data_series_fft_cache[slot].plan = plan;
+        fossil_data_series_fft_cache[slot].refs = 1;
+        fossil_data_series_fft_cache[slot].used = ++fossil_data_series_fft_clock;
+    }
+    fossil_data_series_fft_unlock();
+    fossil_data_series_rfft_free(evict);
+    return plan;
+}
+
+static void fossil_data_series_rfft_release(fossil_data_series_rfft_t *plan)
+{
+    fossil_data_series_fft_lock();
+    for (size_t i = 0; i < SERIES_FFT_CACHE; i++) {
+        if (fossil_data_series_fft_cache[i].plan == plan) {
+            fossil_data_series_fft_cache[i].refs--;
+            plan = NULL;
+            break;
+        }
+    }
+    fossil_data_series_fft_unlock();
+    fossil_data_series_rfft_free(plan);   /* uncached */
+}
+
+int fossil_data_series_fft_cache_clear(void)
+{
+    fossil_data_series_rfft_t *idle[SERIES_FFT_CACHE] = {NULL};
+    fossil_data_series_fft_lock();
+    for (size_t i = 0; i < SERIES_FFT_CACHE; i++) {
+        /* Plans in use stay; their last release keeps them cached. */
+        if (fossil_data_series_fft_cache[i].refs > 0) continue;
+        idle[i] = fossil_data_series_fft_cache[i].plan;
+        fossil_data_series_fft_cache[i].plan = NULL;
+        fossil_data_series_fft_cache[i].used = 0;
+    }
+    fossil_data_series_fft_unlock();
+    for (size_t i = 0; i < SERIES_FFT_CACHE; i++) fossil_data_series_rfft_free(idle[i]);
+    return 0;
+}
+
+/* Smallest 2^a 3^b >= n with a >= 1: even, and fast on the radix-4/2/3 stages. */
+static size_t fossil_data_series_fft_size(size_t n)
+{
+    size_t best = 2;
+    while (best < n) best <<= 1;
+    for (size_t p3 = 3; p3 < best; p3 *= 3) {
+        size_t v = 2 * p3;
+        while (v < n) v <<= 1;
+        if (v < best) best = v;
+    }
+    return best;
+}
+
+/* out[0 .. na + nb - 1) = a * b, in double. */
+static int fossil_data_series_convolve_f64(const double *a, size_t na, const double *b, size_t nb,
+                                           double *out)
+{
+    size_t len = na + nb - 1;
+    if (na < SERIES_FFT_DIRECT || nb < SERIES_FFT_DIRECT) {
+        memset(out, 0, len * sizeof(double));
+        for (size_t i = 0; i < na; i++)
+            for (size_t j = 0; j < nb; j++) out[i + j] += a[i] * b[j];
+        return 0;
+    }
+    size_t n = fossil_data_series_fft_size(len), bins = n / 2 + 1;
+    fossil_data_series_rfft_t *plan = fossil_data_series_rfft_acquire(n);
+    if (!plan) return -3;
+    double *buf = malloc((2 * n + 4 * bins + plan->work) * sizeof(double));
+    if (!buf) {
+        fossil_data_series_rfft_release(plan);
+        return -3;
+    }
+    double *pa = buf, *pb = pa + n, *sa = pb + n, *sb = sa + 2 * bins, *work = sb + 2 * bins;
+    memcpy(pa, a, na * sizeof(double));
+    memset(pa + na, 0, (n - na) * sizeof(double));
+    memcpy(pb, b, nb * sizeof(double));
+    memset(pb + nb, 0, (n - nb) * sizeof(double));
+    fossil_data_series_rfft_run(plan, pa, sa, work);
+    fossil_data_series_rfft_run(plan, pb, sb, work);
+    for (size_t k = 0; k < bins; k++) {
+        double ar = sa[2 * k], ai = sa[2 * k + 1], br = sb[2 * k], bi = sb[2 * k + 1];
+        sa[2 * k] = ar * br - ai * bi;
+        sa[2 * k + 1] = ar * bi + ai * br;
+    }
+    fossil_data_series_irfft_run(plan, sa, pa, work);
+    memcpy(out, pa, len * sizeof(double));
+    free(buf);
+    fossil_data_series_rfft_release(plan);
+    return 0;
+}
+
+/* Convolution in the input type; reverse_b turns it into a cross-correlation. */
+static int fossil_data_series_convolve_typed(const void *a, size_t na, const void *b, size_t nb,
+                                             void *output, const char *type_id, int reverse_b)
+{
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!a || !b || !output || na == 0 || nb == 0 || t == SERIES_INVALID) return -1;
+    size_t len = na + nb - 1;
+    double *da = malloc((na + nb + len) * sizeof(double));
+    if (!da) return -3;
+    double *db = da + na, *out = db + nb;
+    fossil_data_series_load_f64(a, 0, na, t, da);
+    fossil_data_series_load_f64(b, 0, nb, t, db);
+    for (size_t i = 0; reverse_b && i < nb / 2; i++) {
+        double swap = db[i];
+        db[i] = db[nb - 1 - i];
+        db[nb - 1 - i] = swap;
+    }
+    int rc = fossil_data_series_convolve_f64(da, na, db, nb, out);
+    if (rc == 0) {
+        /* Integer inputs have integer results; undo the transform's rounding noise. */
+        if (!fossil_data_series_is_float(t))
+            for (size_t i = 0; i < len; i++) out[i] = floor(out[i] + 0.5);
+        fossil_data_series_store_f64(output, 0, len, t, out);
+    }
+    free(da);
+    return rc;
+}
+
+int fossil_data_series_rfft(
+    const void* input,
+    size_t count,
+    double* spectrum,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !spectrum || count == 0 || t == SERIES_INVALID) return -1;
+    fossil_data_series_rfft_t *plan = fossil_data_series_rfft_acquire(count);
+    if (!plan) return -3;
+    double *buf = malloc((count + plan->work) * sizeof(double));
+    if (!buf) {
+        fossil_data_series_rfft_release(plan);
+        return -3;
+    }
+    fossil_data_series_load_f64(input, 0, count, t, buf);
+    fossil_data_series_rfft_run(plan, buf, spectrum, buf + count);
+    free(buf);
+    fossil_data_series_rfft_release(plan);
+    return 0;
+}
+
+int fossil_data_series_irfft(
+    const double* spectrum,
+    size_t count,
+    void* output,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!spectrum || !output || count == 0 || t == SERIES_INVALID) return -1;
+    fossil_data_series_rfft_t *plan = fossil_data_series_rfft_acquire(count);
+    if (!plan) return -3;
+    double *buf = malloc((count + plan->work) * sizeof(double));
+    if (!buf) {
+        fossil_data_series_rfft_release(plan);
+        return -3;
+    }
+    fossil_data_series_irfft_run(plan, spectrum, buf, buf + count);
+    if (!fossil_data_series_is_float(t))
+        for (size_t i = 0; i < count; i++) buf[i] = floor(buf[i] + 0.5);
+    fossil_data_series_store_f64(output, 0, count, t, buf);
+    free(buf);
+    fossil_data_series_rfft_release(plan);
+    return 0;
+}
+
+int fossil_data_series_convolve(
+    const void* a,
+    size_t count_a,
+    const void* b,
+    size_t count_b,
+    void* output,
+    const char* type_id
+){
+    return fossil_data_series_convolve_typed(a, count_a, b, count_b, output, type_id, 0);
+}
+
+int fossil_data_series_correlate(
+    const void* a,
+    size_t count_a,
+    const void* b,
+    size_t count_b,
+    void* output,
+    const char* type_id
+){
+    return fossil_data_series_convolve_typed(a, count_a, b, count_b, output, type_id, 1);
+}
+
+int fossil_data_series_autocorr(
+    const void* input,
+    size_t count,
+    size_t max_lag,
+    double* output,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || max_lag >= count || t == SERIES_INVALID) return -1;
+    double *x = malloc(count * sizeof(double));
+    if (!x) return -3;
+    fossil_data_series_load_f64(input, 0, count, t, x);
+    double mean = 0.0;
+    for (size_t i = 0; i < count; i++) mean += x[i];
+    mean /= (double)count;
+    for (size_t i = 0; i < count; i++) x[i] -= mean;
+
+    if (max_lag < SERIES_FFT_DIRECT) {
+        for (size_t k = 0; k <= max_lag; k++) {
+            double acc = 0.0;
+            for (size_t i = 0; i + k < count; i++) acc += x[i] * x[i + k];
+            output[k] = acc;
+        }
+    } else {
+        /* Padding to count + max_lag keeps the circular products off the lags we return. */
+        size_t n = fossil_data_series_fft_size(count + max_lag), bins = n / 2 + 1;
+        fossil_data_series_rfft_t *plan = fossil_data_series_rfft_acquire(n);
+        double *buf = plan ? malloc((n + 2 * bins + plan->work) * sizeof(double)) : NULL;
+        if (!buf) {
+            if (plan) fossil_data_series_rfft_release(plan);
+            free(x);
+            return -3;
+        }
+        double *pad = buf, *spec = pad + n, *work = spec + 2 * bins;
+        memcpy(pad, x, count * sizeof(double));
+        memset(pad + count, 0, (n - count) * sizeof(double));
+        fossil_data_series_rfft_run(plan, pad, spec, work);
+        for (size_t k = 0; k < bins; k++) {
+            double re = spec[2 * k], im = spec[2 * k + 1];
+            spec[2 * k] = re * re + im * im;
+            spec[2 * k + 1] = 0.0;
+        }
+        fossil_data_series_irfft_run(plan, spec, pad, work);
+        memcpy(output, pad, (max_lag + 1) * sizeof(double));
+        free(buf);
+        fossil_data_series_rfft_release(plan);
+    }
+    free(x);
+
+    double c0 = output[0];
+    for (size_t k = 0; k <= max_lag; k++) output[k] = c0 > 0.0 ? output[k] / c0 : NAN;
+    return 0;
+}
+
+/* ---------------------------------------------------------
+ * Lags and differences
+ * --------------------------------------------------------- */
+
+static size_t fossil_data_series_width(fossil_data_series_dtype_t t)
+{
+    switch (t) {
+    case SERIES_I8:  case SERIES_U8: case SERIES_BOOL: return 1;
+    case SERIES_I16: case SERIES_U16: return 2;
+    case SERIES_I32: case SERIES_U32: case SERIES_F32: return 4;
+    case SERIES_SIZE: return sizeof(size_t);
+    default: return 8;
+    }
+}
+
+/* n missing values at dst[offset..]: NaN for floating types, 0 otherwise. */
+static void fossil_data_series_fill_missing(void *dst, size_t offset, size_t n,
+                                            fossil_data_series_dtype_t t)
+{
+    if (t == SERIES_F32) {
+        float *p = (float*)dst + offset;
+        for (size_t i = 0; i < n; i++) p[i] = NAN;
+    } else if (t == SERIES_F64) {
+        double *p = (double*)dst + offset;
+        for (size_t i = 0; i < n; i++) p[i] = NAN;
+    } else {
+        size_t w = fossil_data_series_width(t);
+        memset((char*)dst + offset * w, 0, n * w);
+    }
+}
+
+int fossil_data_series_shift(
+    const void* input,
+    void* output,
+    size_t count,
+    ptrdiff_t periods,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || t == SERIES_INVALID) return -1;
+    size_t w = fossil_data_series_width(t);
+    /* |periods| without overflowing at PTRDIFF_MIN. */
+    size_t k = periods >= 0 ? (size_t)periods : (size_t)(-(periods + 1)) + 1;
+    if (k > count) k = count;
+    if (periods >= 0) {
+        memmove((char*)output + k * w, input, (count - k) * w);
+        fossil_data_series_fill_missing(output, 0, k, t);
+    } else {
+        memmove(output, (const char*)input + k * w, (count - k) * w);
+        fossil_data_series_fill_missing(output, count - k, k, t);
+    }
+    return 0;
+}
+
+/*
+ * Repeated first differences over one tile. carry[L] holds the last
+ * level-L value of the previous tile; each level is a backward pass so
+ * it runs in place. Values before position L of level L are never used.
+ */
+#define SERIES_DIFF_TILE(ctype, v, carry) \
+    for (size_t L = 0; L < order; L++) { \
+        size_t start = base > L ? 0 : L + 1 - base; \
+        ctype last = (v)[m - 1]; \
+        for (size_t i = m - 1; i > 0 && i >= start; i--) (v)[i] -= (v)[i - 1]; \
+        if (start == 0) (v)[0] -= (carry)[L]; \
+        (carry)[L] = last; \
+    }
+
+int fossil_data_series_diff(
+    const void* input,
+    void* output,
+    size_t count,
+    size_t order,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || t == SERIES_INVALID) return -1;
+    if (order >= count) {
+        fossil_data_series_fill_missing(output, 0, count, t);
+        return 0;
+    }
+    int is_float = fossil_data_series_is_float(t);
+    void *carry = malloc((order > 0 ? order : 1) * (is_float ? sizeof(double) : sizeof(uint64_t)));
+    if (!carry) return -3;
+
+    /* Integers difference in wrapping 64-bit lanes, exact like the type's own arithmetic. */
+    for (size_t base = 0; base < count; base += SERIES_SCAN_TILE) {
+        size_t m = count - base < SERIES_SCAN_TILE ? count - base : SERIES_SCAN_TILE;
+        if (is_float) {
+            double v[SERIES_SCAN_TILE], *carry_f = carry;
+            fossil_data_series_load_f64(input, base, m, t, v);
+            SERIES_DIFF_TILE(double, v, carry_f)
+            fossil_data_series_store_f64(output, base, m, t, v);
+        } else {
+            uint64_t v[SERIES_SCAN_TILE], *carry_u = carry;
+            fossil_data_series_load_u64(input, base, m, t, v);
+            SERIES_DIFF_TILE(uint64_t, v, carry_u)
+            fossil_data_series_store_u64(output, base, m, t, v);
+        }
+        if (base < order) {
+            size_t lead = order < base + m ? order : base + m;
+            fossil_data_series_fill_missing(output, base, lead - base, t);
+        }
+    }
+    free(carry);
+    return 0;
+}
+
+int fossil_data_series_pct_change(
+    const void* input,
+    double* output,
+    size_t count,
+    size_t periods,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || periods == 0 || t == SERIES_INVALID) return -1;
+    if ((const void*)output != input || t != SERIES_F64)
+        fossil_data_series_load_f64(input, 0, count, t, output);
+    /* Backwards, so output[i - periods] still holds the input value. */
+    for (size_t i = count; i-- > periods;) output[i] = output[i] / output[i - periods] - 1.0;
+    for (size_t i = 0; i < periods && i < count; i++) output[i] = NAN;
+    return 0;
+}
+
+/*
+ * Row i of the lag matrix is x[i - lags[0]], x[i - lags[1]], ...; every
+ * lag reads a window just behind the row, so one forward pass writes the
+ * block row by row with the sources still in cache. Rows spread across
+ * the pool; only the first max_lag rows check for missing values.
+ */
+typedef struct {
+    const void *in;
+    void *out;
+    const size_t *lags;
+    size_t n_lags, max_lag;
+    fossil_data_series_dtype_t t;
+} fossil_data_series_lag_job_t;
+
+#define SERIES_LAG_ROWS(ctype, missing) \
+    { const ctype *x = (const ctype*)job->in; ctype *out = (ctype*)job->out; \
+      size_t i = begin; \
+      for (; i < end && i < job->max_lag; i++) \
+          for (size_t j = 0; j < k; j++) \
+              out[i * k + j] = lags[j] <= i ? x[i - lags[j]] : (missing); \
+      for (; i < end; i++) { \
+          ctype *row = out + i * k; \
+          for (size_t j = 0; j < k; j++) row[j] = x[i - lags[j]]; \
+      } } break
+
+static void fossil_data_series_lag_rows(void *ctx, size_t chunk, size_t begin, size_t end)
+{
+    fossil_data_series_lag_job_t *job = ctx;
+    const size_t *lags = job->lags;
+    size_t k = job->n_lags;
+    (void)chunk;
+    switch (job->t) {
+    case SERIES_I8:  case SERIES_U8: case SERIES_BOOL: SERIES_LAG_ROWS(uint8_t, 0);
+    case SERIES_I16: case SERIES_U16: SERIES_LAG_ROWS(uint16_t, 0);
+    case SERIES_I32: case SERIES_U32: SERIES_LAG_ROWS(uint32_t, 0);
+    case SERIES_I64: case SERIES_U64: SERIES_LAG_ROWS(uint64_t, 0);
+    case SERIES_SIZE: SERIES_LAG_ROWS(size_t, 0);
+    case SERIES_F32:  SERIES_LAG_ROWS(float, NAN);
+    case SERIES_F64:  SERIES_LAG_ROWS(double, NAN);
+    default: break;
+    }
+}
+
+int fossil_data_series_lag_matrix(
+    const void* input,
+    size_t count,
+    const size_t* lags,
+    size_t n_lags,
+    void* output,
+    const char* type_id
+){
+    fossil_data_series_dtype_t t = fossil_data_series_dtype(type_id);
+    if (!input || !output || count == 0 || n_lags == 0 || t == SERIES_INVALID) return -1;
+    size_t *own = NULL;
+    if (!lags) {
+        own = malloc(n_lags * sizeof(size_t));
+        if (!own) return -3;
+        for (size_t j = 0; j < n_lags; j++) own[j] = j + 1;
+        lags = own;
+    }
+    size_t max_lag = 0;
+    for (size_t j = 0; j < n_lags; j++)
+        if (lags[j] > max_lag) max_lag = lags[j];
+    fossil_data_series_lag_job_t job = { input, output, lags, n_lags, max_lag, t };
+    size_t grain = n_lags < SERIES_SCAN_GRAIN ? SERIES_SCAN_GRAIN / n_lags : 1;
+    fossil_data_parallel_for(count, grain, fossil_data_series_lag_rows, &job);
+    free(own);
     return 0;
 }
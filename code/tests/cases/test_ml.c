@@ -160,6 +160,866 @@ FOSSIL_TEST(c_test_ml_invalid_args) {
     fossil_data_ml_free_model(NULL);
 }
 
+FOSSIL_TEST(c_test_ml_linear_regression_thread_invariant) {
+    // y = 1*x0 + 2*x1 + 3*x2 over enough rows to split into several chunks
+    enum { ROWS = 3000, COLS = 3 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i * COLS + 0] = (double)(i % 7) / 7.0;
+        X[i * COLS + 1] = (double)(i % 11) / 11.0;
+        X[i * COLS + 2] = (double)(i % 13) / 13.0;
+        y[i] = X[i * COLS] + 2.0 * X[i * COLS + 1] + 3.0 * X[i * COLS + 2];
+    }
+
+    double pred[2] = {0};
+    for (int t = 0; t < 2; t++) {
+        void* model = NULL;
+        fossil_data_parallel_set_threads(t == 0 ? 1 : 4);
+        int rc = fossil_data_ml_train(X, y, ROWS, COLS, "f64", "linear_regression", &model);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        rc = fossil_data_ml_predict(X + 3, 1, COLS, &pred[t], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil_data_ml_free_model(model);
+    }
+    fossil_data_parallel_set_threads(0);
+
+    // Chunk-ordered reduction: same weights for any thread count
+    ASSUME_ITS_TRUE(pred[0] == pred[1]);
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_options) {
+    // Two well separated groups, k-means++ seeding with k = 2
+    double X[8] = {0.0, 0.2, 0.1, 0.3, 20.0, 20.2, 20.1, 20.3};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 2;
+    opts.max_iter = 50;
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, NULL, 8, 1, "f64", "kmeans", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_CNULL(model);
+
+    int32_t labels[8] = {0};
+    rc = fossil_data_ml_predict(X, 8, 1, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (int i = 1; i < 4; i++) {
+        ASSUME_ITS_EQUAL_I32(labels[0], labels[i]);
+        ASSUME_ITS_EQUAL_I32(labels[4], labels[4 + i]);
+    }
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[4]);
+
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_invalid_options) {
+    double X[4] = {1.0, 2.0, 3.0, 4.0};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    void* model = NULL;
+
+    opts.k = 0;
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_ex(X, NULL, 4, 1, "f64", "kmeans", &opts, &model), 0);
+    opts.k = 5; // more clusters than rows
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_ex(X, NULL, 4, 1, "f64", "kmeans", &opts, &model), 0);
+    opts.k = 2;
+    opts.init = "badinit";
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_ex(X, NULL, 4, 1, "f64", "kmeans", &opts, &model), 0);
+    ASSUME_ITS_CNULL(model);
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_algorithms_agree) {
+    // Lloyd, Hamerly and Elkan must converge to the same clustering
+    enum { ROWS = 200, COLS = 2 };
+    static double X[ROWS * COLS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i * COLS + 0] = (double)(i % 5) * 10.0 + (double)(i % 7) * 0.1;
+        X[i * COLS + 1] = (double)(i % 3) * 10.0 + (double)(i % 11) * 0.1;
+    }
+    const char* algorithms[3] = {"lloyd", "hamerly", "elkan"};
+    static int32_t labels[3][ROWS];
+
+    for (int a = 0; a < 3; a++) {
+        fossil_data_ml_options_t opts;
+        fossil_data_ml_options_init(&opts);
+        opts.k = 6;
+        opts.algorithm = algorithms[a];
+        void* model = NULL;
+        int rc = fossil_data_ml_train_ex(X, NULL, ROWS, COLS, "f64", "kmeans", &opts, &model);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        rc = fossil_data_ml_predict(X, ROWS, COLS, labels[a], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil_data_ml_free_model(model);
+    }
+    for (size_t i = 0; i < ROWS; i++) {
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[1][i]);
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[2][i]);
+    }
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_partial_fit) {
+    // Stream two groups through the model in chunks of 4 rows
+    double X[16] = {0.0, 20.0, 0.1, 20.1, 0.2, 20.2, 0.3, 20.3,
+                    0.4, 20.4, 0.5, 20.5, 0.6, 20.6, 0.7, 20.7};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 2;
+    void* model = NULL;
+    for (size_t chunk = 0; chunk < 16; chunk += 4) {
+        int rc = fossil_data_ml_partial_fit(X + chunk, 4, 1, "f64", "kmeans", &opts, &model);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        ASSUME_NOT_CNULL(model);
+    }
+
+    double X_test[2] = {0.25, 19.0};
+    int32_t labels[2] = {0};
+    int rc = fossil_data_ml_predict(X_test, 2, 1, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[1]);
+
+    // Column count must match the existing model
+    rc = fossil_data_ml_partial_fit(X, 4, 2, "f64", "kmeans", &opts, &model);
+    ASSUME_NOT_EQUAL_I32(rc, 0);
+
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_minibatch) {
+    float X[12] = {1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 9.0f, 9.1f, 9.2f, 9.3f, 9.4f, 9.5f};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 2;
+    opts.batch_size = 4;
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, NULL, 12, 1, "f32", "kmeans", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    float X_test[2] = {1.25f, 9.25f};
+    int32_t labels[2] = {0};
+    rc = fossil_data_ml_predict(X_test, 2, 1, labels, model, "f32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[1]);
+    fossil_data_ml_free_model(model);
+
+    // A batch larger than the data is capped at the row count
+    opts.batch_size = (size_t)-1 / 2;
+    model = NULL;
+    rc = fossil_data_ml_train_ex(X, NULL, 12, 1, "f32", "kmeans", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(X_test, 2, 1, labels, model, "f32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[1]);
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_kmeans_thread_invariant) {
+    // Enough rows for several accumulator chunks
+    enum { ROWS = 5000, COLS = 2 };
+    static double X[ROWS * COLS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i * COLS + 0] = (double)(i % 4) * 5.0 + (double)(i % 9) * 0.1;
+        X[i * COLS + 1] = (double)(i % 6) * 5.0 + (double)(i % 13) * 0.1;
+    }
+    static int32_t labels[2][ROWS];
+    for (int t = 0; t < 2; t++) {
+        fossil_data_ml_options_t opts;
+        fossil_data_ml_options_init(&opts);
+        opts.k = 8;
+        void* model = NULL;
+        fossil_data_parallel_set_threads(t == 0 ? 1 : 4);
+        int rc = fossil_data_ml_train_ex(X, NULL, ROWS, COLS, "f64", "kmeans", &opts, &model);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        rc = fossil_data_ml_predict(X, ROWS, COLS, labels[t], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil_data_ml_free_model(model);
+    }
+    fossil_data_parallel_set_threads(0);
+    for (size_t i = 0; i < ROWS; i++)
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[1][i]);
+}
+
+FOSSIL_TEST(c_test_ml_predict_batch_tiles) {
+    // Rows spanning several prediction tiles, scored in i16
+    enum { ROWS = 1000 };
+    static int16_t X[ROWS];
+    static int16_t y[ROWS];
+    static int16_t y_pred[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i] = (int16_t)(i % 10);
+        y[i] = (int16_t)(3 * X[i]);
+    }
+    void* model = NULL;
+    int rc = fossil_data_ml_train(X, y, ROWS, 1, "i16", "linear_regression", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    rc = fossil_data_ml_predict(X, ROWS, 1, y_pred, model, "i16");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t i = 0; i < ROWS; i += 97)
+        ASSUME_ITS_TRUE(y_pred[i] == y[i] || y_pred[i] == y[i] - 1);
+
+    // Column count must match the model
+    rc = fossil_data_ml_predict(X, ROWS / 2, 2, y_pred, model, "i16");
+    ASSUME_NOT_EQUAL_I32(rc, 0);
+
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_predictor_score_one) {
+    // Single-row scoring must match batch predict, and outlive the model
+    double X[] = {1, 1, 1.2, 0.8, 8, 8, 8.2, 7.9, 15, 1, 14.8, 1.1};
+    int32_t labels[6];
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 3;
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, NULL, 6, 2, "f64", "kmeans", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(X, 6, 2, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    void* pred = NULL;
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_predictor_create(model, 3, "f64", &pred), 0);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_predictor_create(model, 2, "bogus", &pred), 0);
+    rc = fossil_data_ml_predictor_create(model, 2, "f64", &pred);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_free_model(model);
+
+    for (size_t i = 0; i < 6; i++) {
+        int32_t label = -1;
+        rc = fossil_data_ml_predictor_score_one(pred, X + i * 2, &label);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        ASSUME_ITS_EQUAL_I32(label, labels[i]);
+    }
+    fossil_data_ml_predictor_free(pred);
+
+    // Regression predictor bound to i32 rows
+    int32_t Xi[] = {1, 2, 3, 4};
+    int32_t yi[] = {2, 4, 6, 8};
+    rc = fossil_data_ml_train(Xi, yi, 4, 1, "i32", "linear_regression", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predictor_create(model, 1, "i32", &pred);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    int32_t row = 5, out = 0;
+    rc = fossil_data_ml_predictor_score_one(pred, &row, &out);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_ITS_TRUE(out == 10 || out == 9);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_predictor_score_one(pred, NULL, &out), 0);
+    fossil_data_ml_predictor_free(pred);
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_save_load_model) {
+    // Round-trip a kmeans and a regression model through both load modes
+    const char* path = "fossil_data_ml_test.model";
+    double X[] = {1, 1, 1.2, 0.8, 8, 8, 8.2, 7.9, 15, 1, 14.8, 1.1};
+    int32_t labels[6], loaded_labels[6];
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 3;
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, NULL, 6, 2, "f64", "kmeans", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(X, 6, 2, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_save_model(model, path);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_free_model(model);
+
+    const char* modes[] = {"copy", "mmap"};
+    for (size_t m = 0; m < 2; m++) {
+        void* loaded = NULL;
+        rc = fossil_data_ml_load_model(path, modes[m], &loaded);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        rc = fossil_data_ml_predict(X, 6, 2, loaded_labels, loaded, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        for (size_t i = 0; i < 6; i++)
+            ASSUME_ITS_EQUAL_I32(loaded_labels[i], labels[i]);
+        // Loaded models keep training without touching the file
+        rc = fossil_data_ml_partial_fit(X, 6, 2, "f64", "kmeans", &opts, &loaded);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil_data_ml_free_model(loaded);
+    }
+
+    // Regression weights survive the round trip exactly
+    double Xr[] = {1, 2, 3, 4};
+    double yr[] = {2, 4, 6, 8};
+    double before[1], after[1], probe[] = {5};
+    rc = fossil_data_ml_train(Xr, yr, 4, 1, "f64", "linear_regression", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_predict(probe, 1, 1, before, model, "f64");
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_save_model(model, path), 0);
+    fossil_data_ml_free_model(model);
+    rc = fossil_data_ml_load_model(path, "mmap", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_predict(probe, 1, 1, after, model, "f64");
+    ASSUME_ITS_TRUE(before[0] == after[0]);
+    fossil_data_ml_free_model(model);
+
+    // Bad mode and missing files are rejected
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_load_model(path, "bogus", &model), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_load_model("fossil_data_ml_missing.model", NULL, &model), -5);
+    ASSUME_ITS_CNULL(model);
+    remove(path);
+}
+
+FOSSIL_TEST(c_test_ml_quantize) {
+    // Quantized weights score integer and f32 features close to f64 weights
+    enum { ROWS = 200, COLS = 40 };
+    static int8_t Xi8[ROWS * COLS];
+    static uint8_t Xu8[ROWS * COLS];
+    static float Xf[ROWS * COLS];
+    static double Xd[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS * COLS; i++) {
+        Xi8[i] = (int8_t)((int)(i * 7 % 11) - 5);
+        Xu8[i] = (uint8_t)(Xi8[i] + 5);
+        Xf[i] = (float)Xi8[i];
+        Xd[i] = (double)Xi8[i];
+    }
+    for (size_t r = 0; r < ROWS; r++) {
+        y[r] = 0;
+        for (size_t j = 0; j < COLS; j++)
+            y[r] += Xd[r * COLS + j] * (double)((int)(j % 5) - 2) * 0.25;
+    }
+    void* model = NULL;
+    int rc = fossil_data_ml_train(Xd, y, ROWS, COLS, "f64", "linear_regression", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    static double ref[ROWS];
+    rc = fossil_data_ml_predict(Xd, ROWS, COLS, ref, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    // f32 weights against f32 features
+    static float yf[ROWS];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_quantize(model, "f32"), 0);
+    rc = fossil_data_ml_predict(Xf, ROWS, COLS, yf, model, "f32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t r = 0; r < ROWS; r++)
+        ASSUME_ITS_EQUAL_F64((double)yf[r], ref[r], 1e-3);
+
+    // i8 weights against i8 and u8 features; f64 features use dequantized weights
+    static int8_t yi8[ROWS];
+    static double yd[ROWS];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_quantize(model, "i8"), 0);
+    rc = fossil_data_ml_predict(Xi8, ROWS, COLS, yi8, model, "i8");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(Xd, ROWS, COLS, yd, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t r = 0; r < ROWS; r++) {
+        ASSUME_ITS_EQUAL_F64(yd[r], ref[r], 0.5);
+        ASSUME_ITS_EQUAL_F64((double)yi8[r], yd[r], 1.0);
+    }
+    static double yu[ROWS];
+    static double Xud[ROWS * COLS];
+    static uint8_t yu8[ROWS];
+    for (size_t i = 0; i < ROWS * COLS; i++) Xud[i] = Xu8[i];
+    rc = fossil_data_ml_predict(Xud, ROWS, COLS, yu, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(Xu8, ROWS, COLS, yu8, model, "u8");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t r = 0; r < ROWS; r++)
+        if (yu[r] >= 0 && yu[r] < 255) ASSUME_ITS_EQUAL_F64((double)yu8[r], yu[r], 1.0);
+
+    // i8 weights survive save/load
+    const char* path = "fossil_data_ml_quantized.model";
+    static double yl[ROWS];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_save_model(model, path), 0);
+    void* loaded = NULL;
+    rc = fossil_data_ml_load_model(path, "mmap", &loaded);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_predict(Xd, ROWS, COLS, yl, loaded, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t r = 0; r < ROWS; r++)
+        ASSUME_ITS_TRUE(yl[r] == yd[r]);
+    fossil_data_ml_free_model(loaded);
+    remove(path);
+
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_quantize(model, "i4"), 0);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_quantize(NULL, "i8"), 0);
+    fossil_data_ml_free_model(model);
+
+    // kmeans centers are not quantized
+    double Xk[] = {1, 2, 10, 11};
+    rc = fossil_data_ml_train(Xk, NULL, 4, 1, "f64", "kmeans", &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_quantize(model, "i8"), 0);
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_train_multi) {
+    // Two target columns trained together match separate training runs
+    enum { ROWS = 300, COLS = 3, YCOLS = 2 };
+    static double X[ROWS * COLS];
+    static double Y[ROWS * YCOLS];
+    static double y0[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < COLS; j++)
+            X[i * COLS + j] = (double)((i * (j + 3)) % 17) / 8.0;
+        Y[i * YCOLS] = 2 * X[i * COLS] - X[i * COLS + 2];
+        Y[i * YCOLS + 1] = X[i * COLS + 1] + 0.5 * X[i * COLS + 2];
+        y0[i] = Y[i * YCOLS];
+    }
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.learning_rate = 0.05;
+    opts.max_iter = 200;
+
+    void* models[YCOLS];
+    int rc = fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, NULL, NULL, YCOLS,
+                                        "f64", "linear_regression", &opts, models);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    void* single = NULL;
+    rc = fossil_data_ml_train_ex(X, y0, ROWS, COLS, "f64", "linear_regression", &opts, &single);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    double a[4], b[4];
+    fossil_data_ml_predict(X, 4, COLS, a, models[0], "f64");
+    fossil_data_ml_predict(X, 4, COLS, b, single, "f64");
+    for (size_t i = 0; i < 4; i++)
+        ASSUME_ITS_EQUAL_F64(a[i], b[i], 1e-12);
+    fossil_data_ml_predict(X, 4, COLS, a, models[1], "f64");
+    for (size_t i = 0; i < 4; i++)
+        ASSUME_ITS_EQUAL_F64(a[i], Y[i * YCOLS + 1], 0.3);
+    fossil_data_ml_free_model(single);
+    for (size_t m = 0; m < YCOLS; m++)
+        fossil_data_ml_free_model(models[m]);
+
+    // One column with a sweep of L2 strengths: stronger penalty, smaller output
+    size_t idx[3] = {0, 0, 0};
+    double l2[3] = {0.0, 0.5, 5.0};
+    void* sweep[3];
+    rc = fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, idx, l2, 3,
+                                    "f64", "linear_regression", &opts, sweep);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    double probe[COLS] = {1.0, 1.0, 0.0};
+    double out[3];
+    for (size_t m = 0; m < 3; m++) {
+        fossil_data_ml_predict(probe, 1, COLS, &out[m], sweep[m], "f64");
+        fossil_data_ml_free_model(sweep[m]);
+    }
+    ASSUME_ITS_TRUE(out[0] > out[1] && out[1] > out[2]);
+
+    // Invalid target columns, penalties and counts are rejected without handles
+    size_t bad_idx[1] = {YCOLS};
+    double bad_l2[1] = {-1.0};
+    void* three[3] = {NULL, NULL, NULL};
+    models[0] = NULL;
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, bad_idx, NULL, 1,
+                                                    "f64", "linear_regression", &opts, models), 0);
+    ASSUME_ITS_CNULL(models[0]);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, NULL, bad_l2, 1,
+                                                    "f64", "linear_regression", &opts, models), 0);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, NULL, NULL, 3,
+                                                    "f64", "linear_regression", &opts, three), 0);
+    ASSUME_ITS_CNULL(three[2]);
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_multi(X, Y, ROWS, COLS, YCOLS, NULL, NULL, 1,
+                                                    "f64", "kmeans", &opts, models), 0);
+}
+
+FOSSIL_TEST(c_test_ml_sparse_regression) {
+    // Sparse training matches dense training on the same matrix
+    enum { ROWS = 200, COLS = 6 };
+    static double X[ROWS * COLS];
+    static double vals[ROWS * COLS];
+    static size_t indices[ROWS * COLS];
+    static size_t indptr[ROWS + 1];
+    static double y[ROWS];
+    size_t nnz = 0;
+    for (size_t i = 0; i < ROWS; i++) {
+        indptr[i] = nnz;
+        for (size_t j = 0; j < COLS; j++) {
+            double v = ((i + j) % 3 == 0) ? (double)((i * (j + 1)) % 7) / 4.0 : 0.0;
+            X[i * COLS + j] = v;
+            if (v != 0.0) { indices[nnz] = j; vals[nnz++] = v; }
+        }
+        y[i] = 1.5 * X[i * COLS] - X[i * COLS + 3] + 0.5 * X[i * COLS + 5];
+    }
+    indptr[ROWS] = nnz;
+    fossil_data_ml_sparse_t S = { "csr", ROWS, COLS, indptr, indices, vals };
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.learning_rate = 0.05;
+    opts.max_iter = 300;
+
+    void* sparse = NULL;
+    void* dense = NULL;
+    int rc = fossil_data_ml_train_sparse(&S, y, "f64", "linear_regression", &opts, &sparse);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "linear_regression", &opts, &dense);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    static double a[ROWS], b[ROWS];
+    rc = fossil_data_ml_predict_sparse(&S, a, sparse, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_predict(X, ROWS, COLS, b, dense, "f64");
+    for (size_t i = 0; i < ROWS; i++)
+        ASSUME_ITS_EQUAL_F64(a[i], b[i], 1e-9);
+
+    // Dense prediction works on a sparse-trained model too
+    fossil_data_ml_predict(X, ROWS, COLS, b, sparse, "f64");
+    for (size_t i = 0; i < ROWS; i++)
+        ASSUME_ITS_EQUAL_F64(a[i], b[i], 1e-9);
+    fossil_data_ml_free_model(sparse);
+    fossil_data_ml_free_model(dense);
+}
+
+FOSSIL_TEST(c_test_ml_sparse_csc_kmeans) {
+    // Two blobs in disjoint columns; CSC and CSR input give the same clusters
+    double csr_vals[] = {1.0, 1.1, 0.9, 1.0, 5.0, 5.2, 4.9, 5.1};
+    size_t csr_idx[] = {0, 0, 1, 1, 2, 2, 3, 3};
+    size_t csr_ptr[] = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    double csc_vals[] = {1.0, 1.1, 0.9, 1.0, 5.0, 5.2, 4.9, 5.1};
+    size_t csc_idx[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    size_t csc_ptr[] = {0, 2, 4, 6, 8};
+    fossil_data_ml_sparse_t R = { "csr", 8, 4, csr_ptr, csr_idx, csr_vals };
+    fossil_data_ml_sparse_t C = { "csc", 8, 4, csc_ptr, csc_idx, csc_vals };
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.k = 2;
+    opts.init = "first";
+
+    void* mr = NULL;
+    void* mc = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&R, NULL, "f64", "kmeans", &opts, &mr), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&C, NULL, "f64", "kmeans", &opts, &mc), 0);
+    int lr[8], lc[8];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_predict_sparse(&R, lr, mr, "f64"), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_predict_sparse(&C, lc, mc, "f64"), 0);
+    for (size_t i = 0; i < 8; i++)
+        ASSUME_ITS_EQUAL_I32(lr[i], lc[i]);
+    ASSUME_ITS_EQUAL_I32(lr[0], lr[3]);
+    ASSUME_ITS_EQUAL_I32(lr[4], lr[7]);
+    ASSUME_NOT_EQUAL_I32(lr[0], lr[4]);
+    fossil_data_ml_free_model(mr);
+    fossil_data_ml_free_model(mc);
+}
+
+FOSSIL_TEST(c_test_ml_sparse_invalid) {
+    // Malformed sparse input is rejected before any model is built
+    double vals[] = {1.0, 2.0};
+    size_t idx[] = {0, 5};
+    size_t ptr[] = {0, 1, 2};
+    double y[] = {1.0, 2.0};
+    void* model = NULL;
+    fossil_data_ml_sparse_t S = { "csr", 2, 3, ptr, idx, vals };
+    ASSUME_NOT_EQUAL_I32(fossil_data_ml_train_sparse(&S, y, "f64", "linear_regression", NULL, &model), 0);
+    ASSUME_ITS_CNULL(model);
+    idx[1] = 1;
+    S.layout = "coo";
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&S, y, "f64", "linear_regression", NULL, &model), -1);
+    S.layout = "csr";
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&S, y, "nope", "linear_regression", NULL, &model), -2);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&S, y, "f64", "svm", NULL, &model), -4);
+    ptr[1] = 3;
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_sparse(&S, y, "f64", "linear_regression", NULL, &model), -1);
+}
+
+FOSSIL_TEST(c_test_ml_lasso_sparsity) {
+    // y depends on two of five features; lasso zeroes the other three
+    enum { ROWS = 400, COLS = 5 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < COLS; j++)
+            X[i * COLS + j] = (double)((i * (2 * j + 3) + j) % 11) / 5.0 - 1.0;
+        y[i] = 2.0 * X[i * COLS + 1] - 1.5 * X[i * COLS + 3];
+    }
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.l1 = 0.05;
+    opts.tol = 1e-8;
+
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "lasso", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    double probe[COLS * 3] = {
+        1, 0, 0, 0, 0,
+        0, 1, 0, 0, 0,
+        0, 0, 0, 1, 0,
+    };
+    double w[3];
+    fossil_data_ml_predict(probe, 3, COLS, w, model, "f64");
+    ASSUME_ITS_EQUAL_F64(w[0], 0.0, 1e-12);
+    ASSUME_ITS_TRUE(w[1] > 1.5 && w[1] < 2.0);
+    ASSUME_ITS_TRUE(w[2] < -1.0 && w[2] > -1.5);
+    fossil_data_ml_free_model(model);
+
+    // Without a penalty coordinate descent recovers the exact weights
+    opts.l1 = 0.0;
+    rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "elastic_net", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    fossil_data_ml_predict(probe, 3, COLS, w, model, "f64");
+    ASSUME_ITS_EQUAL_F64(w[1], 2.0, 1e-6);
+    ASSUME_ITS_EQUAL_F64(w[2], -1.5, 1e-6);
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_train_path) {
+    // Warm-started path matches independent fits at each strength
+    enum { ROWS = 300, COLS = 4, N = 4 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < COLS; j++)
+            X[i * COLS + j] = (double)((i * (j + 5)) % 13) / 6.0 - 1.0;
+        y[i] = X[i * COLS] - 0.5 * X[i * COLS + 2] + 0.25 * X[i * COLS + 3];
+    }
+    double alphas[N] = {1.0, 0.1, 0.01, 0.0};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.tol = 1e-10;
+
+    void* path[N];
+    int rc = fossil_data_ml_train_path(X, y, ROWS, COLS, alphas, N, "f64", "elastic_net", &opts, path);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    double a[4], b[4];
+    for (size_t k = 0; k < N; k++) {
+        void* single = NULL;
+        opts.l1 = alphas[k] * opts.l1_ratio;
+        opts.l2 = alphas[k] * (1 - opts.l1_ratio);
+        rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "elastic_net", &opts, &single);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil_data_ml_predict(X, 4, COLS, a, path[k], "f64");
+        fossil_data_ml_predict(X, 4, COLS, b, single, "f64");
+        for (size_t i = 0; i < 4; i++)
+            ASSUME_ITS_EQUAL_F64(a[i], b[i], 1e-6);
+        fossil_data_ml_free_model(single);
+        fossil_data_ml_free_model(path[k]);
+    }
+
+    // invalid arguments leave the handles as they were
+    alphas[1] = -1.0;
+    path[0] = path;
+    rc = fossil_data_ml_train_path(X, y, ROWS, COLS, alphas, N, "f64", "lasso", NULL, path);
+    ASSUME_ITS_EQUAL_I32(rc, -1);
+    ASSUME_ITS_TRUE(path[0] == (void*)path);
+    rc = fossil_data_ml_train_path(X, y, ROWS, COLS, alphas, N, "f64", "kmeans", NULL, path);
+    ASSUME_ITS_EQUAL_I32(rc, -4);
+    ASSUME_ITS_TRUE(path[0] == (void*)path);
+}
+
+FOSSIL_TEST(c_test_ml_decision_tree) {
+    // A step in x0 plus a step in x1 is fit exactly by a depth-2 tree
+    enum { ROWS = 200, COLS = 3 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i * COLS] = (double)(i % 20);
+        X[i * COLS + 1] = (double)((i * 7) % 13);
+        X[i * COLS + 2] = (double)((i * 3) % 5);
+        y[i] = (X[i * COLS] < 10 ? 1.0 : 5.0) + (X[i * COLS + 1] < 6 ? 0.0 : 2.0);
+    }
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.max_depth = 2;
+
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "decision_tree", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    static double pred[ROWS];
+    fossil_data_ml_predict(X, ROWS, COLS, pred, model, "f64");
+    for (size_t i = 0; i < ROWS; i++)
+        ASSUME_ITS_EQUAL_F64(pred[i], y[i], 1e-9);
+
+    // Unseen values fall on the side of the nearest training threshold
+    double probe[] = {2.5, 12.0, 0.0, 17.5, 0.5, 0.0};
+    double out[2];
+    fossil_data_ml_predict(probe, 2, COLS, out, model, "f64");
+    ASSUME_ITS_EQUAL_F64(out[0], 3.0, 1e-9);
+    ASSUME_ITS_EQUAL_F64(out[1], 5.0, 1e-9);
+
+    // Trees have no weights to quantize
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_quantize(model, "i8"), -1);
+    fossil_data_ml_free_model(model);
+
+    opts.max_bins = 1;
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "decision_tree", &opts, &model), -1);
+    ASSUME_ITS_CNULL(model);
+}
+
+FOSSIL_TEST(c_test_ml_gradient_boosting) {
+    // Boosting fits a nonlinear target far better than a linear model
+    enum { ROWS = 400, COLS = 2 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        double a = (double)(i % 40) / 10.0 - 2.0;
+        double b = (double)((i * 11) % 37) / 9.0 - 2.0;
+        X[i * COLS] = a;
+        X[i * COLS + 1] = b;
+        y[i] = a * a + (b > 0 ? b : 0.0);
+    }
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.max_iter = 200;
+    opts.max_depth = 3;
+
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, y, ROWS, COLS, "f64", "gradient_boosting", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    static double pred[ROWS];
+    fossil_data_ml_predict(X, ROWS, COLS, pred, model, "f64");
+    double sse = 0;
+    for (size_t i = 0; i < ROWS; i++)
+        sse += (pred[i] - y[i]) * (pred[i] - y[i]);
+    ASSUME_ITS_TRUE(sse / ROWS < 0.01);
+
+    // Saved and memory-mapped ensembles predict identically
+    const char* path = "fossil_data_ml_test_trees.model";
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_save_model(model, path), 0);
+    void* loaded = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_load_model(path, "mmap", &loaded), 0);
+    static double again[ROWS];
+    fossil_data_ml_predict(X, ROWS, COLS, again, loaded, "f64");
+    for (size_t i = 0; i < ROWS; i++)
+        ASSUME_ITS_TRUE(pred[i] == again[i]);
+    fossil_data_ml_free_model(loaded);
+    fossil_data_ml_free_model(model);
+    remove(path);
+}
+
+FOSSIL_TEST(c_test_ml_knn_query) {
+    // Probing every list is an exact search: compare with a full scan
+    enum { ROWS = 500, COLS = 4, NQ = 20, K = 3 };
+    static double X[ROWS * COLS];
+    static double Q[NQ * COLS];
+    for (size_t i = 0; i < ROWS * COLS; i++)
+        X[i] = (double)((i * 7919) % 1000) / 100.0;
+    for (size_t i = 0; i < NQ * COLS; i++)
+        Q[i] = (double)((i * 104729) % 1000) / 100.0;
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.n_lists = 10;
+
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, NULL, ROWS, COLS, "f64", "knn", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    size_t idx[NQ * K];
+    double dist[NQ * K];
+    rc = fossil_data_ml_knn_query(model, Q, NQ, COLS, "f64", K, 10, idx, dist);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t q = 0; q < NQ; q++) {
+        double nearest = 1e300;
+        for (size_t i = 0; i < ROWS; i++) {
+            double d = 0;
+            for (size_t j = 0; j < COLS; j++) {
+                double diff = X[i * COLS + j] - Q[q * COLS + j];
+                d += diff * diff;
+            }
+            if (d < nearest) nearest = d;
+        }
+        ASSUME_ITS_EQUAL_F64(dist[q * K], nearest, 1e-9);
+        ASSUME_ITS_TRUE(dist[q * K] <= dist[q * K + 1] && dist[q * K + 1] <= dist[q * K + 2]);
+    }
+
+    // A training row is its own nearest neighbor at distance zero
+    rc = fossil_data_ml_knn_query(model, X + 42 * COLS, 1, COLS, "f64", 1, 1, idx, dist);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_ITS_EQUAL_I32((int)idx[0], 42);
+    ASSUME_ITS_EQUAL_F64(dist[0], 0.0, 1e-12);
+
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_knn_query(model, Q, NQ, COLS, "f64", ROWS + 1, 0, idx, NULL), -1);
+    double y_out[1];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_predict(Q, 1, COLS, y_out, model, "f64"), -1);
+    fossil_data_ml_free_model(model);
+}
+
+FOSSIL_TEST(c_test_ml_knn_predict) {
+    // Two labelled groups: integer output votes, float output averages
+    int32_t X[] = {0, 0, 1, 0, 0, 1, 1, 1, 10, 10, 11, 10, 10, 11, 11, 11};
+    int32_t y[] = {0, 0, 0, 1, 1, 1, 1, 1};
+    fossil_data_ml_options_t opts;
+    fossil_data_ml_options_init(&opts);
+    opts.n_lists = 2;
+    opts.n_neighbors = 3;
+
+    void* model = NULL;
+    int rc = fossil_data_ml_train_ex(X, y, 8, 2, "i32", "knn", &opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    int32_t probe[] = {0, 1, 12, 12};
+    int32_t labels[2];
+    rc = fossil_data_ml_predict(probe, 2, 2, labels, model, "i32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_ITS_EQUAL_I32(labels[0], 0);
+    ASSUME_ITS_EQUAL_I32(labels[1], 1);
+    fossil_data_ml_free_model(model);
+
+    // Not a knn model
+    void* kmeans = NULL;
+    opts.k = 2;
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_train_ex(X, NULL, 8, 2, "i32", "kmeans", &opts, &kmeans), 0);
+    size_t idx[1];
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_knn_query(kmeans, probe, 1, 2, "i32", 1, 0, idx, NULL), -4);
+    fossil_data_ml_free_model(kmeans);
+}
+
+FOSSIL_TEST(c_test_ml_cross_validate) {
+    // The weaker ridge penalty wins on noiseless data; scores ignore thread count
+    enum { ROWS = 240, COLS = 3, G = 2, F = 4 };
+    static double X[ROWS * COLS];
+    static double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        for (size_t j = 0; j < COLS; j++)
+            X[i * COLS + j] = (double)((i * (j + 3)) % 17) / 8.0 - 1.0;
+        y[i] = 2.0 * X[i * COLS] - X[i * COLS + 1] + 0.5 * X[i * COLS + 2];
+    }
+    fossil_data_ml_options_t grid[G];
+    fossil_data_ml_options_init(&grid[0]);
+    grid[0].l2 = 10.0;
+    grid[1] = grid[0];
+    grid[1].l2 = 1e-6;
+    grid[1].tol = 1e-12;
+
+    double scores[2][G * F];
+    size_t best = 99;
+    for (int t = 0; t < 2; t++) {
+        fossil_data_parallel_set_threads(t == 0 ? 1 : 4);
+        int rc = fossil_data_ml_cross_validate(X, y, ROWS, COLS, "f64", "ridge", grid, G, F,
+                                               "mse", scores[t], &best);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        ASSUME_ITS_EQUAL_I32((int)best, 1);
+    }
+    fossil_data_parallel_set_threads(0);
+    for (size_t k = 0; k < G * F; k++)
+        ASSUME_ITS_EQUAL_F64(scores[0][k], scores[1][k], 0.0);
+    for (size_t f = 0; f < F; f++) {
+        ASSUME_ITS_TRUE(scores[0][f] > 0.1);
+        ASSUME_ITS_TRUE(scores[0][F + f] < 1e-6);
+    }
+
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_cross_validate(X, y, ROWS, COLS, "f64", "ridge", grid, G, 1,
+                                                       "mse", scores[0], NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_cross_validate(X, y, ROWS, COLS, "f64", "ridge", grid, G, F,
+                                                       "r2", scores[0], NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_data_ml_cross_validate(X, y, ROWS, COLS, "f64", "kmeans", grid, G, F,
+                                                       "mse", scores[0], NULL), -4);
+}
+
+FOSSIL_TEST(c_test_ml_cross_validate_accuracy) {
+    // Two separated classes: knn and a tree classify every held-out row
+    enum { ROWS = 120, COLS = 2, F = 3 };
+    static int32_t X[ROWS * COLS];
+    static int32_t y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        int32_t c = (int32_t)(i % 2);
+        X[i * COLS] = c * 100 + (int32_t)(i % 7);
+        X[i * COLS + 1] = (int32_t)((i * 5) % 11);
+        y[i] = c;
+    }
+    fossil_data_ml_options_t grid;
+    fossil_data_ml_options_init(&grid);
+    grid.n_lists = 2;
+    grid.n_neighbors = 3;
+    double scores[F];
+    const char* models[] = {"knn", "decision_tree"};
+    for (size_t k = 0; k < 2; k++) {
+        int rc = fossil_data_ml_cross_validate(X, y, ROWS, COLS, "i32", models[k], &grid, 1, F,
+                                               "accuracy", scores, NULL);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        for (size_t f = 0; f < F; f++)
+            ASSUME_ITS_EQUAL_F64(scores[f], 1.0, 1e-12);
+    }
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -169,6 +1029,29 @@ FOSSIL_TEST_GROUP(c_ml_tests) {
     FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_logistic_regression_i32);
     FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_f32);
     FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_invalid_args);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_linear_regression_thread_invariant);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_options);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_invalid_options);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_algorithms_agree);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_partial_fit);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_minibatch);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_kmeans_thread_invariant);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_predict_batch_tiles);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_predictor_score_one);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_save_load_model);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_quantize);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_train_multi);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_sparse_regression);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_sparse_csc_kmeans);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_sparse_invalid);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_lasso_sparsity);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_train_path);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_decision_tree);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_gradient_boosting);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_knn_query);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_knn_predict);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_cross_validate);
+    FOSSIL_TEST_ADD(c_ml_suite, c_test_ml_cross_validate_accuracy);
 
     // Register the test suite
     FOSSIL_TEST_REGISTER(c_ml_suite);
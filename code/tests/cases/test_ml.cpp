@@ -160,6 +160,354 @@ FOSSIL_TEST(cpp_test_ml_invalid_args) {
     fossil::data::ML::free_model(nullptr);
 }
 
+FOSSIL_TEST(cpp_test_ml_linear_regression_thread_invariant) {
+    // y = 1*x0 + 2*x1 + 3*x2 over enough rows to split into several chunks
+    const size_t rows = 3000, cols = 3;
+    static double X[3000 * 3];
+    static double y[3000];
+    for (size_t i = 0; i < rows; i++) {
+        X[i * cols + 0] = (double)(i % 7) / 7.0;
+        X[i * cols + 1] = (double)(i % 11) / 11.0;
+        X[i * cols + 2] = (double)(i % 13) / 13.0;
+        y[i] = X[i * cols] + 2.0 * X[i * cols + 1] + 3.0 * X[i * cols + 2];
+    }
+
+    double pred[2] = {0};
+    for (int t = 0; t < 2; t++) {
+        fossil::data::Parallel::set_threads(t == 0 ? 1 : 4);
+        void* model = fossil::data::ML::train(X, y, rows, cols, "f64", "linear_regression");
+        ASSUME_NOT_CNULL(model);
+        int rc = fossil::data::ML::predict(X + 3, 1, cols, &pred[t], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil::data::ML::free_model(model);
+    }
+    fossil::data::Parallel::set_threads(0);
+
+    // Chunk-ordered reduction: same weights for any thread count
+    ASSUME_ITS_TRUE(pred[0] == pred[1]);
+}
+
+FOSSIL_TEST(cpp_test_ml_kmeans_options) {
+    // Two well separated groups, k-means++ seeding with k = 2
+    double X[8] = {0.0, 0.2, 0.1, 0.3, 20.0, 20.2, 20.1, 20.3};
+    fossil_data_ml_options_t opts = fossil::data::ML::default_options();
+    opts.k = 2;
+    opts.max_iter = 50;
+    void* model = fossil::data::ML::train(X, nullptr, 8, 1, "f64", "kmeans", opts);
+    ASSUME_NOT_CNULL(model);
+
+    int32_t labels[8] = {0};
+    int rc = fossil::data::ML::predict(X, 8, 1, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (int i = 1; i < 4; i++) {
+        ASSUME_ITS_EQUAL_I32(labels[0], labels[i]);
+        ASSUME_ITS_EQUAL_I32(labels[4], labels[4 + i]);
+    }
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[4]);
+
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_kmeans_invalid_options) {
+    double X[4] = {1.0, 2.0, 3.0, 4.0};
+    fossil_data_ml_options_t opts = fossil::data::ML::default_options();
+    opts.k = 5; // more clusters than rows
+    void* model = fossil::data::ML::train(X, nullptr, 4, 1, "f64", "kmeans", opts);
+    ASSUME_ITS_CNULL(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_kmeans_algorithms_agree) {
+    // Lloyd, Hamerly and Elkan must converge to the same clustering
+    const size_t rows = 200, cols = 2;
+    static double X[200 * 2];
+    for (size_t i = 0; i < rows; i++) {
+        X[i * cols + 0] = (double)(i % 5) * 10.0 + (double)(i % 7) * 0.1;
+        X[i * cols + 1] = (double)(i % 3) * 10.0 + (double)(i % 11) * 0.1;
+    }
+    const char* algorithms[3] = {"lloyd", "hamerly", "elkan"};
+    static int32_t labels[3][200];
+
+    for (int a = 0; a < 3; a++) {
+        fossil_data_ml_options_t opts = fossil::data::ML::default_options();
+        opts.k = 6;
+        opts.algorithm = algorithms[a];
+        void* model = fossil::data::ML::train(X, nullptr, rows, cols, "f64", "kmeans", opts);
+        ASSUME_NOT_CNULL(model);
+        int rc = fossil::data::ML::predict(X, rows, cols, labels[a], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil::data::ML::free_model(model);
+    }
+    for (size_t i = 0; i < rows; i++) {
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[1][i]);
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[2][i]);
+    }
+}
+
+FOSSIL_TEST(cpp_test_ml_kmeans_partial_fit) {
+    // Stream two groups through the model in chunks of 4 rows
+    double X[16] = {0.0, 20.0, 0.1, 20.1, 0.2, 20.2, 0.3, 20.3,
+                    0.4, 20.4, 0.5, 20.5, 0.6, 20.6, 0.7, 20.7};
+    fossil_data_ml_options_t opts = fossil::data::ML::default_options();
+    opts.k = 2;
+    void* model = nullptr;
+    for (size_t chunk = 0; chunk < 16; chunk += 4) {
+        int rc = fossil::data::ML::partial_fit(X + chunk, 4, 1, "f64", "kmeans", opts, model);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        ASSUME_NOT_CNULL(model);
+    }
+
+    double X_test[2] = {0.25, 19.0};
+    int32_t labels[2] = {0};
+    int rc = fossil::data::ML::predict(X_test, 2, 1, labels, model, "f64");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_EQUAL_I32(labels[0], labels[1]);
+
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_kmeans_thread_invariant) {
+    // Enough rows for several accumulator chunks
+    const size_t rows = 5000, cols = 2;
+    static double X[5000 * 2];
+    for (size_t i = 0; i < rows; i++) {
+        X[i * cols + 0] = (double)(i % 4) * 5.0 + (double)(i % 9) * 0.1;
+        X[i * cols + 1] = (double)(i % 6) * 5.0 + (double)(i % 13) * 0.1;
+    }
+    static int32_t labels[2][5000];
+    for (int t = 0; t < 2; t++) {
+        fossil_data_ml_options_t opts = fossil::data::ML::default_options();
+        opts.k = 8;
+        fossil::data::Parallel::set_threads(t == 0 ? 1 : 4);
+        void* model = fossil::data::ML::train(X, nullptr, rows, cols, "f64", "kmeans", opts);
+        ASSUME_NOT_CNULL(model);
+        int rc = fossil::data::ML::predict(X, rows, cols, labels[t], model, "f64");
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        fossil::data::ML::free_model(model);
+    }
+    fossil::data::Parallel::set_threads(0);
+    for (size_t i = 0; i < rows; i++)
+        ASSUME_ITS_EQUAL_I32(labels[0][i], labels[1][i]);
+}
+
+FOSSIL_TEST(cpp_test_ml_predict_batch_tiles) {
+    // Rows spanning several prediction tiles, scored in i16
+    const size_t rows = 1000;
+    static int16_t X[1000];
+    static int16_t y[1000];
+    static int16_t y_pred[1000];
+    for (size_t i = 0; i < rows; i++) {
+        X[i] = (int16_t)(i % 10);
+        y[i] = (int16_t)(3 * X[i]);
+    }
+    void* model = fossil::data::ML::train(X, y, rows, 1, "i16", "linear_regression");
+    ASSUME_NOT_CNULL(model);
+
+    int rc = fossil::data::ML::predict(X, rows, 1, y_pred, model, "i16");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t i = 0; i < rows; i += 97)
+        ASSUME_ITS_TRUE(y_pred[i] == y[i] || y_pred[i] == y[i] - 1);
+
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_predictor_score_one) {
+    // Single-row scoring through a compiled predictor
+    float X[] = {1.0f, 2.0f, 3.0f, 4.0f};
+    float y[] = {3.0f, 6.0f, 9.0f, 12.0f};
+    void* model = fossil::data::ML::train(X, y, 4, 1, "f32", "linear_regression");
+    ASSUME_NOT_CNULL(model);
+
+    void* pred = fossil::data::ML::predictor_create(model, 1, "f32");
+    ASSUME_NOT_CNULL(pred);
+    float batch[4];
+    int rc = fossil::data::ML::predict(X, 4, 1, batch, model, "f32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t i = 0; i < 4; i++) {
+        float out = 0.0f;
+        rc = fossil::data::ML::score_one(pred, &X[i], &out);
+        ASSUME_ITS_EQUAL_I32(rc, 0);
+        ASSUME_ITS_TRUE(out == batch[i]);
+    }
+    ASSUME_ITS_CNULL(fossil::data::ML::predictor_create(model, 2, "f32"));
+
+    fossil::data::ML::predictor_free(pred);
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_save_load_model) {
+    // Round-trip a regression model through a mapped load
+    const std::string path = "fossil_data_ml_test_cpp.model";
+    double X[] = {1.0, 2.0, 3.0, 4.0};
+    double y[] = {3.0, 6.0, 9.0, 12.0};
+    double before[4], after[4];
+    void* model = fossil::data::ML::train(X, y, 4, 1, "f64", "linear_regression");
+    ASSUME_NOT_CNULL(model);
+    fossil::data::ML::predict(X, 4, 1, before, model, "f64");
+    ASSUME_ITS_EQUAL_I32(fossil::data::ML::save_model(model, path), 0);
+    fossil::data::ML::free_model(model);
+
+    model = fossil::data::ML::load_model(path, "mmap");
+    ASSUME_NOT_CNULL(model);
+    fossil::data::ML::predict(X, 4, 1, after, model, "f64");
+    for (size_t i = 0; i < 4; i++)
+        ASSUME_ITS_TRUE(before[i] == after[i]);
+    fossil::data::ML::free_model(model);
+
+    ASSUME_ITS_CNULL(fossil::data::ML::load_model(path, "bogus"));
+    remove(path.c_str());
+}
+
+FOSSIL_TEST(cpp_test_ml_quantize) {
+    // i16 weights against i16 features track the f64 model
+    int16_t X[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    int16_t y[] = {3, 6, 9, 12, 15, 18, 21, 24};
+    int16_t before[8], after[8];
+    void* model = fossil::data::ML::train(X, y, 8, 1, "i16", "linear_regression");
+    ASSUME_NOT_CNULL(model);
+    int rc = fossil::data::ML::predict(X, 8, 1, before, model, "i16");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    ASSUME_ITS_EQUAL_I32(fossil::data::ML::quantize(model, "i16"), 0);
+    rc = fossil::data::ML::predict(X, 8, 1, after, model, "i16");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    for (size_t i = 0; i < 8; i++)
+        ASSUME_ITS_TRUE(after[i] - before[i] <= 1 && before[i] - after[i] <= 1);
+
+    ASSUME_NOT_EQUAL_I32(fossil::data::ML::quantize(model, "bogus"), 0);
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_train_multi) {
+    // Logistic models for two label columns trained in one call
+    float X[] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+    float Y[] = {0, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0};
+    auto opts = fossil::data::ML::default_options();
+    void* models[2] = {nullptr, nullptr};
+    int rc = fossil::data::ML::train_multi(X, Y, 8, 1, 2, nullptr, nullptr, 2,
+                                           "f32", "logistic_regression", opts, models);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_CNULL(models[0]);
+    ASSUME_NOT_CNULL(models[1]);
+
+    // The first column rises with x, the second falls
+    float probe = 7.0f, p0 = 0.0f, p1 = 0.0f;
+    fossil::data::ML::predict(&probe, 1, 1, &p0, models[0], "f32");
+    fossil::data::ML::predict(&probe, 1, 1, &p1, models[1], "f32");
+    ASSUME_ITS_TRUE(p0 > 0.5f);
+    ASSUME_ITS_TRUE(p1 < 0.5f);
+
+    fossil::data::ML::free_model(models[0]);
+    fossil::data::ML::free_model(models[1]);
+}
+
+FOSSIL_TEST(cpp_test_ml_sparse_f32) {
+    // One-hot style f32 features through the sparse wrappers
+    float vals[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    size_t idx[] = {0, 1, 0, 1, 0, 1};
+    size_t ptr[] = {0, 1, 2, 3, 4, 5, 6};
+    float y[] = {0, 1, 0, 1, 0, 1};
+    fossil_data_ml_sparse_t X = { "csr", 6, 2, ptr, idx, vals };
+    auto opts = fossil::data::ML::default_options();
+    void* model = nullptr;
+    int rc = fossil::data::ML::train_sparse(X, y, "f32", "logistic_regression", opts, &model);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_NOT_CNULL(model);
+
+    float p[6] = {0};
+    rc = fossil::data::ML::predict_sparse(X, p, model, "f32");
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_ITS_TRUE(p[0] < 0.5f);
+    ASSUME_ITS_TRUE(p[1] > 0.5f);
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_ridge_path) {
+    // Stronger ridge penalties shrink the fitted slope towards zero
+    float X[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    float y[] = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+    double alphas[] = {10.0, 1.0, 0.0};
+    auto opts = fossil::data::ML::default_options();
+    opts.tol = 1e-9;
+    void* models[3] = {nullptr, nullptr, nullptr};
+    int rc = fossil::data::ML::train_path(X, y, 6, 1, alphas, 3, "f32", "ridge", opts, models);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+
+    float probe = 1.0f, slope[3] = {0};
+    for (int k = 0; k < 3; k++)
+        fossil::data::ML::predict(&probe, 1, 1, &slope[k], models[k], "f32");
+    ASSUME_ITS_TRUE(slope[0] < slope[1]);
+    ASSUME_ITS_TRUE(slope[1] < slope[2]);
+    ASSUME_ITS_EQUAL_F64(slope[2], 2.0, 1e-4);
+    for (int k = 0; k < 3; k++)
+        fossil::data::ML::free_model(models[k]);
+}
+
+FOSSIL_TEST(cpp_test_ml_gradient_boosting_f32) {
+    // Boosted trees learn a threshold a linear model cannot
+    float X[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    float y[] = {0, 0, 0, 0, 0, 1, 1, 1, 1, 1};
+    auto opts = fossil::data::ML::default_options();
+    opts.learning_rate = 0.5;
+    opts.max_iter = 50;
+    void* model = fossil::data::ML::train(X, y, 10, 1, "f32", "gradient_boosting", opts);
+    ASSUME_NOT_CNULL(model);
+
+    float probe[] = {1.5f, 8.5f};
+    float out[2] = {0};
+    fossil::data::ML::predict(probe, 2, 1, out, model, "f32");
+    ASSUME_ITS_EQUAL_F64(out[0], 0.0, 1e-3);
+    ASSUME_ITS_EQUAL_F64(out[1], 1.0, 1e-3);
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_knn_f32) {
+    // Regression by averaging the nearest targets
+    float X[] = {0.0f, 1.0f, 2.0f, 3.0f, 10.0f, 11.0f, 12.0f, 13.0f};
+    float y[] = {1.0f, 1.0f, 1.0f, 1.0f, 5.0f, 5.0f, 5.0f, 5.0f};
+    auto opts = fossil::data::ML::default_options();
+    opts.n_lists = 2;
+    opts.n_neighbors = 2;
+    void* model = fossil::data::ML::train(X, y, 8, 1, "f32", "knn", opts);
+    ASSUME_NOT_CNULL(model);
+
+    float probe[] = {1.4f, 11.6f};
+    float out[2] = {0};
+    ASSUME_ITS_EQUAL_I32(fossil::data::ML::predict(probe, 2, 1, out, model, "f32"), 0);
+    ASSUME_ITS_EQUAL_F64(out[0], 1.0, 1e-6);
+    ASSUME_ITS_EQUAL_F64(out[1], 5.0, 1e-6);
+
+    size_t idx[2];
+    double dist[2];
+    ASSUME_ITS_EQUAL_I32(fossil::data::ML::knn_query(model, probe, 1, 1, "f32", 2, 0, idx, dist), 0);
+    ASSUME_ITS_EQUAL_I32((int)idx[0], 1);
+    ASSUME_ITS_EQUAL_I32((int)idx[1], 2);
+    fossil::data::ML::free_model(model);
+}
+
+FOSSIL_TEST(cpp_test_ml_cross_validate) {
+    // Longer training sharpens the probabilities, lowering the held-out Brier score
+    enum { ROWS = 200, F = 5 };
+    double X[ROWS];
+    double y[ROWS];
+    for (size_t i = 0; i < ROWS; i++) {
+        X[i] = (double)(i % 40) / 10.0 - 2.0;
+        y[i] = X[i] > 0 ? 1.0 : 0.0;
+    }
+    fossil_data_ml_options_t grid[2] = {
+        fossil::data::ML::default_options(), fossil::data::ML::default_options()
+    };
+    grid[0].max_iter = 1;
+    grid[1].max_iter = 500;
+    double scores[2 * F];
+    size_t best = 99;
+    int rc = fossil::data::ML::cross_validate(X, y, ROWS, 1, "f64", "logistic_regression",
+                                              grid, 2, F, "mse", scores, &best);
+    ASSUME_ITS_EQUAL_I32(rc, 0);
+    ASSUME_ITS_EQUAL_I32((int)best, 1);
+    for (size_t f = 0; f < F; f++)
+        ASSUME_ITS_TRUE(scores[F + f] < scores[f]);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -169,6 +517,22 @@ FOSSIL_TEST_GROUP(cpp_ml_tests) {
     FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_logisticpp_regression_i32);
     FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_f32);
     FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_invalid_args);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_linear_regression_thread_invariant);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_options);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_invalid_options);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_algorithms_agree);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_partial_fit);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_kmeans_thread_invariant);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_predict_batch_tiles);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_predictor_score_one);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_save_load_model);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_quantize);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_train_multi);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_sparse_f32);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_ridge_path);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_gradient_boosting_f32);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_knn_f32);
+    FOSSIL_TEST_ADD(cpp_ml_suite, cpp_test_ml_cross_validate);
 
     // Register the test suite
     FOSSIL_TEST_REGISTER(cpp_ml_suite);
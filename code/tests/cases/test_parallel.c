@@ -0,0 +1,118 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/pizza/framework.h>
+
+#include "fossil/data/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilites
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Define the test suite and add test cases
+FOSSIL_SUITE(c_parallel_suite);
+
+// Setup function for the test suite
+FOSSIL_SETUP(c_parallel_suite) {
+    // Setup code here
+}
+
+// Teardown function for the test suite
+FOSSIL_TEARDOWN(c_parallel_suite) {
+    // Teardown code here
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+
+typedef struct {
+    int* hits;
+    size_t* chunk_of;
+} c_parallel_ctx_t;
+
+static void c_parallel_mark(void* ctx, size_t chunk, size_t begin, size_t end) {
+    c_parallel_ctx_t* c = (c_parallel_ctx_t*)ctx;
+    for (size_t i = begin; i < end; i++) {
+        c->hits[i]++;
+        c->chunk_of[i] = chunk;
+    }
+}
+
+FOSSIL_TEST(c_test_parallel_for_covers_range) {
+    int hits[1000] = {0};
+    size_t chunk_of[1000] = {0};
+    c_parallel_ctx_t ctx = { hits, chunk_of };
+
+    fossil_data_parallel_set_threads(4);
+    int rc = fossil_data_parallel_for(1000, 64, c_parallel_mark, &ctx);
+    fossil_data_parallel_set_threads(0);
+    ASSUME_ITS_EQUAL_I32(0, rc);
+
+    for (size_t i = 0; i < 1000; i++) {
+        ASSUME_ITS_EQUAL_I32(1, hits[i]);
+        ASSUME_ITS_EQUAL_SIZE(i / 64, chunk_of[i]);
+    }
+}
+
+FOSSIL_TEST(c_test_parallel_chunks) {
+    ASSUME_ITS_EQUAL_SIZE(0, fossil_data_parallel_chunks(0, 8));
+    ASSUME_ITS_EQUAL_SIZE(1, fossil_data_parallel_chunks(8, 8));
+    ASSUME_ITS_EQUAL_SIZE(2, fossil_data_parallel_chunks(9, 8));
+    ASSUME_ITS_EQUAL_SIZE(9, fossil_data_parallel_chunks(9, 0));
+}
+
+FOSSIL_TEST(c_test_parallel_threads) {
+    fossil_data_parallel_set_threads(3);
+    size_t n = fossil_data_parallel_get_threads();
+    ASSUME_ITS_TRUE(n == 3 || n == 1); /* 1 when built without threads */
+    fossil_data_parallel_set_threads(0);
+    ASSUME_ITS_TRUE(fossil_data_parallel_get_threads() >= 1);
+}
+
+FOSSIL_TEST(c_test_parallel_invalid_args) {
+    int rc = fossil_data_parallel_for(10, 1, NULL, NULL);
+    ASSUME_ITS_TRUE(rc != 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(c_parallel_tests) {
+    FOSSIL_TEST_ADD(c_parallel_suite, c_test_parallel_for_covers_range);
+    FOSSIL_TEST_ADD(c_parallel_suite, c_test_parallel_chunks);
+    FOSSIL_TEST_ADD(c_parallel_suite, c_test_parallel_threads);
+    FOSSIL_TEST_ADD(c_parallel_suite, c_test_parallel_invalid_args);
+
+    // Register the test suite
+    FOSSIL_TEST_REGISTER(c_parallel_suite);
+}
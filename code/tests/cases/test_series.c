@@ -131,6 +131,966 @@ FOSSIL_TEST(c_test_series_rolling_mean_invalid_args) {
     ASSUME_ITS_TRUE(rc != 0);
 }
 
+FOSSIL_TEST(c_test_series_cumsum_blocks) {
+    // Spans several scan blocks; every thread count gives the same sums
+    enum { N = 200003 };
+    static double input[N];
+    static double one[N];
+    static double four[N];
+    for (size_t i = 0; i < N; i++)
+        input[i] = (double)(i % 11) * 0.25;
+    fossil_data_parallel_set_threads(1);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_cumsum(input, one, N, "f64"));
+    fossil_data_parallel_set_threads(4);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_cumsum(input, four, N, "f64"));
+    fossil_data_parallel_set_threads(0);
+    double expect = 0;
+    int same = 1;
+    for (size_t i = 0; i < N; i++) {
+        expect += input[i];
+        same &= one[i] == four[i];
+    }
+    ASSUME_ITS_TRUE(same);
+    ASSUME_ITS_EQUAL_F64(expect, one[N - 1], 1e-6);
+    ASSUME_ITS_EQUAL_F64(0.25 * 1 + 0.5, one[2], 1e-12);
+}
+
+FOSSIL_TEST(c_test_series_cumsum_narrow_types) {
+    // Narrow integers keep their own width and wrap; in place is allowed
+    int8_t a[4] = {100, 20, 10, -5};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_cumsum(a, a, 4, "i8"));
+    ASSUME_ITS_EQUAL_I32(100, a[0]);
+    ASSUME_ITS_EQUAL_I32(120, a[1]);
+    ASSUME_ITS_EQUAL_I32(-126, a[2]);
+    ASSUME_ITS_EQUAL_I32(125, a[3]);
+
+    uint16_t b[3] = {60000, 5000, 1};
+    uint16_t out[3] = {0};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_cumsum(b, out, 3, "u16"));
+    ASSUME_ITS_EQUAL_I32(60000, out[0]);
+    ASSUME_ITS_EQUAL_I32(65000, out[1]);
+    ASSUME_ITS_EQUAL_I32(65001, out[2]);
+}
+
+FOSSIL_TEST(c_test_series_rolling_family) {
+    double input[6] = {4.0, 1.0, 3.0, 5.0, 2.0, 6.0};
+    double output[6] = {0.0};
+    double sum[6] = {4.0, 5.0, 8.0, 9.0, 10.0, 13.0};
+    double var[6] = {0.0, 4.5, 7.0 / 3.0, 4.0, 7.0 / 3.0, 13.0 / 3.0};
+    double min[6] = {4.0, 1.0, 1.0, 1.0, 2.0, 2.0};
+    double max[6] = {4.0, 4.0, 4.0, 5.0, 5.0, 6.0};
+    double median[6] = {4.0, 2.5, 3.0, 3.0, 3.0, 5.0};
+    double lower[6] = {4.0, 1.75, 2.0, 2.0, 2.5, 3.5};
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_sum(input, output, 6, 3, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(sum[i], output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_var(input, output, 6, 3, 1, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(var[i], output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_std(input, output, 6, 3, 1, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(var[i], output[i] * output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_min(input, output, 6, 3, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(min[i], output[i], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_max(input, output, 6, 3, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(max[i], output[i], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_median(input, output, 6, 3, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(median[i], output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_quantile(input, output, 6, 3, 0.25, "f64"));
+    for (int i = 0; i < 6; i++) ASSUME_ITS_EQUAL_F64(lower[i], output[i], 1e-12);
+}
+
+FOSSIL_TEST(c_test_series_rolling_long_window) {
+    // long enough to wrap the ring many times and hit the periodic recompute
+    enum { N = 5000, W = 97 };
+    static double input[N], output[N];
+    for (int i = 0; i < N; i++) input[i] = (double)((i * 7919) % 1013) + 1e6;
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_var(input, output, N, W, 0, "f64"));
+    for (int i = 0; i < N; i += 499) {
+        int lo = i + 1 >= W ? i + 1 - W : 0;
+        double mean = 0.0, m2 = 0.0;
+        for (int j = lo; j <= i; j++) mean += input[j];
+        mean /= (double)(i + 1 - lo);
+        for (int j = lo; j <= i; j++) m2 += (input[j] - mean) * (input[j] - mean);
+        ASSUME_ITS_EQUAL_F64(m2 / (double)(i + 1 - lo), output[i], 1e-6);
+    }
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_max(input, output, N, W, "f64"));
+    for (int i = 0; i < N; i += 499) {
+        int lo = i + 1 >= W ? i + 1 - W : 0;
+        double max = input[lo];
+        for (int j = lo; j <= i; j++) if (input[j] > max) max = input[j];
+        ASSUME_ITS_EQUAL_F64(max, output[i], 0.0);
+    }
+
+    // a constant window has exactly zero variance
+    for (int i = 0; i < N; i++) input[i] = 0.1;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_std(input, output, N, W, 1, "f64"));
+    ASSUME_ITS_EQUAL_F64(0.0, output[N - 1], 0.0);
+}
+
+FOSSIL_TEST(c_test_series_rolling_median_i32_inplace) {
+    int32_t data[6] = {5, 1, 4, 2, 8, 3};
+    int rc = fossil_data_series_rolling_median(data, data, 6, 3, "i32");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    ASSUME_ITS_EQUAL_I32(5, data[0]); // {5}
+    ASSUME_ITS_EQUAL_I32(3, data[1]); // {1,5} -> 3
+    ASSUME_ITS_EQUAL_I32(4, data[2]); // {1,4,5}
+    ASSUME_ITS_EQUAL_I32(2, data[3]); // {1,2,4}
+    ASSUME_ITS_EQUAL_I32(4, data[4]); // {2,4,8}
+    ASSUME_ITS_EQUAL_I32(3, data[5]); // {2,3,8}
+}
+
+FOSSIL_TEST(c_test_series_rolling_family_invalid_args) {
+    double input[2] = {1.0, 2.0};
+    double output[2] = {0.0};
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_sum(NULL, output, 2, 1, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_min(input, output, 2, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_var(input, output, 2, 1, 0, "badtype") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_quantile(input, output, 2, 1, 1.5, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_quantile(input, output, 2, 1, -0.1, "f64") != 0);
+}
+
+FOSSIL_TEST(c_test_series_rolling_multi_matches_single) {
+    enum { N = 3000, F = 7 };
+    static float input[N], fused[F][N], single[N];
+    const char *stats[F] = {"mean", "std", "min", "max", "sum", "var", "median"};
+    size_t windows[F] = {20, 20, 20, 20, 20, 50, 15};
+    void *outputs[F];
+    for (int i = 0; i < N; i++) input[i] = (float)((i * 37) % 101) * 0.5f - 20.0f;
+    for (int k = 0; k < F; k++) outputs[k] = fused[k];
+
+    int rc = fossil_data_series_rolling_multi(input, outputs, N, stats, windows, F, 1, "f32");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+
+    // every feature must match its single-statistic call bit for bit
+    for (int k = 0; k < F; k++) {
+        switch (k) {
+        case 0: fossil_data_series_rolling_mean(input, single, N, 20, "f32"); break;
+        case 1: fossil_data_series_rolling_std(input, single, N, 20, 1, "f32"); break;
+        case 2: fossil_data_series_rolling_min(input, single, N, 20, "f32"); break;
+        case 3: fossil_data_series_rolling_max(input, single, N, 20, "f32"); break;
+        case 4: fossil_data_series_rolling_sum(input, single, N, 20, "f32"); break;
+        case 5: fossil_data_series_rolling_var(input, single, N, 50, 1, "f32"); break;
+        default: fossil_data_series_rolling_median(input, single, N, 15, "f32"); break;
+        }
+        int same = 1;
+        for (int i = 0; i < N; i++) same &= fused[k][i] == single[i];
+        ASSUME_ITS_TRUE(same);
+    }
+}
+
+FOSSIL_TEST(c_test_series_rolling_multi_inplace_i32) {
+    int32_t data[5] = {10, 20, 30, 40, 50};
+    int32_t max[5] = {0};
+    const char *stats[2] = {"max", "mean"};
+    size_t windows[2] = {2, 3};
+    void *outputs[2] = {max, data};
+    int rc = fossil_data_series_rolling_multi(data, outputs, 5, stats, windows, 2, 0, "i32");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    ASSUME_ITS_EQUAL_I32(10, max[0]);
+    ASSUME_ITS_EQUAL_I32(50, max[4]);
+    ASSUME_ITS_EQUAL_I32(15, data[1]); // (10+20)/2
+    ASSUME_ITS_EQUAL_I32(40, data[4]); // (30+40+50)/3
+}
+
+FOSSIL_TEST(c_test_series_rolling_multi_invalid_args) {
+    double input[2] = {1.0, 2.0};
+    double output[2] = {0.0};
+    void *outputs[1] = {output};
+    const char *stats[1] = {"mean"};
+    const char *bad[1] = {"mode"};
+    size_t windows[1] = {2};
+    size_t zero[1] = {0};
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_multi(NULL, outputs, 2, stats, windows, 1, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_multi(input, outputs, 2, stats, windows, 0, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_multi(input, outputs, 2, bad, windows, 1, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_multi(input, outputs, 2, stats, zero, 1, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_multi(input, outputs, 2, stats, windows, 1, 0, "badtype") != 0);
+}
+
+FOSSIL_TEST(c_test_series_stream_matches_batch) {
+    enum { N = 1000 };
+    static double input[N], batch[N], streamed[N];
+    for (int i = 0; i < N; i++) input[i] = (double)((i * 53) % 97) - 40.0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_std(input, batch, N, 25, 1, "f64"));
+
+    void *stream = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("std", 25, 1, "f64", &stream));
+    // uneven batches, including an empty one
+    size_t sizes[5] = {7, 0, 300, 1, 692};
+    size_t at = 0;
+    for (int b = 0; b < 5; b++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, input + at, streamed + at, sizes[b]));
+        at += sizes[b];
+    }
+    int same = 1;
+    for (int i = 0; i < N; i++) same &= batch[i] == streamed[i];
+    ASSUME_ITS_TRUE(same);
+
+    double value = 0.0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_value(stream, &value));
+    ASSUME_ITS_EQUAL_F64(batch[N - 1], value, 0.0);
+    fossil_data_series_stream_free(stream);
+}
+
+FOSSIL_TEST(c_test_series_stream_save_load) {
+    double input[8] = {5.0, 1.0, 4.0, 2.0, 8.0, 3.0, 7.0, 6.0};
+    double batch[8], streamed[8];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_median(input, batch, 8, 3, "f64"));
+
+    void *stream = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("median", 3, 0, "f64", &stream));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, input, streamed, 5));
+
+    size_t size = 0;
+    unsigned char state[512];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_save(stream, NULL, 0, &size));
+    ASSUME_ITS_TRUE(size <= sizeof(state));
+    ASSUME_ITS_TRUE(fossil_data_series_stream_save(stream, state, size - 1, &size) != 0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_save(stream, state, sizeof(state), &size));
+    fossil_data_series_stream_free(stream);
+
+    // the restored stream carries on where the saved one stopped
+    void *restored = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(restored, input + 5, streamed + 5, 3));
+    for (int i = 0; i < 8; i++) ASSUME_ITS_EQUAL_F64(batch[i], streamed[i], 0.0);
+    fossil_data_series_stream_free(restored);
+
+    state[0] ^= 0xFF;
+    ASSUME_ITS_EQUAL_I32(-5, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_TRUE(restored == NULL);
+}
+
+FOSSIL_TEST(c_test_series_stream_cumsum_i32) {
+    int32_t first[3] = {1, 2, 3};
+    int32_t second[2] = {4, -20};
+    int32_t out[3] = {0};
+    int32_t value = -1;
+    void *stream = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("cumsum", 0, 0, "i32", &stream));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_value(stream, &value));
+    ASSUME_ITS_EQUAL_I32(0, value); // empty sum
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, first, out, 3));
+    ASSUME_ITS_EQUAL_I32(6, out[2]);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, second, NULL, 2));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_value(stream, &value));
+    ASSUME_ITS_EQUAL_I32(-10, value);
+    fossil_data_series_stream_free(stream);
+}
+
+FOSSIL_TEST(c_test_series_stream_invalid_args) {
+    void *stream = NULL;
+    double value = 0.0;
+    ASSUME_ITS_TRUE(fossil_data_series_stream_create("mode", 3, 0, "f64", &stream) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_stream_create("mean", 0, 0, "f64", &stream) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_stream_create("mean", 3, 0, "badtype", &stream) != 0);
+    ASSUME_ITS_TRUE(stream == NULL);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("max", 3, 0, "f64", &stream));
+    ASSUME_ITS_TRUE(fossil_data_series_stream_value(stream, &value) != 0); // no values yet
+    ASSUME_ITS_TRUE(fossil_data_series_stream_push(stream, NULL, NULL, 2) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_stream_push(NULL, &value, NULL, 1) != 0);
+    fossil_data_series_stream_free(stream);
+}
+
+FOSSIL_TEST(c_test_series_ewma_ewvar_holt) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double output[4] = {0.0};
+    double ewma[4] = {1.0, 1.5, 2.25, 3.125};
+    double ewvar[4] = {0.0, 0.25, 0.6875, 1.109375};
+    double holt[4] = {1.0, 1.75, 2.9375, 4.296875};
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_ewma(input, output, 4, 0.5, "f64"));
+    for (int i = 0; i < 4; i++) ASSUME_ITS_EQUAL_F64(ewma[i], output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_ewvar(input, output, 4, 0.5, "f64"));
+    for (int i = 0; i < 4; i++) ASSUME_ITS_EQUAL_F64(ewvar[i], output[i], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_holt(input, output, 4, 0.5, 0.5, "f64"));
+    for (int i = 0; i < 4; i++) ASSUME_ITS_EQUAL_F64(holt[i], output[i], 1e-12);
+}
+
+FOSSIL_TEST(c_test_series_ew_many_layouts) {
+    // 70 series span three series-major blocks, the last one partial
+    enum { S = 70, T = 300 };
+    static float by_series[S * T], by_time[S * T], out_series[S * T], out_time[S * T], single[T];
+    for (int s = 0; s < S; s++)
+        for (int t = 0; t < T; t++) {
+            float x = (float)((s * 31 + t * 17) % 89) + (float)s;
+            by_series[s * T + t] = x;
+            by_time[t * S + s] = x;
+        }
+
+    const char *methods[3] = {"ewma", "ewvar", "holt"};
+    for (int m = 0; m < 3; m++) {
+        ASSUME_ITS_EQUAL_I32(0, fossil_data_series_ew_many(by_series, out_series, S, T, methods[m],
+                                                           0.2, 0.3, "series", "f32"));
+        ASSUME_ITS_EQUAL_I32(0, fossil_data_series_ew_many(by_time, out_time, S, T, methods[m],
+                                                           0.2, 0.3, "time", "f32"));
+        int same = 1;
+        for (int s = 0; s < S; s++) {
+            if (m == 0) fossil_data_series_ewma(by_series + s * T, single, T, 0.2, "f32");
+            else if (m == 1) fossil_data_series_ewvar(by_series + s * T, single, T, 0.2, "f32");
+            else fossil_data_series_holt(by_series + s * T, single, T, 0.2, 0.3, "f32");
+            for (int t = 0; t < T; t++)
+                same &= out_series[s * T + t] == single[t] && out_time[t * S + s] == single[t];
+        }
+        ASSUME_ITS_TRUE(same);
+    }
+}
+
+FOSSIL_TEST(c_test_series_ew_invalid_args) {
+    double input[2] = {1.0, 2.0};
+    double output[2] = {0.0};
+    ASSUME_ITS_TRUE(fossil_data_series_ewma(NULL, output, 2, 0.5, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_ewma(input, output, 2, 0.0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_ewvar(input, output, 2, 1.5, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_holt(input, output, 2, 0.5, -0.1, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_ew_many(input, output, 1, 2, "kalman", 0.5, 0.0, "time", "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_ew_many(input, output, 1, 2, "ewma", 0.5, 0.0, "rows", "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_ew_many(input, output, 0, 2, "ewma", 0.5, 0.0, "time", "f64") != 0);
+}
+
+FOSSIL_TEST(c_test_series_cumsum_batch_stride) {
+    // three rows of four values, padded to a stride of five
+    int32_t input[15] = {1, 2, 3, 4, -1,
+                         5, 5, 5, 5, -1,
+                         0, -1, 1, -1, -1};
+    int32_t output[15];
+    for (int i = 0; i < 15; i++) output[i] = 99;
+    int rc = fossil_data_series_cumsum_batch(input, output, 3, 4, 5, "i32");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    ASSUME_ITS_EQUAL_I32(10, output[3]);
+    ASSUME_ITS_EQUAL_I32(20, output[8]);
+    ASSUME_ITS_EQUAL_I32(-1, output[13]);
+    ASSUME_ITS_EQUAL_I32(99, output[4]);  // padding is untouched
+    ASSUME_ITS_EQUAL_I32(99, output[14]);
+}
+
+FOSSIL_TEST(c_test_series_rolling_batch_matches_single) {
+    enum { S = 40, T = 150, STRIDE = 160 };
+    static double input[S * STRIDE], batch[S * STRIDE], single[T];
+    for (int i = 0; i < S * STRIDE; i++) input[i] = (double)((i * 29) % 113) * 0.25;
+
+    const char *stats[4] = {"mean", "var", "min", "median"};
+    for (int k = 0; k < 4; k++) {
+        int rc = fossil_data_series_rolling_batch(input, batch, S, T, STRIDE, stats[k], 12, 1, "f64");
+        ASSUME_ITS_EQUAL_I32(0, rc);
+        int same = 1;
+        for (int s = 0; s < S; s++) {
+            const double *row = input + s * STRIDE;
+            if (k == 0) fossil_data_series_rolling_mean(row, single, T, 12, "f64");
+            else if (k == 1) fossil_data_series_rolling_var(row, single, T, 12, 1, "f64");
+            else if (k == 2) fossil_data_series_rolling_min(row, single, T, 12, "f64");
+            else fossil_data_series_rolling_median(row, single, T, 12, "f64");
+            for (int t = 0; t < T; t++) same &= batch[s * STRIDE + t] == single[t];
+        }
+        ASSUME_ITS_TRUE(same);
+    }
+}
+
+FOSSIL_TEST(c_test_series_batch_invalid_args) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double output[4] = {0.0};
+    ASSUME_ITS_TRUE(fossil_data_series_cumsum_batch(NULL, output, 2, 2, 2, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_cumsum_batch(input, output, 2, 2, 1, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_cumsum_batch(input, output, 0, 2, 2, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_batch(input, output, 2, 2, 2, "mode", 2, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_batch(input, output, 2, 2, 2, "mean", 0, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rolling_batch(input, output, 2, 2, 2, "mean", 2, 0, "badtype") != 0);
+}
+
+FOSSIL_TEST(c_test_series_resample_downsample) {
+    // Irregular samples resampled to 10 ns buckets from origin 0; bucket 2 is empty.
+    int64_t time[7] = {-3, 1, 4, 9, 12, 35, 38};
+    double values[7] = {100.0, 2.0, 6.0, 1.0, 5.0, 3.0, 7.0};
+    fossil_data_series_timed_t series = {time, values, 7, "f64"};
+    int64_t origin = 0;
+    size_t n_buckets = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample_span(&series, 10, &origin, &n_buckets));
+    ASSUME_ITS_TRUE(origin == -10 && n_buckets == 5);
+
+    double output[4];
+    int64_t bucket_time[4];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 10, 4, "sum", "none", bucket_time, output));
+    ASSUME_ITS_EQUAL_F64(9.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_F64(5.0, output[1], 0.0);
+    ASSUME_ITS_TRUE(output[2] != output[2]);
+    ASSUME_ITS_EQUAL_F64(10.0, output[3], 0.0);
+    ASSUME_ITS_TRUE(bucket_time[0] == 0 && bucket_time[3] == 30);
+
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 10, 4, "mean", "ffill", NULL, output));
+    ASSUME_ITS_EQUAL_F64(3.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_F64(5.0, output[2], 0.0);
+    ASSUME_ITS_EQUAL_F64(5.0, output[3], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 10, 4, "min", NULL, NULL, output));
+    ASSUME_ITS_EQUAL_F64(1.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 10, 4, "max", NULL, NULL, output));
+    ASSUME_ITS_EQUAL_F64(6.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_F64(7.0, output[3], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 10, 4, "last", NULL, NULL, output));
+    ASSUME_ITS_EQUAL_F64(1.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_F64(7.0, output[3], 0.0);
+}
+
+FOSSIL_TEST(c_test_series_resample_upsample_ffill) {
+    // Sparse i32 samples forward-filled onto 1 ns buckets; the sample
+    // before origin seeds the leading empty buckets.
+    int64_t time[4] = {-5, 2, 2, 6};
+    int32_t values[4] = {7, 3, 4, 9};
+    fossil_data_series_timed_t series = {time, values, 4, "i32"};
+    int32_t output[8];
+    int32_t expected[8] = {7, 7, 4, 4, 4, 4, 9, 9};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 1, 8, "last", "ffill", NULL, output));
+    for (int i = 0; i < 8; i++) ASSUME_ITS_EQUAL_I32(expected[i], output[i]);
+    // Without fill, empty integer buckets store 0.
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 1, 8, "last", "none", NULL, output));
+    ASSUME_ITS_EQUAL_I32(0, output[0]);
+    ASSUME_ITS_EQUAL_I32(4, output[2]);
+    ASSUME_ITS_EQUAL_I32(0, output[7]);
+}
+
+FOSSIL_TEST(c_test_series_resample_many_buckets) {
+    // One sample every 3 ns over 2000 buckets of 2 ns spans several store tiles.
+    enum { N = 1400, B = 2000 };
+    static int64_t time[N];
+    static double values[N];
+    static double output[B];
+    for (int i = 0; i < N; i++) {
+        time[i] = 3 * i;
+        values[i] = (double)i;
+    }
+    fossil_data_series_timed_t series = {time, values, N, "f64"};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_resample(&series, 0, 2, B, "sum", "ffill", NULL, output));
+    int ok = 1;
+    for (int k = 0; k < B; k++) {
+        // Bucket k holds sample i when 3i is in [2k, 2k + 2); otherwise it repeats.
+        int i = (2 * k + 2) / 3;
+        if (3 * i < 2 * k + 2 && i < N) ok &= output[k] == (double)i;
+        else ok &= output[k] == output[k - 1];
+    }
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_resample_invalid_args) {
+    int64_t time[3] = {1, 3, 2};
+    double values[3] = {1.0, 2.0, 3.0};
+    double output[4];
+    fossil_data_series_timed_t unsorted = {time, values, 3, "f64"};
+    fossil_data_series_timed_t series = {time, values, 2, "f64"};
+    fossil_data_series_timed_t badtype = {time, values, 2, "badtype"};
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&unsorted, 0, 1, 4, "sum", NULL, NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&series, 0, 0, 4, "sum", NULL, NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&series, 0, 1, 0, "sum", NULL, NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&series, 0, 1, 4, "median", NULL, NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&series, 0, 1, 4, "sum", "bfill", NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&badtype, 0, 1, 4, "sum", NULL, NULL, output) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_resample(&series, 0, 1, 4, "sum", NULL, NULL, NULL) != 0);
+}
+
+FOSSIL_TEST(c_test_series_asof_tolerance) {
+    // Quotes at irregular times; trades look up the last quote at or before them.
+    int64_t quote_time[5] = {10, 20, 20, 35, 60};
+    double quote[5] = {1.0, 2.0, 2.5, 3.0, 4.0};
+    fossil_data_series_timed_t quotes = {quote_time, quote, 5, "f64"};
+    int64_t trade_time[6] = {5, 10, 22, 35, 50, 90};
+    double output[6];
+    size_t index[6];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_asof(trade_time, 6, &quotes, -1, output, index));
+    ASSUME_ITS_TRUE(output[0] != output[0] && index[0] == SIZE_MAX);
+    ASSUME_ITS_EQUAL_F64(1.0, output[1], 0.0);
+    ASSUME_ITS_EQUAL_F64(2.5, output[2], 0.0);
+    ASSUME_ITS_EQUAL_F64(3.0, output[3], 0.0);
+    ASSUME_ITS_EQUAL_F64(3.0, output[4], 0.0);
+    ASSUME_ITS_EQUAL_F64(4.0, output[5], 0.0);
+    ASSUME_ITS_TRUE(index[2] == 2 && index[5] == 4);
+
+    // Within 5 ns only: 50 is 15 past its quote and 90 is 30 past.
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_asof(trade_time, 6, &quotes, 5, output, NULL));
+    ASSUME_ITS_EQUAL_F64(2.5, output[2], 0.0);
+    ASSUME_ITS_TRUE(output[4] != output[4]);
+    ASSUME_ITS_TRUE(output[5] != output[5]);
+}
+
+FOSSIL_TEST(c_test_series_asof_matches_search) {
+    // Long dense sides span several parallel chunks; compare against a plain scan.
+    enum { NL = 70000, NR = 50000 };
+    static int64_t left[NL];
+    static int64_t right[NR];
+    static int32_t values[NR];
+    static int32_t output[NL];
+    for (int i = 0; i < NL; i++) left[i] = (int64_t)i * 5 + (i % 3);
+    for (int j = 0; j < NR; j++) {
+        right[j] = (int64_t)j * 7 - 100;
+        values[j] = j;
+    }
+    fossil_data_series_timed_t series = {right, values, NR, "i32"};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_asof(left, NL, &series, -1, output, NULL));
+    int ok = 1;
+    int j = 0;
+    for (int i = 0; i < NL; i++) {
+        while (j < NR && right[j] <= left[i]) j++;
+        ok &= output[i] == (j > 0 ? values[j - 1] : 0);
+    }
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_merge_three_way) {
+    int64_t ta[4] = {1, 3, 3, 8};
+    double va[4] = {10.0, 30.0, 31.0, 80.0};
+    int64_t tb[3] = {2, 3, 9};
+    int32_t vb[3] = {200, 300, 900};
+    int64_t tc[1] = {5};
+    double vc[1] = {0.5};
+    fossil_data_series_timed_t series[3] = {
+        {ta, va, 4, "f64"}, {tb, vb, 3, "i32"}, {tc, vc, 1, "f64"}
+    };
+    size_t count = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_merge(series, 3, 0, NULL, NULL, 0, &count));
+    ASSUME_ITS_TRUE(count == 6);
+
+    int64_t time[6];
+    double a[6], c[6];
+    int32_t b[6];
+    void *outputs[3] = {a, b, c};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_merge(series, 3, 0, time, outputs, 6, &count));
+    int64_t expected_time[6] = {1, 2, 3, 5, 8, 9};
+    for (int i = 0; i < 6; i++) ASSUME_ITS_TRUE(time[i] == expected_time[i]);
+    // Exact matches only: the last of the duplicate 3s, gaps elsewhere.
+    ASSUME_ITS_EQUAL_F64(31.0, a[2], 0.0);
+    ASSUME_ITS_TRUE(a[1] != a[1]);
+    ASSUME_ITS_EQUAL_I32(0, b[0]);
+    ASSUME_ITS_EQUAL_I32(300, b[2]);
+    ASSUME_ITS_EQUAL_F64(0.5, c[3], 0.0);
+
+    // Forward fill carries every column to later rows.
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_merge(series, 3, -1, time, outputs, 6, &count));
+    ASSUME_ITS_EQUAL_F64(31.0, a[3], 0.0);
+    ASSUME_ITS_EQUAL_F64(80.0, a[5], 0.0);
+    ASSUME_ITS_EQUAL_I32(300, b[4]);
+    ASSUME_ITS_EQUAL_F64(0.5, c[5], 0.0);
+    ASSUME_ITS_TRUE(c[2] != c[2]);
+}
+
+FOSSIL_TEST(c_test_series_merge_long_ranges) {
+    // 150000 samples split the merge into three time ranges.
+    enum { NA = 150000, NB = 60000 };
+    static int64_t ta[NA];
+    static int64_t tb[NB];
+    static int64_t time[NA + NB];
+    static double va[NA];
+    static double vb[NB];
+    for (int i = 0; i < NA; i++) {
+        ta[i] = (int64_t)i * 2;
+        va[i] = (double)i;
+    }
+    for (int j = 0; j < NB; j++) {
+        tb[j] = (int64_t)j * 5;
+        vb[j] = (double)j;
+    }
+    fossil_data_series_timed_t series[2] = {{ta, va, NA, "f64"}, {tb, vb, NB, "f64"}};
+    size_t count = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_merge(series, 2, -1, time, NULL, NA + NB, &count));
+    // Even times below 300000, plus the odd multiples of 5 below it.
+    ASSUME_ITS_TRUE(count == NA + NB / 2);
+    int ok = 1;
+    for (size_t i = 1; i < count; i++) ok &= time[i] > time[i - 1];
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_time_align_invalid_args) {
+    int64_t sorted[3] = {1, 2, 3};
+    int64_t unsorted[3] = {1, 3, 2};
+    double values[3] = {1.0, 2.0, 3.0};
+    double output[3];
+    int64_t time[6];
+    size_t count = 0;
+    fossil_data_series_timed_t good = {sorted, values, 3, "f64"};
+    fossil_data_series_timed_t bad = {unsorted, values, 3, "f64"};
+    fossil_data_series_timed_t badtype = {sorted, values, 3, "badtype"};
+    ASSUME_ITS_TRUE(fossil_data_series_asof(unsorted, 3, &good, -1, output, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_asof(sorted, 3, &bad, -1, output, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_asof(sorted, 3, &badtype, -1, output, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_asof(sorted, 3, &good, -1, NULL, NULL) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_merge(&bad, 1, -1, time, NULL, 6, &count) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_merge(&good, 0, -1, time, NULL, 6, &count) != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_merge(&good, 1, -1, time, NULL, 2, &count) != 0);
+    ASSUME_ITS_TRUE(count == 3);
+}
+
+FOSSIL_TEST(c_test_series_rfft_known_values) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double spectrum[6];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rfft(input, 4, spectrum, "f64"));
+    ASSUME_ITS_EQUAL_F64(10.0, spectrum[0], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.0, spectrum[1], 1e-12);
+    ASSUME_ITS_EQUAL_F64(-2.0, spectrum[2], 1e-12);
+    ASSUME_ITS_EQUAL_F64(2.0, spectrum[3], 1e-12);
+    ASSUME_ITS_EQUAL_F64(-2.0, spectrum[4], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.0, spectrum[5], 1e-12);
+
+    // Odd length, radix 5: a constant has energy only in bin 0.
+    int32_t ones[5] = {1, 1, 1, 1, 1};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rfft(ones, 5, spectrum, "i32"));
+    ASSUME_ITS_EQUAL_F64(5.0, spectrum[0], 1e-12);
+    for (int k = 1; k < 6; k++) ASSUME_ITS_EQUAL_F64(0.0, spectrum[k], 1e-12);
+}
+
+FOSSIL_TEST(c_test_series_rfft_roundtrip_lengths) {
+    // Mixed radix, generic radix 7 and 11, and 2 * 17 and 37 through the chirp path.
+    enum { MAX = 400 };
+    static double input[MAX];
+    static double spectrum[MAX + 2];
+    static double output[MAX];
+    size_t lengths[6] = {48, 77, 121, 34, 37, 400};
+    for (int l = 0; l < 6; l++) {
+        size_t n = lengths[l];
+        for (size_t i = 0; i < n; i++) input[i] = (double)((i * 37 + 11) % 23) - 11.0;
+        ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rfft(input, n, spectrum, "f64"));
+        // Bin 0 is the plain sum.
+        double sum = 0.0;
+        for (size_t i = 0; i < n; i++) sum += input[i];
+        ASSUME_ITS_EQUAL_F64(sum, spectrum[0], 1e-9);
+        ASSUME_ITS_EQUAL_I32(0, fossil_data_series_irfft(spectrum, n, output, "f64"));
+        int ok = 1;
+        for (size_t i = 0; i < n; i++) {
+            double d = output[i] - input[i];
+            ok &= d < 1e-9 && d > -1e-9;
+        }
+        ASSUME_ITS_TRUE(ok);
+    }
+}
+
+FOSSIL_TEST(c_test_series_convolve_correlate) {
+    double a[3] = {1.0, 2.0, 3.0};
+    double b[3] = {0.0, 1.0, 0.5};
+    double output[5];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_convolve(a, 3, b, 3, output, "f64"));
+    double conv[5] = {0.0, 1.0, 2.5, 4.0, 1.5};
+    for (int k = 0; k < 5; k++) ASSUME_ITS_EQUAL_F64(conv[k], output[k], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_correlate(a, 3, b, 3, output, "f64"));
+    double corr[5] = {0.5, 2.0, 3.5, 3.0, 0.0};
+    for (int k = 0; k < 5; k++) ASSUME_ITS_EQUAL_F64(corr[k], output[k], 1e-12);
+}
+
+FOSSIL_TEST(c_test_series_convolve_long_i32_exact) {
+    // Both sides long enough for the transform path; integers come back exact.
+    enum { NA = 300, NB = 90 };
+    static int32_t a[NA];
+    static int32_t b[NB];
+    static int32_t output[NA + NB - 1];
+    static int64_t expected[NA + NB - 1];
+    for (int i = 0; i < NA; i++) a[i] = (i * 7919) % 2001 - 1000;
+    for (int j = 0; j < NB; j++) b[j] = (j * 104729) % 201 - 100;
+    for (int i = 0; i < NA; i++)
+        for (int j = 0; j < NB; j++) expected[i + j] += (int64_t)a[i] * b[j];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_convolve(a, NA, b, NB, output, "i32"));
+    int ok = 1;
+    for (int k = 0; k < NA + NB - 1; k++) ok &= output[k] == expected[k];
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_autocorr) {
+    double ramp[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+    double output[41];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_autocorr(ramp, 5, 2, output, "f64"));
+    ASSUME_ITS_EQUAL_F64(1.0, output[0], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.4, output[1], 1e-12);
+    ASSUME_ITS_EQUAL_F64(-0.1, output[2], 1e-12);
+
+    // Period-8 signal with 40 lags takes the transform path; compare to direct sums.
+    enum { N = 800 };
+    static double x[N];
+    for (int i = 0; i < N; i++) x[i] = (double)(i % 8) + (double)((i * 31) % 5) * 0.1;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_autocorr(x, N, 40, output, "f64"));
+    double mean = 0.0;
+    for (int i = 0; i < N; i++) mean += x[i];
+    mean /= N;
+    double c0 = 0.0;
+    for (int i = 0; i < N; i++) c0 += (x[i] - mean) * (x[i] - mean);
+    int ok = 1;
+    for (int k = 0; k <= 40; k++) {
+        double c = 0.0;
+        for (int i = 0; i + k < N; i++) c += (x[i] - mean) * (x[i + k] - mean);
+        double d = c / c0 - output[k];
+        ok &= d < 1e-12 && d > -1e-12;
+    }
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(output[8] > 0.9);
+
+    double flat[4] = {2.0, 2.0, 2.0, 2.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_autocorr(flat, 4, 1, output, "f64"));
+    ASSUME_ITS_TRUE(output[0] != output[0]);
+}
+
+FOSSIL_TEST(c_test_series_spectral_invalid_args) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double output[8];
+    ASSUME_ITS_TRUE(fossil_data_series_rfft(NULL, 4, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_rfft(input, 0, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_irfft(output, 4, input, "badtype") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_convolve(input, 4, input, 0, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_correlate(input, 4, NULL, 4, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_autocorr(input, 4, 4, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_autocorr(input, 4, 1, output, "badtype") != 0);
+}
+
+FOSSIL_TEST(c_test_series_diff_orders) {
+    double input[6] = {1.0, 4.0, 9.0, 16.0, 25.0, 36.0};
+    double output[6];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_diff(input, output, 6, 1, "f64"));
+    ASSUME_ITS_TRUE(output[0] != output[0]);
+    ASSUME_ITS_EQUAL_F64(3.0, output[1], 0.0);
+    ASSUME_ITS_EQUAL_F64(11.0, output[5], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_diff(input, output, 6, 2, "f64"));
+    ASSUME_ITS_TRUE(output[1] != output[1]);
+    for (int i = 2; i < 6; i++) ASSUME_ITS_EQUAL_F64(2.0, output[i], 0.0);
+
+    // Integers are exact in place; the first order values store 0.
+    int32_t cubes[6] = {0, 1, 8, 27, 64, 125};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_diff(cubes, cubes, 6, 3, "i32"));
+    ASSUME_ITS_EQUAL_I32(0, cubes[2]);
+    for (int i = 3; i < 6; i++) ASSUME_ITS_EQUAL_I32(6, cubes[i]);
+}
+
+FOSSIL_TEST(c_test_series_diff_across_tiles) {
+    // Second differences of a quadratic over several conversion tiles.
+    enum { N = 1500 };
+    static int64_t input[N];
+    static int64_t output[N];
+    for (int i = 0; i < N; i++) input[i] = (int64_t)i * i * 3 - 7 * i;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_diff(input, output, N, 2, "i64"));
+    int ok = output[0] == 0 && output[1] == 0;
+    for (int i = 2; i < N; i++) ok &= output[i] == 6;
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_pct_change_and_shift) {
+    double prices[5] = {100.0, 110.0, 121.0, 0.0, 50.0};
+    double change[5];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_pct_change(prices, change, 5, 1, "f64"));
+    ASSUME_ITS_TRUE(change[0] != change[0]);
+    ASSUME_ITS_EQUAL_F64(0.1, change[1], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.1, change[2], 1e-12);
+    ASSUME_ITS_EQUAL_F64(-1.0, change[3], 1e-12);
+    ASSUME_ITS_TRUE(change[4] > 1e300);
+    int32_t counts[3] = {4, 2, 6};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_pct_change(counts, change, 3, 2, "i32"));
+    ASSUME_ITS_EQUAL_F64(0.5, change[2], 1e-12);
+
+    int16_t values[5] = {1, 2, 3, 4, 5};
+    int16_t shifted[5];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_shift(values, shifted, 5, 2, "i16"));
+    int16_t lagged[5] = {0, 0, 1, 2, 3};
+    for (int i = 0; i < 5; i++) ASSUME_ITS_EQUAL_I32(lagged[i], shifted[i]);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_shift(values, values, 5, -1, "i16"));
+    int16_t led[5] = {2, 3, 4, 5, 0};
+    for (int i = 0; i < 5; i++) ASSUME_ITS_EQUAL_I32(led[i], values[i]);
+    double x[2] = {1.0, 2.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_shift(x, x, 2, 9, "f64"));
+    ASSUME_ITS_TRUE(x[0] != x[0] && x[1] != x[1]);
+}
+
+FOSSIL_TEST(c_test_series_lag_matrix) {
+    double input[5] = {10.0, 20.0, 30.0, 40.0, 50.0};
+    double block[15];
+    size_t lags[3] = {0, 2, 1};
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_lag_matrix(input, 5, lags, 3, block, "f64"));
+    ASSUME_ITS_EQUAL_F64(10.0, block[0], 0.0);
+    ASSUME_ITS_TRUE(block[1] != block[1] && block[2] != block[2]);
+    ASSUME_ITS_EQUAL_F64(10.0, block[3 * 2 + 1], 0.0);
+    ASSUME_ITS_EQUAL_F64(50.0, block[3 * 4 + 0], 0.0);
+    ASSUME_ITS_EQUAL_F64(30.0, block[3 * 4 + 1], 0.0);
+    ASSUME_ITS_EQUAL_F64(40.0, block[3 * 4 + 2], 0.0);
+
+    // Default lags 1..K on a long series span several parallel chunks.
+    enum { N = 40000, K = 6 };
+    static uint32_t values[N];
+    static uint32_t lagged[N * K];
+    for (int i = 0; i < N; i++) values[i] = (uint32_t)i * 3u;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_lag_matrix(values, N, NULL, K, lagged, "u32"));
+    int ok = 1;
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < K; j++)
+            ok &= lagged[i * K + j] == (i > j ? values[i - j - 1] : 0u);
+    ASSUME_ITS_TRUE(ok);
+}
+
+FOSSIL_TEST(c_test_series_lags_invalid_args) {
+    double input[3] = {1.0, 2.0, 3.0};
+    double output[9];
+    ASSUME_ITS_TRUE(fossil_data_series_diff(NULL, output, 3, 1, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_diff(input, output, 3, 1, "badtype") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_pct_change(input, output, 3, 0, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_shift(input, output, 0, 1, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_lag_matrix(input, 3, NULL, 0, output, "f64") != 0);
+    ASSUME_ITS_TRUE(fossil_data_series_lag_matrix(input, 3, NULL, 3, NULL, "f64") != 0);
+}
+
+FOSSIL_TEST(c_test_series_rolling_multi_duplicate_features) {
+    enum { N = 1500, F = 4 };
+    static double input[N], fused[F][N], mean[N], std[N];
+    const char *stats[F] = {"mean", "std", "mean", "std"};
+    size_t windows[F] = {3, 3, 3, 3};
+    void *outputs[F];
+    for (int i = 0; i < N; i++) input[i] = (double)((i * 13) % 29) - 7.0;
+    for (int k = 0; k < F; k++) outputs[k] = fused[k];
+
+    int rc = fossil_data_series_rolling_multi(input, outputs, N, stats, windows, F, 1, "f64");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    fossil_data_series_rolling_mean(input, mean, N, 3, "f64");
+    fossil_data_series_rolling_std(input, std, N, 3, 1, "f64");
+
+    // a repeated feature gets the same output as its first occurrence
+    int same = 1;
+    for (int i = 0; i < N; i++) {
+        same &= fused[0][i] == mean[i] && fused[2][i] == mean[i];
+        same &= fused[1][i] == std[i] && fused[3][i] == std[i];
+    }
+    ASSUME_ITS_TRUE(same);
+}
+
+FOSSIL_TEST(c_test_series_stream_load_rejects_corrupt_heaps) {
+    enum { WORDS = 64, N_LO = 12, N_HI = 13, REFRESH = 9, RING = 25 };
+    double input[3] = {3.0, 1.0, 2.0};
+    double output[3];
+    void *stream = NULL;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("median", 3, 0, "f64", &stream));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, input, output, 3));
+
+    // header words: n_lo, n_hi and refresh sit at fixed 8-byte offsets
+    uint64_t good[WORDS], state[WORDS];
+    size_t size = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_save(stream, good, sizeof(good), &size));
+    fossil_data_series_stream_free(stream);
+
+    void *restored = NULL;
+    for (int i = 0; i < WORDS; i++) state[i] = good[i];
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_load(state, size, &restored));
+    fossil_data_series_stream_free(restored);
+
+    // all three values moved to hi: the counts still add up to n, but the
+    // slots where[] places in lo no longer exist
+    state[N_LO] = 0;
+    state[N_HI] = 3;
+    restored = NULL;
+    ASSUME_ITS_EQUAL_I32(-1, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_TRUE(restored == NULL);
+
+    for (int i = 0; i < WORDS; i++) state[i] = good[i];
+    state[REFRESH] = 0;
+    ASSUME_ITS_EQUAL_I32(-1, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_TRUE(restored == NULL);
+
+    // n_lo + n_hi wraps round to n in 64 bits
+    for (int i = 0; i < WORDS; i++) state[i] = good[i];
+    state[N_LO] = UINT64_MAX;
+    state[N_HI] = 4;
+    ASSUME_ITS_EQUAL_I32(-5, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_TRUE(restored == NULL);
+
+    // slot 0 holds 3.0, the top of hi; below lo's top the heaps are out of order
+    union { double d; uint64_t u; } low = { -1.0 };
+    for (int i = 0; i < WORDS; i++) state[i] = good[i];
+    state[RING] = low.u;
+    ASSUME_ITS_EQUAL_I32(-1, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_TRUE(restored == NULL);
+}
+
+FOSSIL_TEST(c_test_series_convolve_i64_exact_below_bound) {
+    enum { N = 200 };
+    static int64_t a[N], b[N], out[2 * N - 1];
+    for (int i = 0; i < N; i++) {
+        a[i] = (int64_t)((i * 7919) % 262144);
+        b[i] = (int64_t)((i * 104729) % 262144) - 131072;
+    }
+    // norms multiply to about 2^43.6, inside the documented 2^47 bound
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_convolve(a, N, b, N, out, "i64"));
+    int same = 1;
+    for (int k = 0; k < 2 * N - 1; k++) {
+        int64_t sum = 0;
+        for (int i = 0; i < N; i++)
+            if (k - i >= 0 && k - i < N) sum += a[i] * b[k - i];
+        same &= out[k] == sum;
+    }
+    ASSUME_ITS_TRUE(same);
+}
+
+FOSSIL_TEST(c_test_series_fft_cache_clear) {
+    enum { N = 96 };
+    double input[N], first[N + 2], again[N + 2];
+    for (int i = 0; i < N; i++) input[i] = (double)((i * 5) % 11) - 5.0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rfft(input, N, first, "f64"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_fft_cache_clear());
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_fft_cache_clear());
+
+    // the plan is rebuilt on demand and gives the same spectrum
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rfft(input, N, again, "f64"));
+    int same = 1;
+    for (int i = 0; i < N + 2; i++) same &= first[i] == again[i];
+    ASSUME_ITS_TRUE(same);
+}
+
+FOSSIL_TEST(c_test_series_rolling_nonfinite) {
+    enum { N = 40, W = 3 };
+    static double input[N], mean[N], sd[N], mn[N], med[N], streamed[N];
+    volatile double zero = 0.0;
+    for (int i = 0; i < N; i++) input[i] = (double)((i * 7) % 13) - 6.0;
+    input[5] = zero / zero;
+    input[20] = 1.0 / zero;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_mean(input, mean, N, W, "f64"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_std(input, sd, N, W, 1, "f64"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_min(input, mn, N, W, "f64"));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_rolling_median(input, med, N, W, "f64"));
+
+    // each window is checked against a direct computation over its values
+    int ok = 1;
+    for (int i = 0; i < N; i++) {
+        int lo = i + 1 < W ? 0 : i + 1 - W, m = i - lo + 1, nan = 0, inf = 0;
+        double v[W], sum = 0.0, least = input[lo];
+        for (int j = 0; j < m; j++) {
+            double x = input[lo + j];
+            nan |= x != x;
+            inf |= x == 1.0 / zero;
+            sum += x;
+            if (x < least) least = x;
+            int k = j;
+            for (; k > 0 && v[k - 1] > x; k--) v[k] = v[k - 1];
+            v[k] = x;
+        }
+        double avg = sum / m, ss = 0.0;
+        for (int j = 0; j < m; j++) ss += (v[j] - avg) * (v[j] - avg);
+        double middle = m % 2 ? v[m / 2] : 0.5 * (v[m / 2 - 1] + v[m / 2]);
+        if (nan) {
+            ok &= mean[i] != mean[i] && sd[i] != sd[i] && mn[i] != mn[i] && med[i] != med[i];
+        } else if (inf) {
+            ok &= mean[i] == 1.0 / zero && sd[i] != sd[i];
+            ok &= mn[i] == least && med[i] == middle;
+        } else {
+            double var = m > 1 ? ss / (m - 1) : 0.0;
+            ok &= mean[i] - avg < 1e-12 && avg - mean[i] < 1e-12;
+            ok &= sd[i] * sd[i] - var < 1e-9 && var - sd[i] * sd[i] < 1e-9;
+            ok &= mn[i] == least && med[i] == middle;
+        }
+    }
+    ASSUME_ITS_TRUE(ok);
+
+    // a saved median stream recounts the NaN in its window on load
+    void *stream = NULL, *restored = NULL;
+    unsigned char state[512];
+    size_t size = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_create("median", W, 0, "f64", &stream));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(stream, input, streamed, 6));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_save(stream, state, sizeof(state), &size));
+    fossil_data_series_stream_free(stream);
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_load(state, size, &restored));
+    ASSUME_ITS_EQUAL_I32(0, fossil_data_series_stream_push(restored, input + 6, streamed + 6,
+                                                           N - 6));
+    fossil_data_series_stream_free(restored);
+    int same = 1;
+    for (int i = 0; i < N; i++)
+        same &= streamed[i] == med[i] || (streamed[i] != streamed[i] && med[i] != med[i]);
+    ASSUME_ITS_TRUE(same);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -142,6 +1102,50 @@ FOSSIL_TEST_GROUP(c_series_tests) {
     FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_mean_f32);
     FOSSIL_TEST_ADD(c_series_suite, c_test_series_cumsum_invalid_args);
     FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_mean_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_cumsum_blocks);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_cumsum_narrow_types);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_family);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_long_window);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_median_i32_inplace);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_family_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_multi_matches_single);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_multi_inplace_i32);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_multi_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_stream_matches_batch);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_stream_save_load);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_stream_cumsum_i32);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_stream_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_ewma_ewvar_holt);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_ew_many_layouts);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_ew_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_cumsum_batch_stride);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_batch_matches_single);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_batch_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_resample_downsample);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_resample_upsample_ffill);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_resample_many_buckets);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_resample_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_asof_tolerance);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_asof_matches_search);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_merge_three_way);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_merge_long_ranges);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_time_align_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rfft_known_values);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rfft_roundtrip_lengths);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_convolve_correlate);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_convolve_long_i32_exact);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_autocorr);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_spectral_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_diff_orders);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_diff_across_tiles);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_pct_change_and_shift);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_lag_matrix);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_lags_invalid_args);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_multi_duplicate_features);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_stream_load_rejects_corrupt_heaps);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_convolve_i64_exact_below_bound);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_fft_cache_clear);
+    FOSSIL_TEST_ADD(c_series_suite, c_test_series_rolling_nonfinite);
 
     // Register the test suite
     FOSSIL_TEST_REGISTER(c_series_suite);
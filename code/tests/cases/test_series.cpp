@@ -131,6 +131,179 @@ FOSSIL_TEST(cpp_test_series_rolling_mean_invalid_args) {
     ASSUME_ITS_TRUE(rc != 0);
 }
 
+FOSSIL_TEST(cpp_test_series_cumsum_i64_blocks) {
+    // Integer sums across scan blocks are exact
+    enum { N = 150001 };
+    static int64_t input[N];
+    static int64_t output[N];
+    for (size_t i = 0; i < N; i++)
+        input[i] = 3;
+    int rc = fossil::data::Series::cumsum(input, output, N, "i64");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    ASSUME_ITS_TRUE(output[0] == 3);
+    ASSUME_ITS_TRUE(output[65535] == 3 * 65536);
+    ASSUME_ITS_TRUE(output[150000] == 3 * 150001);
+}
+
+FOSSIL_TEST(cpp_test_series_rolling_family) {
+    double input[6] = {4.0, 1.0, 3.0, 5.0, 2.0, 6.0};
+    double output[6] = {0.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_sum(input, output, 6, 3, "f64"));
+    ASSUME_ITS_EQUAL_F64(13.0, output[5], 1e-12); // 5+2+6
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_var(input, output, 6, 3, 1, "f64"));
+    ASSUME_ITS_EQUAL_F64(4.0, output[3], 1e-12); // var{1,3,5}
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_std(input, output, 6, 3, 1, "f64"));
+    ASSUME_ITS_EQUAL_F64(2.0, output[3], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_min(input, output, 6, 3, "f64"));
+    ASSUME_ITS_EQUAL_F64(2.0, output[5], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_max(input, output, 6, 3, "f64"));
+    ASSUME_ITS_EQUAL_F64(5.0, output[4], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_median(input, output, 6, 3, "f64"));
+    ASSUME_ITS_EQUAL_F64(2.5, output[1], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_quantile(input, output, 6, 3, 0.25, "f64"));
+    ASSUME_ITS_EQUAL_F64(3.5, output[5], 1e-12);
+}
+
+FOSSIL_TEST(cpp_test_series_rolling_multi) {
+    double input[6] = {4.0, 1.0, 3.0, 5.0, 2.0, 6.0};
+    double mean[6] = {0.0}, std[6] = {0.0}, min[6] = {0.0};
+    void *outputs[3] = {mean, std, min};
+    const char *stats[3] = {"mean", "std", "min"};
+    size_t windows[3] = {3, 3, 2};
+    int rc = fossil::data::Series::rolling_multi(input, outputs, 6, stats, windows, 3, 1, "f64");
+    ASSUME_ITS_EQUAL_I32(0, rc);
+    ASSUME_ITS_EQUAL_F64(3.0, mean[3], 1e-12); // {1,3,5}
+    ASSUME_ITS_EQUAL_F64(2.0, std[3], 1e-12);
+    ASSUME_ITS_EQUAL_F64(2.0, min[5], 0.0);    // {2,6}
+}
+
+FOSSIL_TEST(cpp_test_series_stream) {
+    float ticks[6] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    float value = 0.0f;
+    void* stream = fossil::data::Series::stream_create("mean", 3, 0, "f32");
+    ASSUME_ITS_TRUE(stream != nullptr);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::stream_push(stream, ticks, nullptr, 4));
+
+    size_t size = 0;
+    unsigned char state[256];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::stream_save(stream, state, sizeof(state), &size));
+    fossil::data::Series::stream_free(stream);
+
+    stream = fossil::data::Series::stream_load(state, size);
+    ASSUME_ITS_TRUE(stream != nullptr);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::stream_push(stream, ticks + 4, nullptr, 2));
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::stream_value(stream, &value));
+    ASSUME_ITS_EQUAL_F32(5.0f, value, 1e-6f); // (4+5+6)/3
+    fossil::data::Series::stream_free(stream);
+}
+
+FOSSIL_TEST(cpp_test_series_ew_smoothing) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double output[4] = {0.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::ewma(input, output, 4, 0.5, "f64"));
+    ASSUME_ITS_EQUAL_F64(3.125, output[3], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::holt(input, output, 4, 0.5, 0.5, "f64"));
+    ASSUME_ITS_EQUAL_F64(4.296875, output[3], 1e-12);
+
+    // two series, time-major: {1,2,3,4} and {4,4,4,4}
+    double pairs[8] = {1.0, 4.0, 2.0, 4.0, 3.0, 4.0, 4.0, 4.0};
+    double smoothed[8] = {0.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::ew_many(pairs, smoothed, 2, 4, "ewvar", 0.5, 0.0,
+                                                          "time", "f64"));
+    ASSUME_ITS_EQUAL_F64(1.109375, smoothed[6], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.0, smoothed[7], 0.0);
+}
+
+FOSSIL_TEST(cpp_test_series_batch) {
+    double input[6] = {1.0, 2.0, 3.0,
+                       6.0, 4.0, 2.0};
+    double output[6] = {0.0};
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::cumsum_batch(input, output, 2, 3, 3, "f64"));
+    ASSUME_ITS_EQUAL_F64(6.0, output[2], 1e-12);
+    ASSUME_ITS_EQUAL_F64(12.0, output[5], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rolling_batch(input, output, 2, 3, 3, "max", 2, 0, "f64"));
+    ASSUME_ITS_EQUAL_F64(3.0, output[2], 0.0);
+    ASSUME_ITS_EQUAL_F64(4.0, output[5], 0.0);
+}
+
+FOSSIL_TEST(cpp_test_series_resample) {
+    int64_t time[5] = {0, 4, 11, 30, 31};
+    double values[5] = {1.0, 3.0, 5.0, 2.0, 4.0};
+    fossil_data_series_timed_t series = {time, values, 5, "f64"};
+    int64_t origin = 0;
+    size_t n_buckets = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::resample_span(&series, 10, &origin, &n_buckets));
+    ASSUME_ITS_TRUE(origin == 0 && n_buckets == 4);
+    double output[4];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::resample(&series, origin, 10, n_buckets, "mean", "ffill", nullptr, output));
+    ASSUME_ITS_EQUAL_F64(2.0, output[0], 0.0);
+    ASSUME_ITS_EQUAL_F64(5.0, output[1], 0.0);
+    ASSUME_ITS_EQUAL_F64(5.0, output[2], 0.0);
+    ASSUME_ITS_EQUAL_F64(3.0, output[3], 0.0);
+    ASSUME_ITS_TRUE(fossil::data::Series::resample(&series, origin, 10, n_buckets, "mode", "none", nullptr, output) != 0);
+}
+
+FOSSIL_TEST(cpp_test_series_time_align) {
+    int64_t quote_time[3] = {0, 10, 20};
+    double quote[3] = {1.0, 2.0, 3.0};
+    int64_t trade_time[2] = {15, 40};
+    double trade[2] = {7.0, 8.0};
+    fossil_data_series_timed_t series[2] = {{quote_time, quote, 3, "f64"}, {trade_time, trade, 2, "f64"}};
+    double output[2];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::asof(trade_time, 2, &series[0], 10, output, nullptr));
+    ASSUME_ITS_EQUAL_F64(2.0, output[0], 0.0);
+    ASSUME_ITS_TRUE(output[1] != output[1]);
+
+    int64_t time[5];
+    double a[5], b[5];
+    void* outputs[2] = {a, b};
+    size_t count = 0;
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::merge(series, 2, -1, time, outputs, 5, &count));
+    ASSUME_ITS_TRUE(count == 5 && time[2] == 15);
+    ASSUME_ITS_EQUAL_F64(2.0, a[2], 0.0);
+    ASSUME_ITS_EQUAL_F64(7.0, b[3], 0.0);
+}
+
+FOSSIL_TEST(cpp_test_series_spectral) {
+    double input[4] = {1.0, 2.0, 3.0, 4.0};
+    double spectrum[6];
+    double back[4];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::rfft(input, 4, spectrum, "f64"));
+    ASSUME_ITS_EQUAL_F64(10.0, spectrum[0], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::irfft(spectrum, 4, back, "f64"));
+    ASSUME_ITS_EQUAL_F64(3.0, back[2], 1e-12);
+
+    int32_t a[3] = {1, 2, 3};
+    int32_t b[2] = {1, 1};
+    int32_t output[4];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::convolve(a, 3, b, 2, output, "i32"));
+    ASSUME_ITS_EQUAL_I32(5, output[2]);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::correlate(a, 3, b, 2, output, "i32"));
+    ASSUME_ITS_EQUAL_I32(1, output[0]);
+    ASSUME_ITS_EQUAL_I32(3, output[1]);
+
+    double acf[2];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::autocorr(input, 4, 1, acf, "f64"));
+    ASSUME_ITS_EQUAL_F64(1.0, acf[0], 1e-12);
+    ASSUME_ITS_EQUAL_F64(0.25, acf[1], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::fft_cache_clear());
+}
+
+FOSSIL_TEST(cpp_test_series_lags) {
+    double input[4] = {1.0, 3.0, 6.0, 10.0};
+    double output[8];
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::diff(input, output, 4, 1, "f64"));
+    ASSUME_ITS_EQUAL_F64(4.0, output[3], 0.0);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::pct_change(input, output, 4, 1, "f64"));
+    ASSUME_ITS_EQUAL_F64(2.0, output[1], 1e-12);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::shift(input, output, 4, -2, "f64"));
+    ASSUME_ITS_EQUAL_F64(10.0, output[1], 0.0);
+    ASSUME_ITS_TRUE(output[3] != output[3]);
+    ASSUME_ITS_EQUAL_I32(0, fossil::data::Series::lag_matrix(input, 4, nullptr, 2, output, "f64"));
+    ASSUME_ITS_EQUAL_F64(6.0, output[3 * 2 + 0], 0.0);
+    ASSUME_ITS_EQUAL_F64(3.0, output[3 * 2 + 1], 0.0);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -142,6 +315,16 @@ FOSSIL_TEST_GROUP(cpp_series_tests) {
     FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_rolling_mean_f32);
     FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_cumsum_invalid_args);
     FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_rolling_mean_invalid_args);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_cumsum_i64_blocks);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_rolling_family);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_rolling_multi);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_stream);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_ew_smoothing);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_batch);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_resample);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_time_align);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_spectral);
+    FOSSIL_TEST_ADD(cpp_series_suite, cpp_test_series_lags);
 
     // Register the test suite
     FOSSIL_TEST_REGISTER(cpp_series_suite);